@@ -143,6 +143,31 @@ else
     echo OK
 fi
 
+echo -n Case 10...
+# Test an expression with constant and repeated subexpressions and a dead
+# assignment, which are removed by the optimizer. Should be (1+2)*(2+1) 
+# for each voxel.
+$MINCCALC_BIN -clobber -quiet -expression 'unused = A[0]*7; (A[0]+A[1])*(A[1]+A[0]) - 2*3 + 6/1' test-one.mnc test-two.mnc minccalc-out.mnc
+r1=`$MINCSTATS_BIN -quiet -sum minccalc-out.mnc`
+if [[ $r1 != '1125' ]]; then
+    echo "Problem with optimized expression:" $r1
+    let errors+=1;
+else
+    echo OK
+fi
+
+echo -n Case 11...
+# Repeat the two-output script of case 5 using several threads.
+$MINCCALC_BIN -clobber -quiet -threads 3 -eval_width 7 -expression "s0=s1=s2=0; for {i in [0:len(A))} { v=A[i]; s0 = s0 + 1; s1 = s1 + v; s2 = s2 + v*v; }; stdev = (s0>1) ? sqrt((s2 - s1*s1/s0) / (s0-1)) : (s0 > 0) ? 0 : NaN ; mean = (s0 > 0) ? s1 / s0 : NaN;" test-one.mnc test-one.mnc test-two.mnc -outfile mean minccalc-out.mnc -outfile stdev minccalc-out2.mnc
+r1=`$MINCSTATS_BIN -quiet -sum minccalc-out.mnc`
+r2=`$MINCSTATS_BIN -quiet -sum minccalc-out2.mnc`
+if [[ $r1 != '166.6666716' || $r2 != '72.16878235' ]]; then
+    echo "Problem with threaded evaluation:" $r1 $r2
+    let errors+=1;
+else
+    echo OK
+fi
+
 if [[ $errors = "0" ]]; then
     echo "No errors detected."
 else
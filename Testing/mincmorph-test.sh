@@ -0,0 +1,144 @@
+#! /bin/bash
+
+# Test mincmorph group labelling and Euclidean distances against
+# brute-force results.
+
+if [[ ! -x $MINCMORPH_BIN ]]; then
+    MINCMORPH_BIN=`which mincmorph`;
+fi
+
+if [[ ! -x $MINCEXTRACT_BIN ]]; then
+    MINCEXTRACT_BIN=`which mincextract`;
+fi
+
+if [[ ! -x $RAWTOMINC_BIN ]]; then
+    RAWTOMINC_BIN=`which rawtominc`;
+fi
+
+# A random binary volume (8 x 9 x 10) with a border of background, so that
+# the way the edges are padded does not matter. Voxel values 1 and 2 are
+# stored for 0 and 1.
+LC_ALL=C awk 'BEGIN {
+  s = 1;
+  for (z = 0; z < 8; z++) for (y = 0; y < 9; y++) for (x = 0; x < 10; x++) {
+    s = (s * 69069 + 1) % 4294967296;
+    inside = (z > 0 && z < 7 && y > 0 && y < 8 && x > 0 && x < 9);
+    printf "%c", (inside && s < 1503238554) ? 2 : 1;
+  } }' | \
+  $RAWTOMINC_BIN -byte -range 1 2 -real_range 0 1 -clobber \
+    mincmorph-in.mnc 8 9 10
+if [[ $? != 0 ]]; then
+  echo "Problem creating the input volume"
+  exit 1;
+fi;
+$MINCEXTRACT_BIN -ascii mincmorph-in.mnc > mincmorph-in.txt
+
+# Label the 6-connected groups of mincmorph-in.txt with a flood fill and
+# compare them with the labels in $1. Groups are numbered by size, largest
+# first, and then by their first voxel in raster order.
+check_groups() {
+  $MINCEXTRACT_BIN -ascii $1 > mincmorph-out.txt || return 1
+  paste mincmorph-in.txt mincmorph-out.txt | awk '
+    { fg[NR - 1] = ($1 > 0.5); lab[NR - 1] = int($2 + 0.5) }
+    END {
+      nx = 10; ny = 9; nz = 8; n = nx * ny * nz;
+      split("1 -1 0 0 0 0", dx); split("0 0 1 -1 0 0", dy);
+      split("0 0 0 0 1 -1", dz);
+      ng = 0;
+      for (i = 0; i < n; i++) {
+        if (!fg[i] || (i in grp)) continue;
+        grp[i] = ++ng; size[ng] = 0; sp = 0; stack[sp++] = i;
+        while (sp > 0) {
+          j = stack[--sp]; size[ng]++;
+          x = j % nx; y = int(j / nx) % ny; z = int(j / (nx * ny));
+          for (d = 1; d <= 6; d++) {
+            if (x + dx[d] < 0 || x + dx[d] >= nx || y + dy[d] < 0 ||
+                y + dy[d] >= ny || z + dz[d] < 0 || z + dz[d] >= nz) continue;
+            k = j + dx[d] + nx * (dy[d] + ny * dz[d]);
+            if (fg[k] && !(k in grp)) { grp[k] = ng; stack[sp++] = k }
+          }
+        }
+      }
+      for (g = 1; g <= ng; g++) {
+        rank[g] = 1;
+        for (h = 1; h <= ng; h++)
+          if (size[h] > size[g] || (size[h] == size[g] && h < g)) rank[g]++;
+      }
+      bad = 0;
+      for (i = 0; i < n; i++)
+        if (lab[i] != (fg[i] ? rank[grp[i]] : 0)) bad++;
+      exit (ng < 2 || bad > 0);
+    }'
+}
+
+$MINCMORPH_BIN -clobber -group mincmorph-in.mnc mincmorph-grp1.mnc
+if ! check_groups mincmorph-grp1.mnc; then
+  echo "Problem with -group"
+  exit 1;
+fi;
+
+$MINCMORPH_BIN -clobber -threads 3 -group mincmorph-in.mnc mincmorph-grp3.mnc
+if ! check_groups mincmorph-grp3.mnc; then
+  echo "Problem with -group -threads 3"
+  exit 1;
+fi;
+
+# A random binary volume (5 x 6 x 7) with unequal voxel separations, for
+# the distance transform.
+LC_ALL=C awk 'BEGIN {
+  s = 7;
+  for (i = 0; i < 5 * 6 * 7; i++) {
+    s = (s * 69069 + 1) % 4294967296;
+    printf "%c", (s < 3006477107) ? 2 : 1;
+  } }' | \
+  $RAWTOMINC_BIN -byte -range 1 2 -real_range 0 1 -clobber \
+    -xstep 1 -ystep 2 -zstep 1.5 mincmorph-edt-in.mnc 5 6 7
+if [[ $? != 0 ]]; then
+  echo "Problem creating the distance input volume"
+  exit 1;
+fi;
+$MINCEXTRACT_BIN -ascii mincmorph-edt-in.mnc > mincmorph-edt-in.txt
+
+# Compare the distances in $1 with the distance from each foreground
+# voxel to the nearest background voxel, found by trying them all. If $2
+# is "signed", background voxels must hold minus the distance to the
+# nearest foreground voxel, otherwise they must be 0.
+check_distances() {
+  $MINCEXTRACT_BIN -ascii $1 > mincmorph-out.txt || return 1
+  paste mincmorph-edt-in.txt mincmorph-out.txt | awk -v mode=$2 '
+    { fg[NR - 1] = ($1 > 0.5); d[NR - 1] = $2 }
+    END {
+      nx = 7; ny = 6; nz = 5; n = nx * ny * nz;
+      bad = 0;
+      for (i = 0; i < n; i++) {
+        best = -1;
+        for (j = 0; j < n; j++) {
+          if (fg[j] == fg[i]) continue;
+          ex = (i % nx - j % nx) * 1;
+          ey = (int(i / nx) % ny - int(j / nx) % ny) * 2;
+          ez = (int(i / (nx * ny)) - int(j / (nx * ny))) * 1.5;
+          dd = ex * ex + ey * ey + ez * ez;
+          if (best < 0 || dd < best) best = dd;
+        }
+        want = fg[i] ? sqrt(best) : (mode == "signed" ? -sqrt(best) : 0);
+        if (d[i] - want > 1e-4 || want - d[i] > 1e-4) bad++;
+      }
+      exit (bad > 0);
+    }'
+}
+
+$MINCMORPH_BIN -clobber -float -edt mincmorph-edt-in.mnc mincmorph-edt1.mnc
+if ! check_distances mincmorph-edt1.mnc unsigned; then
+  echo "Problem with -edt"
+  exit 1;
+fi;
+
+$MINCMORPH_BIN -clobber -float -signed_distance -threads 2 -edt \
+  mincmorph-edt-in.mnc mincmorph-edt2.mnc
+if ! check_distances mincmorph-edt2.mnc signed; then
+  echo "Problem with -edt -signed_distance"
+  exit 1;
+fi;
+
+echo "OK."
+exit 0
@@ -10,6 +10,18 @@ if [[ ! -x $MINCRESAMPLE_BIN ]]; then
     MINCRESAMPLE_BIN=`which mincresample`;
 fi
 
+if [[ ! -x $MINCEXTRACT_BIN ]]; then
+    MINCEXTRACT_BIN=`which mincextract`;
+fi
+
+if [[ ! -x $MINCINFO_BIN ]]; then
+    MINCINFO_BIN=`which mincinfo`;
+fi
+
+if [[ ! -x $RAWTOMINC_BIN ]]; then
+    RAWTOMINC_BIN=`which rawtominc`;
+fi
+
 # Test the standard (no-normalize) case. This has always worked.
 $MINCRESAMPLE_BIN -clobber test-rnd.mnc mincresample-out.mnc
 r1=`$MINCSTATS_BIN -quiet -sum mincresample-out.mnc`
@@ -24,6 +36,29 @@ if [[ $r2 != "250" ]]; then
   echo "Problem with -keep_real_range operation:" $r2
   exit 1;
 fi;
+# Slices computed by several threads must give exactly the same result
+# as a single thread.
+$MINCRESAMPLE_BIN -clobber -trilinear -xstep 0.7 test-rnd.mnc mincresample-out.mnc
+$MINCRESAMPLE_BIN -threads 4 -clobber -trilinear -xstep 0.7 test-rnd.mnc mincresample-out4.mnc
+$MINCEXTRACT_BIN -double mincresample-out.mnc > mincresample-out.raw
+$MINCEXTRACT_BIN -double mincresample-out4.mnc > mincresample-out4.raw
+if [[ ! -s mincresample-out.raw ]] || ! cmp -s mincresample-out.raw mincresample-out4.raw; then
+  echo "Problem with -threads operation"
+  exit 1;
+fi;
+# With -keep_real_range every output slice gets the range of the whole
+# input volume, even when the output grid only covers part of it. The
+# input has a different range in each slice, the largest in the last.
+LC_ALL=C awk 'BEGIN { for (k = 0; k < 3; k++) for (i = 0; i < 16; i++) printf "%c", (i + 1) * (k + 1) * 4 }' | \
+  $RAWTOMINC_BIN -byte -scan_range -clobber mincresample-slices.mnc 3 4 4
+$MINCRESAMPLE_BIN -keep_real_range -znelements 1 -clobber \
+  mincresample-slices.mnc mincresample-out.mnc
+r5=`$MINCINFO_BIN -varvalues image-max mincresample-out.mnc`
+r6=`$MINCINFO_BIN -varvalues image-min mincresample-out.mnc`
+if [[ $r5 != "192" || $r6 != "4" ]]; then
+  echo "Problem with -keep_real_range on part of the input:" $r6 $r5
+  exit 1;
+fi;
 echo "OK."
 exit 0
 
@@ -0,0 +1,67 @@
+#! /bin/bash
+
+# Test random, stratified and column output of mincsample.
+
+if [[ ! -x $MINCSAMPLE_BIN ]]; then
+    MINCSAMPLE_BIN=`which mincsample`;
+fi
+
+if [[ ! -x $RAWTOMINC_BIN ]]; then
+    RAWTOMINC_BIN=`which rawtominc`;
+fi
+
+# A volume holding 1 to 120, and labels 0 to 3 in turn (30 voxels each),
+# so the label of value v is (v - 1) % 4.
+LC_ALL=C awk 'BEGIN { for (i = 1; i <= 120; i++) printf "%c", i }' | \
+  $RAWTOMINC_BIN -byte -clobber mincsample-in.mnc 4 5 6
+LC_ALL=C awk 'BEGIN { for (i = 0; i < 120; i++) printf "%c", i % 4 + 100 }' | \
+  $RAWTOMINC_BIN -byte -range 100 103 -real_range 0 3 -clobber \
+    mincsample-lbl.mnc 4 5 6
+if [[ $? != 0 ]]; then
+  echo "Problem creating the input volumes"
+  exit 1;
+fi;
+
+# Random samples from one label: exactly that many distinct points, all
+# with the label.
+$MINCSAMPLE_BIN -random_seed 1 -random_samples 10 -mask mincsample-lbl.mnc \
+  -mask_val 2 -outfile mincsample-out.txt -clobber mincsample-in.mnc
+r1=`awk '{ print $1 }' mincsample-out.txt | sort -u | wc -l`
+r2=`awk '($1 - 1) % 4 != 2' mincsample-out.txt | wc -l`
+if [[ $r1 != "10" || $r2 != "0" ]]; then
+  echo "Problem with -random_samples:" $r1 $r2
+  exit 1;
+fi;
+
+# Stratified samples: the same number from each non-zero label.
+$MINCSAMPLE_BIN -random_seed 1 -random_samples 7 -stratify \
+  -mask mincsample-lbl.mnc -outfile mincsample-out.txt -clobber mincsample-in.mnc
+r3=`awk '{ n[($1 - 1) % 4]++ } END { print n[0] + 0, n[1], n[2], n[3] }' mincsample-out.txt`
+if [[ $r3 != "0 7 7 7" ]]; then
+  echo "Problem with -stratify:" $r3
+  exit 1;
+fi;
+
+# Asking for more samples than a label has must fail.
+if $MINCSAMPLE_BIN -random_samples 31 -stratify -mask mincsample-lbl.mnc \
+     -outfile mincsample-out.txt -clobber mincsample-in.mnc 2>/dev/null; then
+  echo "Problem with -stratify: too many samples accepted"
+  exit 1;
+fi;
+
+# Column output: an 8 character magic string and three ints, then the
+# same values as -double writes for a single file.
+$MINCSAMPLE_BIN -mask mincsample-lbl.mnc -mask_val 1 -double \
+  -outfile mincsample-out.raw -clobber mincsample-in.mnc
+$MINCSAMPLE_BIN -mask mincsample-lbl.mnc -mask_val 1 -double_columns \
+  -outfile mincsample-out.col -clobber mincsample-in.mnc
+r4=`head -c 8 mincsample-out.col`
+r5=`wc -c < mincsample-out.col`
+if [[ $r4 != "MNCSMPL1" || $r5 -ne 260 ]] || \
+   ! tail -c 240 mincsample-out.col | cmp -s - mincsample-out.raw; then
+  echo "Problem with -double_columns:" $r4 $r5
+  exit 1;
+fi;
+
+echo "OK."
+exit 0
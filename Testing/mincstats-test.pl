@@ -201,6 +201,42 @@ if ($n != 5)
     print "Histogram has the wrong number of bins: $n.\n";
     $errors++;
 }
+print "Case 10 - Test the quantile option.\n";
+
+my $r1 = `$mincstats_bin -quantile 0,0.2,0.5,1 test-rnd.mnc`;
+my @arr = split(/^/m, $r1);
+chomp(@arr);
+if ($arr[0] !~ /^Quantile \[0\]:\s+0$/ ||
+    $arr[1] !~ /^Quantile \[0.2\]:\s+0.8$/ ||
+    $arr[2] !~ /^Quantile \[0.5\]:\s+2$/ ||
+    $arr[3] !~ /^Quantile \[1\]:\s+4$/)
+{
+    print "Case 10 failed, incorrect output value.\n";
+    for (my $i = 0; $i <= $#arr; $i++)
+    {
+        print "/$arr[$i]/\n";
+    }
+    $errors++;
+}
+
+print "Case 11 - Test the labels option.\n";
+
+my $r1 = `$mincstats_bin -labels -mask test-rnd.mnc -count -mean test-rnd.mnc`;
+my $c11result = <<HERE;
+label count mean
+0 25 0
+1 25 1
+2 25 2
+3 25 3
+4 25 4
+HERE
+if ($r1 ne $c11result)
+{
+    print "Case 11 failed, incorrect output.\n";
+    print "/$r1/\n";
+    $errors++;
+}
+
 print "OK.\n" if $errors == 0;
 print
 exit $errors > 0;
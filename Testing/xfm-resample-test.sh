@@ -0,0 +1,80 @@
+#! /bin/bash
+
+# Resampling a transform onto a grid with several threads must give
+# exactly the same displacement volume as doing it with one thread.
+
+if [[ ! -x $RAWTOMINC_BIN ]]; then
+    RAWTOMINC_BIN=`which rawtominc`;
+fi
+
+if [[ ! -x $MINCEXTRACT_BIN ]]; then
+    MINCEXTRACT_BIN=`which mincextract`;
+fi
+
+if [[ ! -x $XFMCONCAT_BIN ]]; then
+    XFMCONCAT_BIN=`which xfmconcat`;
+fi
+
+if [[ ! -x $XFMINVERT_BIN ]]; then
+    XFMINVERT_BIN=`which xfminvert`;
+fi
+
+# Displacement grid with an arbitrary but repeatable pattern.
+LC_ALL=C awk 'BEGIN { for (i = 0; i < 8*8*8*3; i++) printf "%c", (i*37)%251 + 1 }' | \
+  $RAWTOMINC_BIN -vector 3 -byte -real_range -2 2 -clobber \
+    -xstart -7 -ystart -7 -zstart -7 -xstep 2 -ystep 2 -zstep 2 \
+    xfm-resample-disp.mnc 8 8 8
+if [[ $? != 0 ]]; then
+  echo "Problem creating the displacement grid"
+  exit 1;
+fi;
+
+cat > xfm-resample-grid.xfm <<EOF
+MNI Transform File
+
+Transform_Type = Grid_Transform;
+Displacement_Volume = xfm-resample-disp.mnc;
+EOF
+
+cat > xfm-resample-lin.xfm <<EOF
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 1 0 0 1.5
+ 0 1 0 -2
+ 0 0 1 0.5;
+EOF
+
+# Sampling to resample onto.
+dd if=/dev/zero bs=1000 count=1 2>/dev/null | \
+  $RAWTOMINC_BIN -byte -clobber -xstart -5 -ystart -5 -zstart -5 \
+    xfm-resample-like.mnc 10 10 10
+
+# Compare the grids written for $1 and $2 voxel by voxel.
+compare_grids() {
+  $MINCEXTRACT_BIN -double ${1}_grid_0.mnc > xfm-resample-1.raw || return 1
+  $MINCEXTRACT_BIN -double ${2}_grid_0.mnc > xfm-resample-2.raw || return 1
+  cmp -s xfm-resample-1.raw xfm-resample-2.raw
+}
+
+$XFMCONCAT_BIN -clobber -resample_to xfm-resample-like.mnc \
+  xfm-resample-lin.xfm xfm-resample-grid.xfm xfm-resample-cat1.xfm
+$XFMCONCAT_BIN -clobber -resample_to xfm-resample-like.mnc -threads 4 \
+  xfm-resample-lin.xfm xfm-resample-grid.xfm xfm-resample-cat4.xfm
+if ! compare_grids xfm-resample-cat1 xfm-resample-cat4; then
+  echo "Problem with xfmconcat -threads operation"
+  exit 1;
+fi;
+
+$XFMINVERT_BIN -clobber -resample_to xfm-resample-like.mnc \
+  xfm-resample-grid.xfm xfm-resample-inv1.xfm
+$XFMINVERT_BIN -clobber -resample_to xfm-resample-like.mnc -threads 4 \
+  xfm-resample-grid.xfm xfm-resample-inv4.xfm
+if ! compare_grids xfm-resample-inv1 xfm-resample-inv4; then
+  echo "Problem with xfminvert -threads operation"
+  exit 1;
+fi;
+
+echo "OK."
+exit 0
@@ -23,9 +23,11 @@
 #cmakedefine HAVE_INTTYPES_H 1 
 #cmakedefine HAVE_MEMORY_H 1 
 #cmakedefine HAVE_MKSTEMP 1 
+#cmakedefine HAVE_MMAP 1 
 #cmakedefine HAVE_NDIR_H 1 
 #cmakedefine HAVE_POPEN 1 
 #cmakedefine HAVE_PWD_H 1 
+#cmakedefine HAVE_PTHREAD 1 
 #cmakedefine HAVE_SELECT 1 
 #cmakedefine HAVE_STDINT_H 1 
 #cmakedefine HAVE_STDLIB_H 1 
@@ -33,6 +35,7 @@
 #cmakedefine HAVE_SYSCONF 1 
 #cmakedefine HAVE_SYSTEM 1 
 #cmakedefine HAVE_SYS_DIR_H 1 
+#cmakedefine HAVE_SYS_MMAN_H 1 
 #cmakedefine HAVE_SYS_NDIR_H 1 
 #cmakedefine HAVE_SYS_STAT_H 1 
 #cmakedefine HAVE_SYS_TIME_H 1 
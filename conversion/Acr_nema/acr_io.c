@@ -121,6 +121,14 @@
 
 #define ACR_VR_ENCODING_DEFAULT ACR_IMPLICIT_VR
 
+/* Values at least this long may be left in a mapped input file rather
+   than copied */
+#define ACR_MIN_MAPPED_LENGTH 4096
+
+/* Pixel data element, the only value that is mapped */
+#define ACR_PIXEL_DATA_GID 0x7fe0
+#define ACR_PIXEL_DATA_EID 0x0010
+
 /* Define types */
 typedef struct {
    Acr_byte_order byte_order;
@@ -133,6 +141,8 @@ static int test_vr(const char vr_to_test[2], const char *vr_list[]);
 static int is_sequence_vr(const char vr_to_test[2]);
 static int is_special_vr(const char vr_to_test[2]);
 static int is_vr(const char vr_to_test[2]);
+static int is_mappable_value(int group_id, int element_id, 
+                             long data_length);
 static Data_Info get_data_info(Acr_File *afp);
 static void invert_values(Acr_byte_order byte_order, 
                           long nvals, size_t value_size, 
@@ -195,6 +205,30 @@ static int is_vr(const char vr_to_test[2])
    return test_vr(vr_to_test, all_vrs);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : is_mappable_value
+@INPUT      : group_id
+              element_id
+              data_length
+@OUTPUT     : (none)
+@RETURNS    : TRUE if the value can be left in a mapped input file
+@DESCRIPTION: Mapped values are not followed by a NUL. Even binary values
+              such as the Siemens protocol (an OB element) get searched as
+              strings, so only large pixel data values are mapped.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int is_mappable_value(int group_id, int element_id, 
+                             long data_length)
+{
+   return ((data_length >= ACR_MIN_MAPPED_LENGTH) &&
+           (group_id == ACR_PIXEL_DATA_GID) && 
+           (element_id == ACR_PIXEL_DATA_EID));
+}
+
 
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : get_data_info
@@ -686,21 +720,31 @@ void acr_put_double(Acr_byte_order byte_order,
               then ACR_ABNORMAL_END_OF_INPUT is returned, otherwise ACR_OK
               is returned.
 @DESCRIPTION: Skips over input data.
-@METHOD     : 
+@METHOD     : Whatever is already buffered is skipped at once.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 12, 1997 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 Acr_Status acr_skip_input_data(Acr_File *afp, long nbytes_to_skip)
 {
-   long i;
+   long i, nbuffered;
    int ch;
 
-   for (i=0; i < nbytes_to_skip; i++) {
-      ch = acr_getc(afp);
-      if (ch == EOF) {
-         break;
+   i = 0;
+   while (i < nbytes_to_skip) {
+      nbuffered = afp->end - afp->ptr;
+      if (nbuffered > 0) {
+         if (nbuffered > nbytes_to_skip - i) nbuffered = nbytes_to_skip - i;
+         afp->ptr += nbuffered;
+         i += nbuffered;
+      }
+      else {
+         ch = acr_file_read_more(afp);
+         if (ch == EOF) {
+            break;
+         }
+         i++;
       }
    }
 
@@ -732,24 +776,34 @@ Acr_Status acr_skip_input_data(Acr_File *afp, long nbytes_to_skip)
               is returned.
 @DESCRIPTION: Reads in a buffer of data and optionally returns the number 
               of bytes read
-@METHOD     : 
+@METHOD     : Whatever is already buffered is copied at once.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 12, 1997 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 Acr_Status acr_read_buffer(Acr_File *afp, unsigned char buffer[],
                            long nbytes_to_read, long *nbytes_read)
 {
-   long i;
+   long i, nbuffered;
    int ch;
 
-   for (i=0; i < nbytes_to_read; i++) {
-      ch = acr_getc(afp);
-      if (ch == EOF) {
-         break;
+   i = 0;
+   while (i < nbytes_to_read) {
+      nbuffered = afp->end - afp->ptr;
+      if (nbuffered > 0) {
+         if (nbuffered > nbytes_to_read - i) nbuffered = nbytes_to_read - i;
+         (void) memcpy(&buffer[i], afp->ptr, (size_t) nbuffered);
+         afp->ptr += nbuffered;
+         i += nbuffered;
+      }
+      else {
+         ch = acr_file_read_more(afp);
+         if (ch == EOF) {
+            break;
+         }
+         buffer[i++] = (unsigned char) ch;
       }
-      buffer[i] = (unsigned char) ch;
    }
 
    /* Save the number of bytes read */
@@ -1032,6 +1086,40 @@ Acr_Status acr_read_one_element(Acr_File *afp,
                                 int *group_id, int *element_id,
                                 char vr_name[],
                                 long *data_length, char **data_pointer)
+{
+   return acr_read_one_element_mapped(afp, group_id, element_id, vr_name,
+                                      data_length, data_pointer, NULL);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_read_one_element_mapped
+@INPUT      : afp - Acr_File pointer from which to read
+@OUTPUT     : group_id - ACR-NEMA group id
+              element_id - ACR-NEMA element id
+              vr_name - 2 character string giving value representation.
+                 Two NULs are returned if VR is unknown.
+              data_length - length of data to follow.
+              data_pointer - pointer to data, as for acr_read_one_element.
+              mapped_file - if NULL, the data is always copied. Otherwise,
+                 if the stream is a mapped file and the value is large 
+                 pixel data, data_pointer points into the file instead and 
+                 mapped_file is set to the file, which must be released 
+                 with acr_file_release_mapped_data. Set to NULL if the 
+                 data was copied.
+@RETURNS    : VIO_Status.
+@DESCRIPTION: Routine to read in one ACR-NEMA element, leaving large pixel
+              data in a mapped input file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+Acr_Status acr_read_one_element_mapped(Acr_File *afp,
+                                       int *group_id, int *element_id,
+                                       char vr_name[],
+                                       long *data_length, char **data_pointer,
+                                       Acr_Mapped_File **mapped_file)
 {
    long buflen;
    unsigned char buffer[2*ACR_SIZEOF_SHORT+ACR_SIZEOF_LONG];
@@ -1044,6 +1132,9 @@ Acr_Status acr_read_one_element(Acr_File *afp,
 
    /* Get byte ordering */
    byte_order = acr_get_byte_order(afp);
+   if (mapped_file != NULL) {
+      *mapped_file = NULL;
+   }
 
    /* Read in group id, element id and length of data */
    status = acr_read_buffer(afp, buffer, SIZEOF_ARRAY(buffer), &buflen);
@@ -1092,6 +1183,16 @@ Acr_Status acr_read_one_element(Acr_File *afp,
       return ACR_OK;
    }
    
+   /* Leave large pixel data values in a mapped file */
+   if ((mapped_file != NULL) &&
+       is_mappable_value(*group_id, *element_id, *data_length)) {
+      *data_pointer = acr_file_get_mapped_data(afp, *data_length, 
+                                               mapped_file);
+      if (*data_pointer != NULL) {
+         return ACR_OK;
+      }
+   }
+
    /* Allocate space for the data and null-terminate it */
    size_allocated = *data_length + 1;
    *data_pointer = MALLOC(size_allocated);
@@ -188,6 +188,12 @@ extern Acr_Status acr_read_one_element(Acr_File *afp,
                                        int *group_id, int *element_id,
                                        char vr_name[],
                                        long *data_length, char **data_pointer);
+extern Acr_Status acr_read_one_element_mapped(Acr_File *afp,
+                                              int *group_id, int *element_id,
+                                              char vr_name[],
+                                              long *data_length, 
+                                              char **data_pointer,
+                                              Acr_Mapped_File **mapped_file);
 extern Acr_Status acr_write_one_element(Acr_File *afp,
                                         int group_id, int element_id,
                                         char vr_name[],
@@ -96,6 +96,8 @@ typedef struct Acr_Element {
    long data_length;
    char *data_pointer;
    struct Acr_Element *next;
+   Acr_Mapped_File *mapped_file; /* File holding the data if it was not
+                                    copied, or NULL */
    short vr_code;
    unsigned int is_sequence:1;
    unsigned int has_variable_length:1;
@@ -156,6 +158,7 @@ extern Acr_Element acr_element_list_add(Acr_Element element_list,
                                         Acr_Element element);
 extern void acr_set_element_id(Acr_Element element,
                                int group_id, int element_id);
+extern long acr_get_element_id_generation(void);
 extern void acr_set_element_vr(Acr_Element element,
                                Acr_VR_Type vr_code);
 extern void acr_set_element_vr_encoding(Acr_Element element,
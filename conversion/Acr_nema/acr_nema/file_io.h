@@ -80,6 +80,16 @@ typedef int (*Acr_Io_Routine)
 typedef int (*Acr_Ismore_Function)
      (void *io_data);
 
+/* Memory-mapped input file. It is shared by the Acr_File reading it and
+   by any elements whose data points into it, and is unmapped when the
+   last of them is freed. */
+
+typedef struct Acr_Mapped_File {
+   unsigned char *start;
+   size_t length;
+   int reference_count;
+} Acr_Mapped_File;
+
 /* Structure used for reading and writing in acr_nema routines */
 
 typedef struct {
@@ -100,6 +110,8 @@ typedef struct {
    long bytes_to_watchpoint;    /* number of bytes from start of buffer
                                    to watchpoint */
    void *client_data;           /* Data that can be set by calling routines */
+   Acr_Mapped_File *mapped_file; /* Input file if it is mapped, or NULL */
+   int close_io_data;           /* TRUE if io_data is a FILE * to close */
 } Acr_File;
 
 /* Macros for getting and putting a character */
@@ -118,6 +130,7 @@ extern void acr_file_disable_trace(Acr_File *afp);
 extern Acr_File *acr_file_initialize(void *io_data,
                                      int maxlength,
                                      Acr_Io_Routine io_routine);
+extern Acr_File *acr_file_initialize_path(const char *path, int maxlength);
 extern void acr_file_free(Acr_File *afp);
 extern void acr_file_reset(Acr_File *afp);
 extern void acr_file_set_ismore_function(Acr_File *afp, 
@@ -130,6 +143,11 @@ extern int acr_file_write_more(Acr_File *afp, int character);
 extern int acr_file_flush(Acr_File *afp);
 extern int acr_ungetc(int c, Acr_File *afp);
 extern void *acr_file_get_io_data(Acr_File *afp);
+extern long acr_file_get_buffered_length(Acr_File *afp);
+extern long acr_file_tell(Acr_File *afp);
+extern char *acr_file_get_mapped_data(Acr_File *afp, long nbytes,
+                                      Acr_Mapped_File **mapped_file);
+extern void acr_file_release_mapped_data(Acr_Mapped_File *mapped_file);
 extern void acr_set_io_watchpoint(Acr_File *afp, long bytes_to_watchpoint);
 extern long acr_get_io_watchpoint(Acr_File *afp);
 extern int acr_file_ismore(Acr_File *afp);
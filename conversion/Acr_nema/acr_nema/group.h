@@ -96,6 +96,10 @@ typedef struct Acr_Group {
    Acr_Element list_head;
    Acr_Element list_tail;
    struct Acr_Group *next;
+   Acr_Element *index;          /* Hash table of elements by id, or NULL */
+   int index_bits;              /* Table has 2^index_bits entries */
+   int index_valid;
+   long index_generation;       /* Element id generation when built */
 } *Acr_Group;
 
 /* Group length element id */
@@ -140,6 +140,10 @@ static Acr_Element create_element_mem(Acr_Element_Id elid,
 /* Macros */
 #define SIZEOF_ARRAY(a) (sizeof(a)/sizeof(a[0]))
 
+/* Count of changes to the id of existing elements, so that group indices
+   can tell when they are out of date */
+static long element_id_generation = 0;
+
 
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_create_element
@@ -173,9 +177,12 @@ Acr_Element acr_create_element(int group_id, int element_id,
       acr_set_element_data does not try to free an unitialized pointer */
    element = MALLOC(sizeof(*element));
    element->data_pointer = NULL;
+   element->mapped_file = NULL;
 
-   /* Assign fields */
-   acr_set_element_id(element, group_id, element_id);
+   /* Assign fields. The id is set directly since a new element cannot
+      be in an indexed group yet */
+   element->group_id = group_id;
+   element->element_id = element_id;
    acr_set_element_vr(element, vr_code);
    acr_set_element_vr_encoding(element, ACR_EXPLICIT_VR);
    acr_set_element_byte_order(element, acr_get_machine_byte_order());
@@ -197,7 +204,7 @@ Acr_Element acr_create_element(int group_id, int element_id,
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 4, 1997 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void delete_element_data(Acr_Element element)
 {
@@ -208,10 +215,14 @@ static void delete_element_data(Acr_Element element)
       if (acr_element_is_sequence(element)) {
          acr_delete_element_list((Acr_Element) data_pointer);
       }
+      else if (element->mapped_file != NULL) {
+         acr_file_release_mapped_data(element->mapped_file);
+      }
       else {
          FREE(data_pointer);
       }
    }
+   element->mapped_file = NULL;
 
    return;
 }
@@ -311,19 +322,39 @@ Acr_Element acr_element_list_add(Acr_Element element_list,
 @RETURNS    : (nothing)
 @DESCRIPTION: Set group and element id of an acr-nema element
 @METHOD     : 
-@GLOBALS    : 
+@GLOBALS    : element_id_generation
 @CALLS      : 
 @CREATED    : November 10, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 void acr_set_element_id(Acr_Element element,
                         int group_id, int element_id)
 {
    element->group_id = group_id;
    element->element_id = element_id;
+   element_id_generation++;
    return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_get_element_id_generation
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : count of calls to acr_set_element_id
+@DESCRIPTION: Returns a number that changes whenever the id of an existing
+              element is changed. Group indices use it to tell whether an
+              element may have been renamed since they were built.
+@METHOD     : 
+@GLOBALS    : element_id_generation
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+long acr_get_element_id_generation(void)
+{
+   return element_id_generation;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_set_element_vr
 @INPUT      : element
@@ -794,7 +825,7 @@ Acr_Element acr_copy_element(Acr_Element element)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 10, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 Acr_Status acr_input_element(Acr_File *afp, Acr_Element *element)
 {
@@ -807,15 +838,17 @@ Acr_Status acr_input_element(Acr_File *afp, Acr_Element *element)
    Acr_Element item, itemlist, previtem;
    Acr_VR_Type vr_code;
    Acr_VR_encoding_type vr_encoding;
+   Acr_Mapped_File *mapped_file;
 
    /* Set element in case of error */
    *element = NULL;
 
    vr_encoding = acr_get_vr_encoding(afp);
 
-   /* Read in the value */
-   status = acr_read_one_element(afp, &group_id, &element_id, vr_name,
-                                 &data_length, &data_pointer);
+   /* Read in the value, leaving large values in a mapped file */
+   status = acr_read_one_element_mapped(afp, &group_id, &element_id, vr_name,
+                                        &data_length, &data_pointer,
+                                        &mapped_file);
 
    if (status != ACR_OK) {
       return status;
@@ -887,6 +920,7 @@ Acr_Status acr_input_element(Acr_File *afp, Acr_Element *element)
    *element = acr_create_element(group_id, element_id, vr_code, 
                                  (is_sequence ? -1 : data_length),
                                  data_pointer);
+   (*element)->mapped_file = mapped_file;
    acr_set_element_vr_encoding(*element, acr_get_vr_encoding(afp));
    acr_set_element_byte_order(*element, acr_get_byte_order(afp));
    if (is_sequence && !has_variable_length) {
@@ -121,6 +121,12 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <limits.h>
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include <acr_nema/file_io.h>
 
 /* Define some constants */
@@ -144,6 +150,9 @@ static char *Input_trace_file = "acr_file_input_XXXXXX";
 static char *Output_trace_file = "acr_file_output_XXXXXX";
 #endif
 
+/* Private functions */
+static int extend_mapped_input(Acr_File *afp);
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_file_enable_trace
 @INPUT      : afp
@@ -193,7 +202,7 @@ void acr_file_disable_trace(Acr_File *afp)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 9, 1993 (Peter Neelin)
-@MODIFIED   : February 5, 1997 (P.N.)
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 Acr_File *acr_file_initialize(void *io_data,
                               int maxlength,
@@ -223,6 +232,8 @@ Acr_File *acr_file_initialize(void *io_data,
    afp->watchpoint_set = FALSE;
    afp->bytes_to_watchpoint = 0;
    afp->client_data = NULL;
+   afp->mapped_file = NULL;
+   afp->close_io_data = FALSE;
 
    /* Allocate the buffer */
    afp->start = malloc((size_t) afp->buffer_length);
@@ -239,17 +250,107 @@ Acr_File *acr_file_initialize(void *io_data,
    return afp;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_file_initialize_path
+@INPUT      : path - name of file to read
+              maxlength - maximum length for a single read if the file
+                 cannot be mapped (zero or negative means use internal 
+                 maximum).
+@OUTPUT     : (none)
+@RETURNS    : pointer to Acr_File structure created, or NULL if the file
+              cannot be opened
+@DESCRIPTION: Sets up an input stream that reads from a file. Regular 
+              files are mapped into memory so that they are read without
+              copying, and large values can be left in place by 
+              acr_file_get_mapped_data. Other files are read through 
+              stdio. The file is closed by acr_file_free.
+@METHOD     : The mapping is private and writable so that values can be
+              byte-swapped in place, with the system copying only the 
+              pages that are changed.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+Acr_File *acr_file_initialize_path(const char *path, int maxlength)
+{
+   Acr_File *afp;
+   FILE *fp;
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+   Acr_Mapped_File *mapped_file;
+   struct stat file_stat;
+   void *start;
+   int fd;
+
+   /* Try to map the file */
+   fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      return NULL;
+   }
+   start = MAP_FAILED;
+   if ((fstat(fd, &file_stat) == 0) && S_ISREG(file_stat.st_mode) &&
+       (file_stat.st_size > 0) && 
+       ((off_t) (size_t) file_stat.st_size == file_stat.st_size)) {
+      start = mmap(NULL, (size_t) file_stat.st_size, 
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+   }
+   (void) close(fd);
+
+   if (start != MAP_FAILED) {
+      mapped_file = malloc(sizeof(*mapped_file));
+      mapped_file->start = start;
+      mapped_file->length = (size_t) file_stat.st_size;
+      mapped_file->reference_count = 1;
+
+      /* Set up the stream with the whole file as its buffer. The 
+         buffer lengths are only used for output. */
+      afp = malloc(sizeof(*afp));
+      afp->io_data = NULL;
+      afp->io_routine = NULL;
+      afp->ismore_function = NULL;
+      afp->maxlength = ACR_MAX_BUFFER_LENGTH;
+      afp->start = mapped_file->start;
+      afp->end = mapped_file->start + mapped_file->length;
+      afp->ptr = afp->start;
+      afp->length = 0;
+      afp->buffer_length = 0;
+      afp->stream_type = ACR_READ_STREAM;
+      afp->reached_eof = FALSE;
+      afp->do_trace = FALSE;
+      afp->tracefp = NULL;
+      afp->watchpoint_set = FALSE;
+      afp->bytes_to_watchpoint = 0;
+      afp->client_data = NULL;
+      afp->mapped_file = mapped_file;
+      afp->close_io_data = FALSE;
+
+      return afp;
+   }
+#endif
+
+   /* Otherwise read the file through stdio */
+   fp = fopen(path, "rb");
+   if (fp == NULL) {
+      return NULL;
+   }
+   afp = acr_file_initialize(fp, maxlength, acr_stdio_read);
+   afp->close_io_data = TRUE;
+
+   return afp;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_file_free
 @INPUT      : afp
 @OUTPUT     : (none)
 @RETURNS    : (nothing)
 @DESCRIPTION: Frees the Acr_File structure, flushing the buffer if needed.
+              A mapped file stays mapped until no elements refer to it.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 9, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 void acr_file_free(Acr_File *afp)
 {
@@ -257,9 +358,15 @@ void acr_file_free(Acr_File *afp)
       if (afp->stream_type == ACR_WRITE_STREAM) {
          (void) acr_file_flush(afp);
       }
-      if (afp->start != NULL) {
+      if (afp->mapped_file != NULL) {
+         acr_file_release_mapped_data(afp->mapped_file);
+      }
+      else if (afp->start != NULL) {
          free(afp->start);
       }
+      if (afp->close_io_data) {
+         (void) fclose((FILE *) afp->io_data);
+      }
       if (afp->tracefp != NULL) {
          (void) fclose(afp->tracefp);
       }
@@ -278,20 +385,23 @@ void acr_file_free(Acr_File *afp)
 @RETURNS    : (nothing)
 @DESCRIPTION: Resets the input or output stream, discarding anything that
               was buffered. Any watchpoint is unset. The eof flag is unset.
+              A mapped file has nothing buffered beyond the file itself, 
+              so only the watchpoint and eof flag are reset.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 18, 1997 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 void acr_file_reset(Acr_File *afp)
 {
    afp->watchpoint_set = FALSE;
    afp->bytes_to_watchpoint = 0;
+   afp->reached_eof = FALSE;
+   if (afp->mapped_file != NULL) return;
    afp->length = 0;
    afp->end = afp->start;
    afp->ptr = afp->end;
-   afp->reached_eof = FALSE;
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -390,7 +500,7 @@ void *acr_file_get_client_data(Acr_File *afp)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 9, 1993 (Peter Neelin)
-@MODIFIED   : February 5, 1997 (P.N.)
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 int acr_file_read_more(Acr_File *afp)
 {
@@ -423,6 +533,15 @@ int acr_file_read_more(Acr_File *afp)
       return EOF;
    }
 
+   /* A mapped file is already in memory, we just may not have been 
+      allowed to look at all of it */
+   if (afp->mapped_file != NULL) {
+      if (!extend_mapped_input(afp)) {
+         return EOF;
+      }
+      return (int) *(afp->ptr++);
+   }
+
    /* Work out the amount to read */
    bytes_to_read = afp->maxlength;
    if (afp->watchpoint_set) {
@@ -508,6 +627,47 @@ int acr_file_read_more(Acr_File *afp)
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : extend_mapped_input
+@INPUT      : afp - Acr_File pointer for a mapped file
+@OUTPUT     : (none)
+@RETURNS    : TRUE if more data was made available.
+@DESCRIPTION: Moves the end of the input for a mapped file up to the 
+              watchpoint or the end of the file. The end of the input is
+              kept at the watchpoint so that acr_getc will stop there. The
+              eof flag is set when the end of the file is reached.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int extend_mapped_input(Acr_File *afp)
+{
+   unsigned char *file_end;
+   long watchpoint_distance;
+
+   file_end = afp->mapped_file->start + afp->mapped_file->length;
+   if (afp->watchpoint_set) {
+      watchpoint_distance = (afp->start + afp->bytes_to_watchpoint - afp->end);
+      if (watchpoint_distance <= 0) {
+         return FALSE;
+      }
+      else if (watchpoint_distance < file_end - afp->end) {
+         afp->end += watchpoint_distance;
+         return TRUE;
+      }
+   }
+
+   if (afp->end >= file_end) {
+      afp->reached_eof = TRUE;
+      return FALSE;
+   }
+   afp->end = file_end;
+
+   return TRUE;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_file_write_more
 @INPUT      : afp - Acr_File pointer
@@ -696,6 +856,128 @@ void *acr_file_get_io_data(Acr_File *afp)
    return afp->io_data;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_file_get_buffered_length
+@INPUT      : afp - Acr_File pointer
+@OUTPUT     : (none)
+@RETURNS    : number of bytes buffered but not yet consumed
+@DESCRIPTION: Returns the number of bytes that have been read from the io
+              routine but not yet consumed from the buffer. For a seekable
+              input stream, subtracting this from the stream position gives
+              the position of the next byte to be read.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+long acr_file_get_buffered_length(Acr_File *afp)
+{
+   if ((afp == NULL) || (afp->stream_type != ACR_READ_STREAM)) return 0;
+
+   return (long) (afp->end - afp->ptr);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_file_tell
+@INPUT      : afp - Acr_File pointer
+@OUTPUT     : (none)
+@RETURNS    : offset in the file of the next byte to be read, or -1 if 
+              it is not known
+@DESCRIPTION: Returns the position of an input stream that was set up by
+              acr_file_initialize_path.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+long acr_file_tell(Acr_File *afp)
+{
+   long position;
+
+   if (afp == NULL) return -1;
+
+   if (afp->mapped_file != NULL) {
+      return (long) (afp->ptr - afp->mapped_file->start);
+   }
+
+   if (!afp->close_io_data) return -1;
+   position = ftell((FILE *) afp->io_data);
+   if (position < 0) return -1;
+
+   return position - acr_file_get_buffered_length(afp);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_file_get_mapped_data
+@INPUT      : afp - Acr_File pointer
+              nbytes - number of bytes wanted
+@OUTPUT     : mapped_file - set to the mapped file holding the data
+@RETURNS    : pointer to the data, or NULL if the stream is not a mapped 
+              file or the data goes past the end of input
+@DESCRIPTION: Consumes nbytes of input from a mapped file without copying
+              them. The data stays valid until it is released with 
+              acr_file_release_mapped_data, even if the stream is freed
+              first. Unlike data read by acr_read_buffer, it is not 
+              followed by a NUL. The data may be modified in place, but 
+              the change only affects this process.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+char *acr_file_get_mapped_data(Acr_File *afp, long nbytes,
+                               Acr_Mapped_File **mapped_file)
+{
+   char *data;
+
+   if ((afp == NULL) || (afp->mapped_file == NULL) || (nbytes < 0)) {
+      return NULL;
+   }
+
+   /* Make sure that the data is all available */
+   while (afp->end - afp->ptr < nbytes) {
+      if (!extend_mapped_input(afp)) {
+         return NULL;
+      }
+   }
+
+   data = (char *) afp->ptr;
+   afp->ptr += nbytes;
+   afp->mapped_file->reference_count++;
+   *mapped_file = afp->mapped_file;
+
+   return data;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : acr_file_release_mapped_data
+@INPUT      : mapped_file
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Gives up a reference to a mapped file, unmapping it when 
+              the stream and all of the data taken from it are released.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void acr_file_release_mapped_data(Acr_Mapped_File *mapped_file)
+{
+   if (mapped_file == NULL) return;
+
+   mapped_file->reference_count--;
+   if (mapped_file->reference_count > 0) return;
+
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+   (void) munmap((void *) mapped_file->start, mapped_file->length);
+#endif
+   free(mapped_file);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : acr_set_io_watchpoint
 @INPUT      : afp - Acr_File pointer
@@ -710,7 +992,7 @@ void *acr_file_get_io_data(Acr_File *afp)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 5, 1997 (P.N.)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 void acr_set_io_watchpoint(Acr_File *afp, long bytes_to_watchpoint)
 {
@@ -727,6 +1009,14 @@ void acr_set_io_watchpoint(Acr_File *afp, long bytes_to_watchpoint)
       afp->watchpoint_set = TRUE;
       afp->bytes_to_watchpoint = bytes_to_watchpoint + afp->ptr - afp->start;
 
+      /* For a mapped file, make sure that acr_getc stops at the 
+         watchpoint */
+      if ((afp->mapped_file != NULL) &&
+          (afp->bytes_to_watchpoint < afp->end - afp->start)) {
+         afp->end = afp->start + afp->bytes_to_watchpoint;
+         if (afp->end < afp->ptr) afp->end = afp->ptr;
+      }
+
       /* For writing, check if we need to move the end of the buffer to
          force a flush at the watchpoint */
       if ((afp->stream_type == ACR_WRITE_STREAM) &&
@@ -147,6 +147,16 @@ static void update_group_length_element(Acr_Group group,
                                         Acr_VR_encoding_type vr_encoding);
 static Acr_Status acr_input_group_with_max(Acr_File *afp, Acr_Group *group, 
                                            int max_group_id);
+static void build_group_index(Acr_Group group);
+static Acr_Element find_indexed_element(Acr_Group group, int element_id);
+
+/* Groups with fewer elements than this are searched linearly */
+#define GROUP_INDEX_MIN_ELEMENTS 16
+
+/* Fibonacci hash of an element id into a table of 2^bits entries */
+#define GROUP_INDEX_HASH(element_id, bits) \
+   ((int) (((((unsigned long) (element_id)) * 2654435761UL) & 0xffffffffUL) \
+           >> (32 - (bits))))
 
 acr_name_proc_t _acr_name_proc = NULL;
 
@@ -189,6 +199,10 @@ Acr_Group acr_create_group(int group_id)
    group->list_head = length_element;
    group->list_tail = length_element;
    group->next = NULL;
+   group->index = NULL;
+   group->index_bits = 0;
+   group->index_valid = FALSE;
+   group->index_generation = 0;
 
    return group;
 }
@@ -203,12 +217,16 @@ Acr_Group acr_create_group(int group_id)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 10, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 void acr_delete_group(Acr_Group group)
 {
    acr_delete_element_list(group->list_head);
 
+   if (group->index != NULL) {
+      FREE(group->index);
+   }
+
    FREE(group);
 
    return;
@@ -321,7 +339,7 @@ Acr_Group acr_copy_group_list(Acr_Group group_list)
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 6, 1998 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void steal_element(Acr_Group group, Acr_Element element, 
                           Acr_Element previous)
@@ -343,6 +361,7 @@ static void steal_element(Acr_Group group, Acr_Element element,
 
    /* Update the group fields */
    group->nelements--;
+   group->index_valid = FALSE;
    group->implicit_total_length -= 
       acr_get_element_total_length(element, ACR_IMPLICIT_VR);
    group->explicit_total_length -= 
@@ -394,7 +413,7 @@ static void remove_element(Acr_Group group, Acr_Element element,
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : June 17, 1997 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static Acr_Status insert_element(Acr_Group group, Acr_Element element, 
                                  Acr_Element previous)
@@ -420,6 +439,7 @@ static Acr_Status insert_element(Acr_Group group, Acr_Element element,
 
    /* Update the group fields */
    group->nelements++;
+   group->index_valid = FALSE;
    length = acr_get_element_total_length(element, ACR_IMPLICIT_VR);
    if (length <= 0) {
       return (ACR_OTHER_ERROR);
@@ -1077,16 +1097,18 @@ Acr_Group acr_find_group(Acr_Group group_list, int group_id)
 @OUTPUT     : (none)
 @RETURNS    : element pointer
 @DESCRIPTION: Find an element in a group list
-@METHOD     : 
+@METHOD     : Large groups are searched through a hash index that is built
+              on the first search and rebuilt after the group changes.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : November 10, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 Acr_Element acr_find_group_element(Acr_Group group_list,
                                    Acr_Element_Id elid)
 {
    Acr_Group group;
+   Acr_Element element;
 
    /* Find the group */
    group = acr_find_group(group_list, elid->group_id);
@@ -1094,8 +1116,111 @@ Acr_Element acr_find_group_element(Acr_Group group_list,
    /* If not found return NULL */
    if (group == NULL) return NULL;
 
-   /* Search through element list for element */
-   return acr_find_element_id(acr_get_group_element_list(group), elid);
+   /* Search through element list for small groups */
+   if (group->nelements < GROUP_INDEX_MIN_ELEMENTS) {
+      return acr_find_element_id(acr_get_group_element_list(group), elid);
+   }
+
+   /* Look the element up in the index, letting acr_find_element_id 
+      check the match and set an unknown VR */
+   element = find_indexed_element(group, elid->element_id);
+   if (element == NULL) return NULL;
+   return acr_find_element_id(element, elid);
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : build_group_index
+@INPUT      : group
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Builds the hash index of the elements of a group, keyed on 
+              element id. If an id appears more than once, the first 
+              element in the list is indexed, as for a linear search.
+@METHOD     : Open addressing with linear probing in a table at least 
+              twice the number of elements.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void build_group_index(Acr_Group group)
+{
+   int bits, size, mask, slot, element_id;
+   Acr_Element element;
+
+   /* Get a table of the right size */
+   bits = 5;
+   while ((1 << bits) < 2 * group->nelements) bits++;
+   size = 1 << bits;
+   if (group->index != NULL && group->index_bits != bits) {
+      FREE(group->index);
+      group->index = NULL;
+   }
+   if (group->index == NULL) {
+      group->index = MALLOC(size * sizeof(*group->index));
+      group->index_bits = bits;
+   }
+   for (slot = 0; slot < size; slot++) {
+      group->index[slot] = NULL;
+   }
+
+   /* Add the elements */
+   mask = size - 1;
+   for (element = group->list_head; element != NULL; 
+        element = acr_get_element_next(element)) {
+      element_id = acr_get_element_element(element);
+      slot = GROUP_INDEX_HASH(element_id, bits);
+      while (group->index[slot] != NULL &&
+             acr_get_element_element(group->index[slot]) != element_id) {
+         slot = (slot + 1) & mask;
+      }
+      if (group->index[slot] == NULL) {
+         group->index[slot] = element;
+      }
+   }
+
+   group->index_valid = TRUE;
+   group->index_generation = acr_get_element_id_generation();
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : find_indexed_element
+@INPUT      : group
+              element_id
+@OUTPUT     : (none)
+@RETURNS    : element pointer or NULL if not found
+@DESCRIPTION: Finds an element of a group through its hash index, building
+              the index first if it is missing or out of date.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static Acr_Element find_indexed_element(Acr_Group group, int element_id)
+{
+   int slot, mask;
+   Acr_Element element;
+
+   /* Elements are added and removed through the group, but may be 
+      renamed directly */
+   if (!group->index_valid ||
+       group->index_generation != acr_get_element_id_generation()) {
+      build_group_index(group);
+   }
+
+   /* Probe from the hashed slot until we find the id or an empty slot */
+   mask = (1 << group->index_bits) - 1;
+   slot = GROUP_INDEX_HASH(element_id, group->index_bits);
+   while ((element = group->index[slot]) != NULL) {
+      if (acr_get_element_element(element) == element_id)
+         return element;
+      slot = (slot + 1) & mask;
+   }
+
+   return NULL;
 
 }
 
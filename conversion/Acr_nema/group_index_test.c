@@ -0,0 +1,382 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : group_index_test.c
+@DESCRIPTION: Program to time element lookups in a group list, comparing
+              acr_find_group_element with a linear search of each group.
+              The group list is read from a file, or a large synthetic
+              list is built if no file is given. Both searches must return
+              the same elements, also after elements are inserted, removed
+              and renamed.
+@METHOD     :
+@GLOBALS    :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <acr_nema.h>
+
+/* Size of the synthetic group list */
+#define SYNTHETIC_GROUPS 8
+#define SYNTHETIC_ELEMENTS 2000
+
+/* Minimum number of lookups to time */
+#define MIN_LOOKUPS 1000000L
+
+static Acr_Group create_synthetic_group_list(void);
+static long time_lookups(Acr_Group group_list, int indexed, int npasses,
+                         double *seconds);
+static Acr_Element find_linear(Acr_Group group_list,
+                               struct Acr_Element_Id *elid);
+static int check_lookups(Acr_Group group_list);
+static int check_updates(Acr_Group group_list);
+static Acr_Element find_gap(Acr_Group group);
+
+int main(int argc, char *argv[])
+{
+   char *pname, *filename;
+   FILE *fp;
+   Acr_File *afp;
+   Acr_Group group_list, group;
+   int nelements, npasses, nerrors;
+   long nfound_linear, nfound_indexed;
+   double linear_time, indexed_time;
+
+   /* Check arguments */
+   pname = argv[0];
+   if ((argc > 2) || (argc < 1)) {
+      (void) fprintf(stderr, "Usage: %s [<file>]\n", pname);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Get file name */
+   if (argc == 2)
+      filename = argv[1];
+   else
+      filename = NULL;
+
+   /* Read the group list or make one up */
+   if (filename != NULL) {
+      fp = fopen(filename, "r");
+      if (fp == NULL) {
+         (void) fprintf(stderr, "%s: Error opening file %s\n",
+                        pname, filename);
+         exit(EXIT_FAILURE);
+      }
+      afp=acr_file_initialize(fp, 0, acr_stdio_read);
+      (void) acr_test_dicom_file(afp);
+      (void) acr_input_group_list(afp, &group_list, 0);
+      acr_file_free(afp);
+      (void) fclose(fp);
+   }
+   else {
+      group_list = create_synthetic_group_list();
+   }
+   if (group_list == NULL) {
+      (void) fprintf(stderr, "%s: No groups read\n", pname);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Work out how many passes to make over the list. Each pass looks up
+      every element and one missing id per element */
+   nelements = 0;
+   for (group = group_list; group != NULL; group = acr_get_group_next(group))
+      nelements += acr_get_group_nelements(group);
+   npasses = MIN_LOOKUPS / (2 * nelements) + 1;
+
+   /* Time the lookups both ways */
+   nfound_linear = time_lookups(group_list, FALSE, npasses, &linear_time);
+   nfound_indexed = time_lookups(group_list, TRUE, npasses, &indexed_time);
+   if (nfound_linear != nfound_indexed) {
+      (void) fprintf(stderr, "%s: Linear search found %ld elements, "
+                     "indexed search found %ld\n",
+                     pname, nfound_linear, nfound_indexed);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Check that the index finds the same elements as the linear search,
+      and that it keeps up with changes to the groups */
+   nerrors = check_lookups(group_list) + check_updates(group_list);
+   if (nerrors > 0) {
+      (void) fprintf(stderr, "%s: %d lookups did not match the linear search\n",
+                     pname, nerrors);
+      exit(EXIT_FAILURE);
+   }
+
+   (void) printf("%d elements, %d passes\n", nelements, npasses);
+   (void) printf("linear:  %.3f s (%.1f ns per lookup)\n", linear_time,
+                 linear_time * 1.0e9 / (2.0 * nelements * npasses));
+   (void) printf("indexed: %.3f s (%.1f ns per lookup)\n", indexed_time,
+                 indexed_time * 1.0e9 / (2.0 * nelements * npasses));
+
+   acr_delete_group_list(group_list);
+
+   exit(EXIT_SUCCESS);
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_synthetic_group_list
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : group list
+@DESCRIPTION: Builds a group list with many elements per group, as found
+              in files with per-frame information.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static Acr_Group create_synthetic_group_list(void)
+{
+   Acr_Group group_list, group, last;
+   struct Acr_Element_Id elid;
+   int igroup, ielement;
+
+   group_list = last = NULL;
+   for (igroup = 0; igroup < SYNTHETIC_GROUPS; igroup++) {
+      group = acr_create_group(0x0009 + 2 * igroup);
+      elid.group_id = acr_get_group_group(group);
+      elid.vr_code = ACR_VR_US;
+      for (ielement = 1; ielement <= SYNTHETIC_ELEMENTS; ielement++) {
+         elid.element_id = 0x10 * ielement;
+         (void) acr_group_add_element(group,
+            acr_create_element_short(&elid, (Acr_Short) ielement));
+      }
+      if (last == NULL)
+         group_list = group;
+      else
+         acr_set_group_next(last, group);
+      last = group;
+   }
+
+   return group_list;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : time_lookups
+@INPUT      : group_list
+              indexed - TRUE to use acr_find_group_element, FALSE to
+                 search each element list
+              npasses - number of passes over the group list
+@OUTPUT     : seconds - processor time taken
+@RETURNS    : number of elements found
+@DESCRIPTION: Looks up every element of a group list, along with an id
+              just after each one that is usually missing.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static long time_lookups(Acr_Group group_list, int indexed, int npasses,
+                         double *seconds)
+{
+   Acr_Group group;
+   Acr_Element element, found;
+   struct Acr_Element_Id elid;
+   int ipass, offset;
+   long nfound;
+   clock_t start;
+
+   nfound = 0;
+   elid.vr_code = ACR_VR_UNKNOWN;
+   start = clock();
+   for (ipass = 0; ipass < npasses; ipass++) {
+      for (group = group_list; group != NULL;
+           group = acr_get_group_next(group)) {
+         elid.group_id = acr_get_group_group(group);
+         for (element = acr_get_group_element_list(group); element != NULL;
+              element = acr_get_element_next(element)) {
+            for (offset = 0; offset <= 1; offset++) {
+               elid.element_id = acr_get_element_element(element) + offset;
+               if (indexed) {
+                  found = acr_find_group_element(group_list, &elid);
+               }
+               else {
+                  found = acr_find_element_id(
+                     acr_get_group_element_list(
+                        acr_find_group(group_list, elid.group_id)), &elid);
+               }
+               if (found != NULL) nfound++;
+            }
+         }
+      }
+   }
+   *seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+   return nfound;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : find_linear
+@INPUT      : group_list
+              elid - id of element to find
+@OUTPUT     : (none)
+@RETURNS    : element, or NULL if not found
+@DESCRIPTION: Finds an element by searching the element list of its group.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static Acr_Element find_linear(Acr_Group group_list,
+                               struct Acr_Element_Id *elid)
+{
+   return acr_find_element_id(
+      acr_get_group_element_list(acr_find_group(group_list, elid->group_id)),
+      elid);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : check_lookups
+@INPUT      : group_list
+@OUTPUT     : (none)
+@RETURNS    : number of lookups that gave different elements
+@DESCRIPTION: Looks up every element of a group list, and the id just after
+              each one, with acr_find_group_element and with a linear
+              search, and checks that both return the same element.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static int check_lookups(Acr_Group group_list)
+{
+   Acr_Group group;
+   Acr_Element element;
+   struct Acr_Element_Id elid;
+   int offset, nerrors;
+
+   nerrors = 0;
+   elid.vr_code = ACR_VR_UNKNOWN;
+   for (group = group_list; group != NULL;
+        group = acr_get_group_next(group)) {
+      elid.group_id = acr_get_group_group(group);
+      for (element = acr_get_group_element_list(group); element != NULL;
+           element = acr_get_element_next(element)) {
+         for (offset = 0; offset <= 1; offset++) {
+            elid.element_id = acr_get_element_element(element) + offset;
+            if (acr_find_group_element(group_list, &elid) !=
+                find_linear(group_list, &elid)) {
+               (void) fprintf(stderr, "Lookup of (%04x,%04x) is wrong\n",
+                              elid.group_id, elid.element_id);
+               nerrors++;
+            }
+         }
+      }
+   }
+
+   return nerrors;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : find_gap
+@INPUT      : group
+@OUTPUT     : (none)
+@RETURNS    : element whose id plus one is not in the group
+@DESCRIPTION: Finds an element that a new id can follow without changing
+              the order of the group.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static Acr_Element find_gap(Acr_Group group)
+{
+   Acr_Element element, next;
+
+   for (element = acr_get_group_element_list(group); element != NULL;
+        element = next) {
+      next = acr_get_element_next(element);
+      if ((next == NULL) || (acr_get_element_element(next) >
+                             acr_get_element_element(element) + 1))
+         break;
+   }
+
+   return element;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : check_updates
+@INPUT      : group_list
+@OUTPUT     : (none)
+@RETURNS    : number of lookups that gave the wrong element
+@DESCRIPTION: Inserts, removes and renames an element in the largest group,
+              which has an index if any group does, and checks the lookups
+              after each change. Each change is made after a full round of
+              lookups, so that the index is up to date beforehand.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static int check_updates(Acr_Group group_list)
+{
+   Acr_Group group, largest;
+   Acr_Element element;
+   struct Acr_Element_Id elid;
+   int nerrors, old_id;
+
+   /* Find the largest group */
+   largest = group_list;
+   for (group = group_list; group != NULL;
+        group = acr_get_group_next(group)) {
+      if (acr_get_group_nelements(group) > acr_get_group_nelements(largest))
+         largest = group;
+   }
+   if (acr_get_group_nelements(largest) < 2)
+      return 0;
+
+   nerrors = check_lookups(group_list);
+   elid.group_id = acr_get_group_group(largest);
+   elid.vr_code = ACR_VR_US;
+
+   /* Insert a new element between two existing ones */
+   elid.element_id = acr_get_element_element(find_gap(largest)) + 1;
+   element = acr_create_element_short(&elid, (Acr_Short) 1);
+   (void) acr_group_insert_element(largest, element);
+   if (acr_find_group_element(group_list, &elid) != element) {
+      (void) fprintf(stderr, "Inserted element (%04x,%04x) not found\n",
+                     elid.group_id, elid.element_id);
+      nerrors++;
+   }
+   nerrors += check_lookups(group_list);
+
+   /* Remove the first element */
+   elid.element_id =
+      acr_get_element_element(acr_get_group_element_list(largest));
+   acr_group_remove_element(largest, elid.element_id);
+   if (acr_find_group_element(group_list, &elid) != NULL) {
+      (void) fprintf(stderr, "Removed element (%04x,%04x) still found\n",
+                     elid.group_id, elid.element_id);
+      nerrors++;
+   }
+   nerrors += check_lookups(group_list);
+
+   /* Rename an element in place */
+   element = find_gap(largest);
+   old_id = acr_get_element_element(element);
+   acr_set_element_id(element, elid.group_id, old_id + 1);
+   elid.element_id = old_id + 1;
+   if (acr_find_group_element(group_list, &elid) != element) {
+      (void) fprintf(stderr, "Renamed element (%04x,%04x) not found\n",
+                     elid.group_id, elid.element_id);
+      nerrors++;
+   }
+   elid.element_id = old_id;
+   if (acr_find_group_element(group_list, &elid) != NULL) {
+      (void) fprintf(stderr, "Old id (%04x,%04x) of renamed element found\n",
+                     elid.group_id, elid.element_id);
+      nerrors++;
+   }
+   nerrors += check_lookups(group_list);
+
+   return nerrors;
+}
@@ -150,6 +150,51 @@
 #include <dirent.h>
 #endif
 #include <ParseArgv.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#if HAVE_PTHREAD
+/* Files are read ahead of the parser by a pool of threads, so that the
+ * parser (which has to stay on one thread, as the acr_nema library is not
+ * thread-safe) finds them in the system's cache.
+ */
+#define PREFETCH_FILES_PER_THREAD 4 /* Files to read ahead per thread */
+#define PREFETCH_MAX_BYTES (1024 * 1024) /* Most of a file to read ahead */
+#define PREFETCH_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+    char **file_list;           /* Copy of the list of files */
+    char *file_done;            /* TRUE for each file read ahead */
+    int num_files;
+    int next_file;              /* Next file to read ahead */
+    int parsed_files;           /* Number of files parsed so far */
+    int max_ahead;              /* Most files to read ahead of the parser */
+    int num_threads;
+    pthread_t *threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} Prefetch_Info;
+#endif /* HAVE_PTHREAD */
+
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+/* A series converted by a child process. The output of the child is
+ * captured so that the output of each series can be printed in order.
+ */
+typedef struct {
+    pid_t pid;                  /* Child process, or 0 once finished */
+    int num_files;              /* Number of files in the series */
+    FILE *output_fp;            /* Where the child's output goes */
+    char *output;               /* Output of the finished child */
+    int exit_status;
+} Series_Job;
+#endif /* HAVE_WORKING_FORK && HAVE_SYS_WAIT_H */
 
 /* Function Prototypes */
 static int dcm_sort_function(const void *entry1, const void *entry2);
@@ -161,6 +206,12 @@ static void free_list(int num_files,
                       char **file_list, 
                       Data_Object_Info **file_info_list);
 static int check_file_type_consistency(int num_files, char **file_list);
+#if HAVE_PTHREAD
+static void start_prefetch(Prefetch_Info *pf, int num_files, 
+                           char **file_list, int num_threads);
+static void wait_prefetch(Prefetch_Info *pf, int ifile);
+static void stop_prefetch(Prefetch_Info *pf);
+#endif
 
 
 struct globals G;
@@ -252,6 +303,12 @@ ArgvInfo argTable[] = {
      (char *) &G.abort_on_error,
      "Stop processing immediately if a file is not parsed properly."},
 
+    {"-threads",
+     ARGV_INT,
+     (char *) 1,
+     (char *) &G.num_threads,
+     "Number of files to read and series to convert at once."},
+
     {NULL, ARGV_END, NULL, NULL, NULL}
 
 };
@@ -261,6 +318,7 @@ main(int argc, char *argv[])
 {
     int ifile;
     Acr_Group group_list;
+    Dicom_Header header;        /* Header of the current file */
     char **file_list;           /* List of file names */
     Data_Object_Info **file_info_list;
     int num_file_args;          /* Number of files on command line */
@@ -271,6 +329,9 @@ main(int argc, char *argv[])
     struct stat st;
     int length;
     int exit_status;
+#if HAVE_PTHREAD
+    Prefetch_Info prefetch;     /* Threads reading files ahead */
+#endif
 
     G.mosaic_seq = MOSAIC_SEQ_UNKNOWN; /* Assume ascending by default. */
     G.splitDynScan = FALSE;     /* Don't split dynamic scans by default */
@@ -282,6 +343,8 @@ main(int argc, char *argv[])
     G.minc_history = time_stamp(argc, argv); /* Create minc history string */
     G.prefer_coords = FALSE;
     G.abort_on_error = FALSE;
+    G.num_threads = 1;
+    G.no_progress = FALSE;
 
     G.pname = argv[0];          /* get program name */
     
@@ -295,6 +358,17 @@ main(int argc, char *argv[])
         usage();
     }
 
+    if (G.num_threads < 1) {
+        fprintf(stderr, "Number of threads must be at least 1.\n");
+        exit(EXIT_FAILURE);
+    }
+#if !HAVE_PTHREAD && !(HAVE_WORKING_FORK && HAVE_SYS_WAIT_H)
+    if (G.num_threads > 1) {
+        fprintf(stderr, "Warning: no thread support, ignoring -threads.\n");
+        G.num_threads = 1;
+    }
+#endif
+
     if (G.List) {
         num_file_args = argc - 1; /* Assume no directory given. */
     }
@@ -425,23 +499,30 @@ main(int argc, char *argv[])
     /* Now loop over all files, getting basic info on each
      */
 
+#if HAVE_PTHREAD
+    if (G.num_threads > 1) {
+        start_prefetch(&prefetch, num_files, file_list, G.num_threads);
+    }
+#endif
+
     num_files_ok = 0;
     for (ifile = 0; ifile < num_files; ifile++) {
         char *cur_fname_ptr = file_list[ifile];
 
+#if HAVE_PTHREAD
+        if (G.num_threads > 1) {
+            wait_prefetch(&prefetch, ifile);
+        }
+#endif
+
         if (!G.Debug) {
             sprintf(message, "Parsing %d files", num_files);
             progress(ifile, num_files, message);
         }
 
-        if (G.file_type == IMA) {
-            group_list = siemens_to_dicom(cur_fname_ptr, ACR_IMAGE_GID - 1);
-        }
-        else {
-            /* read up to but not including pixel data
-             */
-            group_list = read_numa4_dicom(cur_fname_ptr, ACR_IMAGE_GID - 1);
-        } 
+        /* read up to but not including pixel data
+         */
+        group_list = read_dicom_header(cur_fname_ptr, &header);
 
         if (group_list == NULL) {
             /* This file appears to be invalid - it is probably a dicomdir
@@ -469,13 +550,24 @@ main(int argc, char *argv[])
              */
             file_info_list[num_files_ok]->file_name = strdup(file_list[num_files_ok]);
 
-            /* Delete the group list now that we're done with it
+            /* Keep the group list so that dicom_to_minc need not read
+             * the header again, unless we are only listing the files.
              */
-            acr_delete_group_list(group_list);
+            if (G.List) {
+                acr_delete_group_list(group_list);
+                header.group_list = NULL;
+            }
+            file_info_list[num_files_ok]->header = header;
             num_files_ok++;
         }
     } /* end of loop over files to get basic info */
 
+#if HAVE_PTHREAD
+    if (G.num_threads > 1) {
+        stop_prefetch(&prefetch);
+    }
+#endif
+
     if (G.Debug) {
         printf("Using %d files\n", num_files_ok);
     }
@@ -598,12 +690,192 @@ free_list(int num_files,
             free(file_list[i]);
         }
         if (file_info_list[i] != NULL) {
+            if (file_info_list[i]->header.group_list != NULL) {
+                acr_delete_group_list(file_info_list[i]->header.group_list);
+            }
             free(file_info_list[i]->file_name);
             free(file_info_list[i]);
         }
     }
 }
 
+#if HAVE_PTHREAD
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : prefetch_thread
+@INPUT      : arg - prefetch information
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Thread that reads files a little ahead of the parser, so
+              that the time spent opening and reading them (which can be
+              long on network storage) overlaps with the parsing.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *
+prefetch_thread(void *arg)
+{
+    Prefetch_Info *pf = arg;
+    char *buffer;
+    FILE *fp;
+    int ifile;
+    long nread;
+    size_t nbytes;
+
+    buffer = malloc(PREFETCH_CHUNK_SIZE);
+    CHKMEM(buffer);
+
+    for (;;) {
+        /* Get the next file, staying within reach of the parser */
+        pthread_mutex_lock(&pf->mutex);
+        while (pf->next_file < pf->num_files &&
+               pf->next_file - pf->parsed_files >= pf->max_ahead) {
+            pthread_cond_wait(&pf->cond, &pf->mutex);
+        }
+        ifile = pf->next_file;
+        if (ifile < pf->num_files) {
+            pf->next_file++;
+        }
+        pthread_mutex_unlock(&pf->mutex);
+        if (ifile >= pf->num_files) {
+            break;
+        }
+
+        /* Read it, throwing the data away */
+        if ((fp = fopen(pf->file_list[ifile], "rb")) != NULL) {
+            nread = 0;
+            while (nread < PREFETCH_MAX_BYTES &&
+                   (nbytes = fread(buffer, 1, PREFETCH_CHUNK_SIZE, fp)) > 0) {
+                nread += nbytes;
+            }
+            fclose(fp);
+        }
+
+        pthread_mutex_lock(&pf->mutex);
+        pf->file_done[ifile] = TRUE;
+        pthread_cond_broadcast(&pf->cond);
+        pthread_mutex_unlock(&pf->mutex);
+    }
+
+    free(buffer);
+    return NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_prefetch
+@INPUT      : num_files - number of files
+              file_list - names of the files, in the order they are parsed
+              num_threads - number of threads to start
+@OUTPUT     : pf - prefetch information
+@RETURNS    : (nothing)
+@DESCRIPTION: Starts threads reading the files ahead of the parser.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void
+start_prefetch(Prefetch_Info *pf, int num_files, char **file_list,
+               int num_threads)
+{
+    int ithread;
+
+    /* The parser changes its list as it goes, so keep our own */
+    pf->file_list = malloc((num_files + 1) * sizeof(*pf->file_list));
+    CHKMEM(pf->file_list);
+    memcpy(pf->file_list, file_list, num_files * sizeof(*pf->file_list));
+    pf->file_done = calloc(num_files + 1, sizeof(*pf->file_done));
+    CHKMEM(pf->file_done);
+
+    pf->num_files = num_files;
+    pf->next_file = 0;
+    pf->parsed_files = 0;
+    pf->max_ahead = num_threads * PREFETCH_FILES_PER_THREAD;
+
+    pthread_mutex_init(&pf->mutex, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+
+    pf->threads = malloc(num_threads * sizeof(*pf->threads));
+    CHKMEM(pf->threads);
+    pf->num_threads = 0;
+    for (ithread = 0; ithread < num_threads; ithread++) {
+        if (pthread_create(&pf->threads[ithread], NULL, prefetch_thread,
+                           pf) != 0) {
+            break;
+        }
+        pf->num_threads++;
+    }
+
+    /* Without any threads, there is nothing to wait for */
+    if (pf->num_threads == 0) {
+        memset(pf->file_done, TRUE, num_files);
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : wait_prefetch
+@INPUT      : pf - prefetch information
+              ifile - file about to be parsed
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Waits until a file has been read ahead, and lets the threads
+              move on past it.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void
+wait_prefetch(Prefetch_Info *pf, int ifile)
+{
+    pthread_mutex_lock(&pf->mutex);
+    pf->parsed_files = ifile;
+    pthread_cond_broadcast(&pf->cond);
+    while (!pf->file_done[ifile]) {
+        pthread_cond_wait(&pf->cond, &pf->mutex);
+    }
+    pthread_mutex_unlock(&pf->mutex);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stop_prefetch
+@INPUT      : pf - prefetch information
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Waits for the prefetch threads to finish and frees up
+              everything.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void
+stop_prefetch(Prefetch_Info *pf)
+{
+    int ithread;
+
+    pthread_mutex_lock(&pf->mutex);
+    pf->parsed_files = pf->num_files;
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->mutex);
+
+    for (ithread = 0; ithread < pf->num_threads; ithread++) {
+        pthread_join(pf->threads[ithread], NULL);
+    }
+
+    pthread_cond_destroy(&pf->cond);
+    pthread_mutex_destroy(&pf->mutex);
+    free(pf->threads);
+    free(pf->file_done);
+    free(pf->file_list);
+}
+#endif /* HAVE_PTHREAD */
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : dcm_sort_function
 @INPUT      : entry1
@@ -676,6 +948,427 @@ usage(void)
     exit(EXIT_FAILURE);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : convert_series
+@INPUT      : acq_num_files - number of files in the series
+              acq_file_list - names of the files
+              acq_header_list - cached headers of the files
+              acq_file_index - index of each file in di_ptr
+              di_ptr - information on all of the files
+              file_prefix - output directory
+@OUTPUT     : (none)
+@RETURNS    : EXIT_SUCCESS or EXIT_FAILURE
+@DESCRIPTION: Checks the information on a series, converts it to a MINC
+              file and applies the user's command to the result.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int
+convert_series(int acq_num_files,
+               const char *acq_file_list[],
+               Dicom_Header *acq_header_list[],
+               const int acq_file_index[],
+               Data_Object_Info *di_ptr[],
+               const char *file_prefix)
+{
+    int ifile;
+    int exit_status;
+    const char *output_file_name;
+#if HAVE_POPEN
+    string_t string;
+    FILE *fp;
+#endif
+    int trust_location;
+    int trust_coord;
+    int user_opts;              /* Options as set by user. We may override.. */
+
+    /* Do some sanity checks on the acquisition.  In particular, we 
+     * verify that the coordinate and/or slice location information
+     * looks reliable.
+     */
+    trust_location = 1;
+    trust_coord = 1;
+
+    for (ifile = 0; ifile < acq_num_files; ifile++) {
+        int jfile;
+        int ix = acq_file_index[ifile];
+
+        if (!di_ptr[ix]->coord_found) {
+            trust_coord = 0;
+        }
+
+        for (jfile = ifile + 1; jfile < acq_num_files; jfile++) {
+            int jx = acq_file_index[jfile];
+
+            if (NEARLY_EQUAL(di_ptr[ix]->slice_location,
+                             di_ptr[jx]->slice_location)) {
+                trust_location = 0;
+            }
+        }
+    }
+
+    /* We also check whether the acquisition number (0x0020, 0x0012) 
+     * and image number (0x0020, 0x0013) are informative or not. 
+     * They are sometimes absent, constant, or otherwise strange.
+     * Determining this ahead of time helps us make good decisions
+     * about how to treat these fields later.
+     */
+    G.max_acq_num = INT_MIN;
+    G.min_acq_num = INT_MAX;
+    G.max_img_num = INT_MIN;
+    G.min_img_num = INT_MAX;
+
+    for (ifile = 0; ifile < acq_num_files; ifile++) {
+      int ix = acq_file_index[ifile];
+
+      if (di_ptr[ix]->dyn_scan_number < G.min_acq_num) {
+        G.min_acq_num = di_ptr[ix]->dyn_scan_number;
+      }
+      if (di_ptr[ix]->dyn_scan_number > G.max_acq_num) {
+        G.max_acq_num = di_ptr[ix]->dyn_scan_number;
+      }
+
+      if (di_ptr[ix]->global_image_number < G.min_img_num) {
+        G.min_img_num = di_ptr[ix]->global_image_number;
+      }
+      if (di_ptr[ix]->global_image_number > G.max_img_num) {
+        G.max_img_num = di_ptr[ix]->global_image_number;
+      }
+    }
+
+    user_opts = G.opts;
+
+    if (!trust_coord) {
+        printf("WARNING: Image coordinates absent or incomplete.\n");
+        if (!trust_location) {
+            printf("WARNING: Slice location is untrustworthy.\n");
+            G.opts |= OPTS_NO_LOCATION;
+        }
+    }
+
+    if (G.min_acq_num == G.max_acq_num) {
+      printf("WARNING: Acquisition number is not informative.\n");
+    }
+    else {
+      int ix = acq_file_index[0];
+      if (G.max_acq_num == di_ptr[ix]->num_dyn_scans) {
+        /* Acquisition number is per scan (e.g. time).
+         */
+        printf("WARNING: Acquisition number is per scan.\n");
+      }
+      else if (G.max_acq_num == di_ptr[ix]->num_slices_nominal * di_ptr[ix]->num_dyn_scans) {
+        printf("WARNING: Acquisition number is global.\n");
+      }
+      else {
+        printf("WARNING: Acquisition number is a mystery.\n");
+      }
+          
+    }
+
+    if (G.min_img_num == G.max_img_num) {
+      /* Acquisition number is uninformative.
+       */
+      printf("WARNING: Image number is not informative.\n");
+    }
+    else {
+      int ix = acq_file_index[0];
+
+      if (G.max_img_num == di_ptr[ix]->num_slices_nominal) {
+        printf("WARNING: Image number is per slice.\n");
+      }
+      else if (G.max_img_num == di_ptr[ix]->num_slices_nominal * di_ptr[ix]->num_dyn_scans) {
+        printf("WARNING: Image number is global.\n");
+      }
+      else {
+        printf("WARNING: Image number is a mystery.\n");
+      }
+    }
+
+    if (G.min_acq_num < 0 || G.min_acq_num > 1) {
+      printf("WARNING: Minimum acquisition number is %d\n", G.min_acq_num);
+    }
+
+    if (G.min_img_num < 0 || G.min_img_num > 1) {
+      printf("WARNING: Minimum image number is %d\n", G.min_img_num);
+    }
+    
+    printf("INFO: Acquisition number ranges from %d to %d\n", G.min_acq_num, G.max_acq_num);
+    printf("INFO: Image number ranges from %d to %d\n", G.min_img_num, G.max_img_num);
+
+
+    /* Create minc file
+     */
+    exit_status = dicom_to_minc(acq_num_files, 
+                                acq_file_list, 
+                                acq_header_list,
+                                NULL,
+                                G.clobber, 
+                                file_prefix, 
+                                &output_file_name);
+				    
+    G.opts = user_opts;
+   
+    if (exit_status != EXIT_SUCCESS) 
+        return (exit_status);
+
+    /* Print log message */
+    if (G.Debug) {
+        printf("Created minc file %s.\n", output_file_name);
+    }
+
+#if HAVE_POPEN       
+    /* Invoke a command on the file (if requested) and get the 
+     * returned file name 
+     */
+    if (G.command_line != NULL && *G.command_line != '\0') {
+        sprintf(string, "%s %s", G.command_line, output_file_name);
+        printf("-Applying command '%s' to output file...  ", 
+               G.command_line);
+        fflush(stdout);
+        if ((fp = popen(string, "r")) != NULL) {
+            char pipe_output_name[256];
+            fscanf(fp, "%s", pipe_output_name);
+            if (pclose(fp) != EXIT_SUCCESS) {
+                fprintf(stderr, 
+                        "Error executing command\n   \"%s\"\n",
+                        string);
+            }
+            else if (G.Debug) {
+                printf("Executed command \"%s\",\nproducing file %s.\n",
+                       string, pipe_output_name);
+            }
+        }
+        else {
+            fprintf(stderr, "Error executing command \"%s\"\n", string);
+        }
+        printf("Done.\n");
+    }
+#endif /* HAVE_POPEN */
+
+    return (exit_status);
+}
+
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_series_job_output
+@INPUT      : job - a finished job
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Reads back what a finished job printed into job->output and
+              closes its temporary file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void
+read_series_job_output(Series_Job *job)
+{
+    long length;
+
+    fseek(job->output_fp, 0, SEEK_END);
+    length = ftell(job->output_fp);
+    rewind(job->output_fp);
+    job->output = malloc(length + 1);
+    CHKMEM(job->output);
+    length = fread(job->output, 1, length, job->output_fp);
+    job->output[length] = '\0';
+    fclose(job->output_fp);
+    job->output_fp = NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_series_job
+@INPUT      : acq_num_files, acq_file_list, acq_header_list, acq_file_index,
+              di_ptr, file_prefix - as for convert_series
+@OUTPUT     : job - the job started
+@RETURNS    : FALSE if there is nowhere to keep the output of the series,
+              in which case nothing is done
+@DESCRIPTION: Forks a child process to convert a series, with its output
+              going to a temporary file. If no child can be started, the
+              series is converted in this process instead, still with its
+              output going to the temporary file, and job->pid is set
+              to 0.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int
+start_series_job(Series_Job *job,
+                 int acq_num_files,
+                 const char *acq_file_list[],
+                 Dicom_Header *acq_header_list[],
+                 const int acq_file_index[],
+                 Data_Object_Info *di_ptr[],
+                 const char *file_prefix)
+{
+    int stdout_fd;
+    int stderr_fd;
+    int no_progress;
+
+    job->num_files = acq_num_files;
+    job->output = NULL;
+    job->exit_status = EXIT_FAILURE;
+
+    job->output_fp = tmpfile();
+    if (job->output_fp == NULL) {
+        return FALSE;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    job->pid = fork();
+
+    if (job->pid == 0) {        /* Child process */
+        dup2(fileno(job->output_fp), STDOUT_FILENO);
+        dup2(fileno(job->output_fp), STDERR_FILENO);
+        G.no_progress = TRUE;
+        exit(convert_series(acq_num_files, acq_file_list, acq_header_list,
+                            acq_file_index, di_ptr, file_prefix));
+    }
+    else if (job->pid < 0) {    /* Error forking */
+        fprintf(stderr, "Error forking child to create minc file\n");
+        job->pid = 0;
+
+        /* Convert the series here, sending the output to the same place
+         * the child's would have gone
+         */
+        stdout_fd = dup(STDOUT_FILENO);
+        stderr_fd = dup(STDERR_FILENO);
+        dup2(fileno(job->output_fp), STDOUT_FILENO);
+        dup2(fileno(job->output_fp), STDERR_FILENO);
+        no_progress = G.no_progress;
+        G.no_progress = TRUE;
+
+        job->exit_status = convert_series(acq_num_files, acq_file_list, 
+                                          acq_header_list, acq_file_index,
+                                          di_ptr, file_prefix);
+
+        G.no_progress = no_progress;
+        fflush(stdout);
+        fflush(stderr);
+        dup2(stdout_fd, STDOUT_FILENO);
+        dup2(stderr_fd, STDERR_FILENO);
+        close(stdout_fd);
+        close(stderr_fd);
+
+        read_series_job_output(job);
+    }
+    return TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : wait_series_job
+@INPUT      : jobs - jobs started so far
+              num_jobs - number of jobs
+@OUTPUT     : (none)
+@RETURNS    : the job that finished
+@DESCRIPTION: Waits for one of the children to finish, and collects its
+              exit status and output.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static Series_Job *
+wait_series_job(Series_Job jobs[], int num_jobs)
+{
+    Series_Job *job;
+    pid_t pid;
+    int status;
+    int ijob;
+
+    /* Wait for one of our children */
+    for (;;) {
+        pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            fprintf(stderr, "Error waiting for child processes\n");
+            exit(EXIT_FAILURE);
+        }
+        for (ijob = 0; ijob < num_jobs; ijob++) {
+            if (jobs[ijob].pid == pid) {
+                break;
+            }
+        }
+        if (ijob < num_jobs) {
+            break;
+        }
+    }
+
+    job = &jobs[ijob];
+    job->pid = 0;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+        job->exit_status = EXIT_SUCCESS;
+    }
+    else {
+        job->exit_status = EXIT_FAILURE;
+    }
+
+    /* Read back what the child printed */
+    read_series_job_output(job);
+
+    return job;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : print_series_jobs
+@INPUT      : jobs - jobs started so far
+              num_jobs - number of jobs
+              num_printed - number of jobs whose output has been printed
+              exit_status - exit status so far
+@OUTPUT     : num_printed - updated
+@RETURNS    : exit status of the last job printed
+@DESCRIPTION: Prints the output of every finished job that comes after the
+              ones printed already, stopping at the first job that is
+              still running, so that the series are reported in order
+              as soon as possible.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int
+print_series_jobs(Series_Job jobs[], int num_jobs, int *num_printed,
+                  int exit_status)
+{
+    Series_Job *job;
+
+    while (*num_printed < num_jobs && jobs[*num_printed].pid == 0) {
+        job = &jobs[(*num_printed)++];
+        if (job->output != NULL) {
+            fputs(job->output, stdout);
+            free(job->output);
+            job->output = NULL;
+        }
+        exit_status = job->exit_status;
+    }
+    fflush(stdout);
+    return exit_status;
+}
+
+/* Advances the progress bar over the files of a finished series.
+ */
+static void
+series_job_progress(const Series_Job *job, int *num_files_done, int num_files)
+{
+    int ifile;
+
+    if (!G.Debug) {
+        for (ifile = 0; ifile < job->num_files; ifile++) {
+            progress((*num_files_done)++, num_files, "-Converting series");
+        }
+    }
+}
+#endif /* HAVE_WORKING_FORK && HAVE_SYS_WAIT_H */
+
 static int
 use_the_files(int num_files, 
               Data_Object_Info *di_ptr[],
@@ -684,6 +1377,7 @@ use_the_files(int num_files,
     int ifile;
     int acq_num_files;
     const char **acq_file_list;
+    Dicom_Header **acq_header_list;
     int *used_file;
     int *acq_file_index;
     double cur_study_id;
@@ -696,13 +1390,15 @@ use_the_files(int num_files,
     string_t cur_patient_id;
     string_t cur_sequence_name;
     int exit_status;
-    const char *output_file_name;
     string_t file_prefix;
-    string_t string;
-    FILE *fp;
-    int trust_location;
-    int trust_coord;
-    int user_opts;              /* Options as set by user. We may override.. */
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+    Series_Job *jobs;           /* Series converted by child processes */
+    Series_Job *job;
+    int num_jobs;
+    int num_running;            /* Number of children still running */
+    int num_printed;            /* Series whose output has been printed */
+    int num_files_done;         /* Files in finished series */
+#endif
 
     if (out_dir != NULL) {    /* if an output directory name has been 
                                * provided on the command line
@@ -728,9 +1424,28 @@ use_the_files(int num_files,
     acq_file_index = malloc(num_files * sizeof(*acq_file_index));
     CHKMEM(acq_file_index);
 
+    acq_header_list = malloc(num_files * sizeof(*acq_header_list));
+    CHKMEM(acq_header_list);
+
     used_file = malloc(num_files * sizeof(*used_file));
     CHKMEM(used_file);
 
+    exit_status = EXIT_SUCCESS;
+
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+    /* Convert several series at once in child processes if asked to
+     */
+    jobs = NULL;
+    num_jobs = 0;
+    num_running = 0;
+    num_printed = 0;
+    num_files_done = 0;
+    if (G.num_threads > 1 && !G.List) {
+        jobs = malloc(num_files * sizeof(*jobs));
+        CHKMEM(jobs);
+    }
+#endif
+
     for (ifile = 0; ifile < num_files; ifile++) {
         used_file[ifile] = FALSE;
     }
@@ -802,6 +1517,7 @@ use_the_files(int num_files,
                    counter) */
 
                 acq_file_list[acq_num_files] = di_ptr[ifile]->file_name;
+                acq_header_list[acq_num_files] = &di_ptr[ifile]->header;
                 acq_file_index[acq_num_files] = ifile;
                 acq_num_files++;
             }
@@ -833,171 +1549,85 @@ use_the_files(int num_files,
             }
         }
 
-        /* Do some sanity checks on the acquisition.  In particular, we 
-         * verify that the coordinate and/or slice location information
-         * looks reliable.
-         */
-        trust_location = 1;
-        trust_coord = 1;
-
-        for (ifile = 0; ifile < acq_num_files; ifile++) {
-            int jfile;
-            int ix = acq_file_index[ifile];
-
-            if (!di_ptr[ix]->coord_found) {
-                trust_coord = 0;
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+        if (jobs != NULL) {
+            /* Wait for a child to finish if enough are running already
+             */
+            while (num_running >= G.num_threads) {
+                job = wait_series_job(jobs, num_jobs);
+                num_running--;
+                series_job_progress(job, &num_files_done, num_files);
+                exit_status = print_series_jobs(jobs, num_jobs, &num_printed,
+                                                exit_status);
             }
 
-            for (jfile = ifile + 1; jfile < acq_num_files; jfile++) {
-                int jx = acq_file_index[jfile];
-
-                if (NEARLY_EQUAL(di_ptr[ix]->slice_location,
-                                 di_ptr[jx]->slice_location)) {
-                    trust_location = 0;
+            job = &jobs[num_jobs++];
+            if (!start_series_job(job, acq_num_files, acq_file_list, 
+                                  acq_header_list, acq_file_index, di_ptr,
+                                  file_prefix)) {
+                /* The output can't be kept, so print everything before
+                 * this series and then convert it here.
+                 */
+                while (num_running > 0) {
+                    series_job_progress(wait_series_job(jobs, num_jobs - 1),
+                                        &num_files_done, num_files);
+                    num_running--;
                 }
+                exit_status = print_series_jobs(jobs, num_jobs - 1, 
+                                                &num_printed, exit_status);
+                job->pid = 0;
+                job->exit_status = convert_series(acq_num_files, 
+                                                  acq_file_list,
+                                                  acq_header_list, 
+                                                  acq_file_index,
+                                                  di_ptr, file_prefix);
             }
-        }
-
-        /* We also check whether the acquisition number (0x0020, 0x0012) 
-         * and image number (0x0020, 0x0013) are informative or not. 
-         * They are sometimes absent, constant, or otherwise strange.
-         * Determining this ahead of time helps us make good decisions
-         * about how to treat these fields later.
-         */
-        G.max_acq_num = INT_MIN;
-        G.min_acq_num = INT_MAX;
-        G.max_img_num = INT_MIN;
-        G.min_img_num = INT_MAX;
-
-        for (ifile = 0; ifile < acq_num_files; ifile++) {
-          int ix = acq_file_index[ifile];
-
-          if (di_ptr[ix]->dyn_scan_number < G.min_acq_num) {
-            G.min_acq_num = di_ptr[ix]->dyn_scan_number;
-          }
-          if (di_ptr[ix]->dyn_scan_number > G.max_acq_num) {
-            G.max_acq_num = di_ptr[ix]->dyn_scan_number;
-          }
-
-          if (di_ptr[ix]->global_image_number < G.min_img_num) {
-            G.min_img_num = di_ptr[ix]->global_image_number;
-          }
-          if (di_ptr[ix]->global_image_number > G.max_img_num) {
-            G.max_img_num = di_ptr[ix]->global_image_number;
-          }
-        }
-
-        user_opts = G.opts;
-
-        if (!trust_coord) {
-            printf("WARNING: Image coordinates absent or incomplete.\n");
-            if (!trust_location) {
-                printf("WARNING: Slice location is untrustworthy.\n");
-                G.opts |= OPTS_NO_LOCATION;
+            if (job->pid > 0) {
+                num_running++;
+            }
+            else {
+                series_job_progress(job, &num_files_done, num_files);
+                exit_status = print_series_jobs(jobs, num_jobs, &num_printed,
+                                                exit_status);
             }
         }
-
-        if (G.min_acq_num == G.max_acq_num) {
-          printf("WARNING: Acquisition number is not informative.\n");
-        }
-        else {
-          int ix = acq_file_index[0];
-          if (G.max_acq_num == di_ptr[ix]->num_dyn_scans) {
-            /* Acquisition number is per scan (e.g. time).
-             */
-            printf("WARNING: Acquisition number is per scan.\n");
-          }
-          else if (G.max_acq_num == di_ptr[ix]->num_slices_nominal * di_ptr[ix]->num_dyn_scans) {
-            printf("WARNING: Acquisition number is global.\n");
-          }
-          else {
-            printf("WARNING: Acquisition number is a mystery.\n");
-          }
-              
-        }
-
-        if (G.min_img_num == G.max_img_num) {
-          /* Acquisition number is uninformative.
-           */
-          printf("WARNING: Image number is not informative.\n");
-        }
-        else {
-          int ix = acq_file_index[0];
-
-          if (G.max_img_num == di_ptr[ix]->num_slices_nominal) {
-            printf("WARNING: Image number is per slice.\n");
-          }
-          else if (G.max_img_num == di_ptr[ix]->num_slices_nominal * di_ptr[ix]->num_dyn_scans) {
-            printf("WARNING: Image number is global.\n");
-          }
-          else {
-            printf("WARNING: Image number is a mystery.\n");
-          }
-        }
-
-        if (G.min_acq_num < 0 || G.min_acq_num > 1) {
-          printf("WARNING: Minimum acquisition number is %d\n", G.min_acq_num);
-        }
-
-        if (G.min_img_num < 0 || G.min_img_num > 1) {
-          printf("WARNING: Minimum image number is %d\n", G.min_img_num);
+        else
+#endif /* HAVE_WORKING_FORK && HAVE_SYS_WAIT_H */
+        {
+            exit_status = convert_series(acq_num_files, acq_file_list,
+                                         acq_header_list, acq_file_index,
+                                         di_ptr, file_prefix);
         }
-        
-        printf("INFO: Acquisition number ranges from %d to %d\n", G.min_acq_num, G.max_acq_num);
-        printf("INFO: Image number ranges from %d to %d\n", G.min_img_num, G.max_img_num);
 
-
-        /* Create minc file
+        /* The headers of this series are no longer needed
          */
-        exit_status = dicom_to_minc(acq_num_files, 
-                                    acq_file_list, 
-                                    NULL,
-                                    G.clobber, 
-                                    file_prefix, 
-                                    &output_file_name);
-				    
-        G.opts = user_opts;
-       
-        if (exit_status != EXIT_SUCCESS) 
-            continue;
-
-        /* Print log message */
-        if (G.Debug) {
-            printf("Created minc file %s.\n", output_file_name);
+        for (ifile = 0; ifile < acq_num_files; ifile++) {
+            if (acq_header_list[ifile]->group_list != NULL) {
+                acr_delete_group_list(acq_header_list[ifile]->group_list);
+                acq_header_list[ifile]->group_list = NULL;
+            }
         }
+    }
 
-#if HAVE_POPEN       
-        /* Invoke a command on the file (if requested) and get the 
-         * returned file name 
+#if HAVE_WORKING_FORK && HAVE_SYS_WAIT_H
+    if (jobs != NULL) {
+        /* Wait for the remaining children, printing what each series
+         * had to say in order.
          */
-        if (G.command_line != NULL && *G.command_line != '\0') {
-            sprintf(string, "%s %s", G.command_line, output_file_name);
-            printf("-Applying command '%s' to output file...  ", 
-                   G.command_line);
-            fflush(stdout);
-            if ((fp = popen(string, "r")) != NULL) {
-                char pipe_output_name[256];
-                fscanf(fp, "%s", pipe_output_name);
-                if (pclose(fp) != EXIT_SUCCESS) {
-                    fprintf(stderr, 
-                            "Error executing command\n   \"%s\"\n",
-                            string);
-                }
-                else if (G.Debug) {
-                    printf("Executed command \"%s\",\nproducing file %s.\n",
-                           string, pipe_output_name);
-                }
-            }
-            else {
-                fprintf(stderr, "Error executing command \"%s\"\n", string);
-            }
-            printf("Done.\n");
+        while (num_running > 0) {
+            job = wait_series_job(jobs, num_jobs);
+            num_running--;
+            series_job_progress(job, &num_files_done, num_files);
+            exit_status = print_series_jobs(jobs, num_jobs, &num_printed,
+                                            exit_status);
         }
-#endif /* HAVE_POPEN */
+        free(jobs);
     }
+#endif /* HAVE_WORKING_FORK && HAVE_SYS_WAIT_H */
    
     /* Free acquisition file list */
     free(acq_file_list);
+    free(acq_header_list);
     free(acq_file_index);
     free(used_file);
 
@@ -190,6 +190,17 @@ typedef enum { NONE = 0 , ACQ , MEAS } Loop_Type;
 /* supported file types */
 typedef enum { UNDEF, IMA, N3DCM, N4DCM } File_Type;
 
+/* Header of an input file as parsed when the files are first sorted,
+ * kept so that dicom_to_minc need not parse the file again. The offset
+ * and encoding locate the pixel data group that follows the header.
+ */
+typedef struct {
+    Acr_Group group_list;       /* groups preceding the pixel data */
+    long pixel_offset;          /* file offset of pixel data, or -1 */
+    Acr_byte_order byte_order;  /* byte order of pixel data group */
+    Acr_VR_encoding_type vr_encoding; /* VR encoding of pixel data group */
+} Dicom_Header;
+
 /* Type for carrying around object information 
  */
 typedef struct {
@@ -222,6 +233,7 @@ typedef struct {
     string_t patient_id;
     double slice_location;
     int coord_found;
+    Dicom_Header header;        /* cached header, if any */
 } Data_Object_Info;
 
 #include "dicom_to_minc.h"
@@ -265,6 +277,9 @@ struct globals {
     int min_img_num;            /* Minimum image number (0020,0013). */
     int max_img_num;            /* Maximum image number. */
     int abort_on_error;         /* Abort on parse errors. */
+    int num_threads;            /* Files read ahead and series converted
+                                   at once. */
+    int no_progress;            /* TRUE to suppress progress bars. */
 };
 
 /* Values for options flags */
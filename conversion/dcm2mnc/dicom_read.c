@@ -2272,6 +2272,112 @@ get_dicom_image_data(Acr_Group group_list, Image_Data *image)
     return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : get_dicom_image_slab
+   @INPUT      : group_list - input data
+                 nimages - number of images to unpack
+                 offsets - byte offset of the first pixel of each image in
+                    the pixel data
+                 row_stride - number of bytes from one image row to the
+                    next in the pixel data
+                 slab_order - position of each image in the output
+   @OUTPUT     : image - image data structure holding nimages images one
+                    after another (user must free data)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to unpack several images that share one pixel data
+                 element, such as the slices of a mosaic or the frames of a
+                 multiframe object, into one block of image data. The size
+                 of each image is given by the rows and columns in the
+                 group list.
+   @METHOD     : Each image row is converted straight from the pixel data
+                 into its place in the output. Images that do not lie
+                 entirely within the pixel data are filled with zeros.
+   @GLOBALS    :
+   @CALLS      :
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+void
+get_dicom_image_slab(Acr_Group group_list, int nimages,
+                     const long offsets[], long row_stride,
+                     const int slab_order[], Image_Data *image)
+{
+    Acr_Element element;
+    int nrows, ncolumns;
+    int bits_alloc;
+    int image_group;
+    unsigned char *data;
+    long data_length;
+    long imagepix, offset;
+    int iimage, irow, icolumn;
+    unsigned short *image_ptr;
+    struct Acr_Element_Id elid;
+    nc_type datatype;
+
+    /* Get the image information */
+    bits_alloc = (int)acr_find_short(group_list, ACR_Bits_allocated, 0);
+    nrows = (int)acr_find_short(group_list, ACR_Rows, 0);
+    ncolumns = (int)acr_find_short(group_list, ACR_Columns, 0);
+    image_group = (int)acr_find_short(group_list, ACR_Image_location, ACR_IMAGE_GID);
+
+    /* Figure out type */
+    if (bits_alloc > CHAR_BIT)
+        datatype = NC_SHORT;
+    else
+        datatype = NC_BYTE;
+
+    /* Set image info */
+    imagepix = nrows * ncolumns;
+    image->data = (unsigned short *) malloc(nimages * imagepix * sizeof(short));
+    CHKMEM(image->data);
+
+    /* Get image pointer, filling with zeros if there is no image or it
+     * is packed short data
+     */
+    elid.group_id = image_group;
+    elid.element_id = ACR_IMAGE_EID;
+    element = acr_find_group_element(group_list, &elid);
+    if (element == NULL ||
+        (datatype == NC_SHORT &&
+         bits_alloc != nctypelen(datatype) * CHAR_BIT)) {
+        memset(image->data, 0, nimages * imagepix * sizeof(short));
+        return;
+    }
+    data = (unsigned char *) acr_get_element_data(element);
+    data_length = acr_get_element_length(element);
+
+    for (iimage = 0; iimage < nimages; iimage++) {
+        image_ptr = &image->data[slab_order[iimage] * imagepix];
+        offset = offsets[iimage];
+
+        /* Check that the whole image is there */
+        if (imagepix <= 0 || offset < 0 ||
+            offset + (nrows - 1) * row_stride +
+            ncolumns * nctypelen(datatype) > data_length) {
+            memset(image_ptr, 0, imagepix * sizeof(short));
+            continue;
+        }
+
+        /* Convert the data a row at a time */
+        for (irow = 0; irow < nrows; irow++) {
+            if (datatype == NC_BYTE) {
+                for (icolumn = 0; icolumn < ncolumns; icolumn++) {
+                    image_ptr[icolumn] = data[offset + icolumn];
+                }
+            }
+            else {
+                acr_get_short(acr_get_element_byte_order(element),
+                              ncolumns, &data[offset],
+                              (Acr_Short *) image_ptr);
+            }
+            image_ptr += ncolumns;
+            offset += row_stride;
+        }
+    }
+
+    return;
+}
+
 
 /* ----------------------------- MNI Header -----------------------------------
    @NAME       : parse_dicom_groups
@@ -1,4 +1,7 @@
 extern void get_dicom_image_data(Acr_Group group_list, Image_Data *image);
+extern void get_dicom_image_slab(Acr_Group group_list, int nimages,
+                                 const long offsets[], long row_stride,
+                                 const int slab_order[], Image_Data *image);
 extern void parse_dicom_groups(Acr_Group group_list, Data_Object_Info *di_ptr);
 extern void get_file_info(Acr_Group group_list, File_Info *file_info,
                           General_Info *general_info, const char *file_name);
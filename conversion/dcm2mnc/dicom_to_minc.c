@@ -227,14 +227,11 @@ const char *Mri_Names[MRI_NDIMS] = {"Slice", "Echo", "Time", "Phase", "ChmSh"};
 
 /* multi-image (mosaic) info */
 typedef struct {
-    int packed;
     mosaic_seq_t mosaic_seq;
     int size[2];
     int big[2];
     int grid[2];
     int pixel_size;
-    Acr_Element big_image;
-    Acr_Element small_image;
     int sub_images;
     int slice_count;
     double normal[WORLD_NDIMS];
@@ -251,8 +248,7 @@ typedef struct {
 typedef struct {
     int frame_count;
     int frame_size;
-    Acr_Element big_image;
-    Acr_Element sub_image;
+    int row_size;
     double normal[WORLD_NDIMS];
     double step[WORLD_NDIMS];
     double position[WORLD_NDIMS];
@@ -267,14 +263,16 @@ typedef struct {
 } Sort_Element;
 
 /* Private function definitions */
-static int mosaic_init(Acr_Group, Mosaic_Info *, int);
-static void mosaic_cleanup(Mosaic_Info *);
-static int mosaic_insert_subframe(Acr_Group, Mosaic_Info *, int, int);
+static int mosaic_init(Acr_Group, Mosaic_Info *);
+static int mosaic_insert_subframe(Acr_Group, Mosaic_Info *, int);
+static void mosaic_get_image_data(Acr_Group, Mosaic_Info *, int,
+                                  const int *, Image_Data *);
 
 /* DICOM Multiframe conversion functions (see NOTE: above) */
-static void multiframe_init(Acr_Group, Multiframe_Info *, int);
-static void multiframe_cleanup(Multiframe_Info *);
-static void multiframe_insert_subframe(Acr_Group, Multiframe_Info *, int, int);
+static void multiframe_init(Acr_Group, Multiframe_Info *);
+static void multiframe_insert_subframe(Acr_Group, Multiframe_Info *, int);
+static void multiframe_get_image_data(Acr_Group, Multiframe_Info *, int,
+                                      const int *, Image_Data *);
 
 static void free_info(General_Info *gi_ptr, File_Info *fi_ptr, 
                       int num_files);
@@ -283,11 +281,20 @@ static void sort_dimensions(General_Info *gi_ptr);
 static int prot_find_string(Acr_Element Protocol, const char *name,
                             char *value);
 static char *dump_protocol_text(Acr_Element Protocol);
+static Acr_Group read_std_dicom_file(const char *filename, int max_group,
+                                     Dicom_Header *hdr_ptr);
+static Acr_Group read_numa4_dicom_file(const char *filename, int max_group,
+                                       Dicom_Header *hdr_ptr);
+static Acr_Group read_cached_dicom(const char *filename,
+                                   const Dicom_Header *hdr_ptr);
+static void remove_group_element(Acr_Group group_list, Acr_Element_Id elid);
 
 /* ----------------------------- MNI Header -----------------------------------
    @NAME       : dicom_to_minc
    @INPUT      : num_files - number of image files
    file_list - list of file names
+   header_list - list of headers cached by read_dicom_header, or
+   NULL to read each file from scratch
    minc_file - name of minc file to create, or NULL to make one up.
    clobber - if TRUE, then open the output with NC_CLOBBER
    file_prefix - string providing any directory or prefix 
@@ -304,12 +311,13 @@ static char *dump_protocol_text(Acr_Element Protocol);
    @GLOBALS    :
    @CALLS      : 
    @CREATED    : November 25, 1993 (Peter Neelin)
-   @MODIFIED   : 
+   @MODIFIED   : October 17, 2026
    ---------------------------------------------------------------------------- */
 
 int
 dicom_to_minc(int num_files, 
               const char *file_list[], 
+              Dicom_Header *header_list[],
               const char *minc_file,
               int clobber,
               const char *file_prefix, 
@@ -332,6 +340,7 @@ dicom_to_minc(int num_files,
     Mosaic_Info mi;             /* Mosaic (multi-image) information */
     Multiframe_Info mfi;        /* Multiframe information */
     int n_slices_in_file;       /* Number of slices in file */
+    int *slab_order;            /* Position of each image in the slab */
 
     gi.subimage_type = SUBIMAGE_TYPE_NONE;
 
@@ -378,13 +387,20 @@ dicom_to_minc(int num_files,
             printf("\nFile %s\n", file_list[ifile]);
         }
 
-        if (!G.Debug) {
+        if (!G.Debug && !G.no_progress) {
             progress(ifile, num_files, "-Parsing series info");
         }
 
-        /* Read the file
+        /* Read the file, or take a copy of its cached header, since the
+         * group list is modified below. The cached header lacks the
+         * Siemens protocol elements, so the file that sets up the
+         * general info, and with it the MINC header, is read in full.
          */
-        if (G.file_type == N4DCM) {
+        if (header_list != NULL && header_list[ifile]->group_list != NULL &&
+            gi.initialized) {
+            group_list = acr_copy_group_list(header_list[ifile]->group_list);
+        }
+        else if (G.file_type == N4DCM) {
             group_list = read_numa4_dicom(file_list[ifile], max_group);
         } 
         else if (G.file_type == IMA) {
@@ -410,7 +426,7 @@ dicom_to_minc(int num_files,
 
             gi.subimage_type = SUBIMAGE_TYPE_MOSAIC;
 
-            mosaic_init(group_list, &mi, FALSE);
+            mosaic_init(group_list, &mi);
 
             num_images += n_slices_in_file - 1;
 
@@ -435,7 +451,7 @@ dicom_to_minc(int num_files,
             if (n_slices_in_file > 1) {
                 gi.subimage_type = SUBIMAGE_TYPE_MULTIFRAME;
             
-                multiframe_init(group_list, &mfi, FALSE);
+                multiframe_init(group_list, &mfi);
 
                 num_images += n_slices_in_file - 1;
                 
@@ -453,10 +469,10 @@ dicom_to_minc(int num_files,
              */
             switch (gi.subimage_type) {
             case SUBIMAGE_TYPE_MOSAIC:
-                mosaic_insert_subframe(group_list, &mi, subimage, FALSE);
+                mosaic_insert_subframe(group_list, &mi, subimage);
                 break;
             case SUBIMAGE_TYPE_MULTIFRAME:
-                multiframe_insert_subframe(group_list, &mfi, subimage, FALSE);
+                multiframe_insert_subframe(group_list, &mfi, subimage);
                 break;
             default:
                 break;
@@ -478,21 +494,6 @@ dicom_to_minc(int num_files,
         /* Delete the group list
          */
         acr_delete_group_list(group_list);
-
-        /* cleanup mosaic struct if used
-         */
-        switch (gi.subimage_type) {
-        case SUBIMAGE_TYPE_MOSAIC:
-            mosaic_cleanup(&mi);
-            break;
-
-        case SUBIMAGE_TYPE_MULTIFRAME:
-            multiframe_cleanup(&mfi);
-            break;
-
-        default:
-            break;
-        }
     }
 
     /* Sort the dimensions */
@@ -539,7 +540,7 @@ dicom_to_minc(int num_files,
     iimage = 0;
     for (ifile = 0; ifile < num_files; ifile++) {
 
-        if (!G.Debug) {
+        if (!G.Debug && !G.no_progress) {
             progress(ifile, num_files, "-Creating minc file");
         }
 
@@ -551,9 +552,14 @@ dicom_to_minc(int num_files,
             continue;
         }
      
-        /* Read the file 
+        /* Read the file, or just its pixel data if we have the header
          */
-        if (G.file_type == N4DCM) {
+        if (header_list != NULL && header_list[ifile]->group_list != NULL &&
+            header_list[ifile]->pixel_offset >= 0) {
+            group_list = read_cached_dicom(file_list[ifile], 
+                                           header_list[ifile]);
+        }
+        else if (G.file_type == N4DCM) {
             group_list = read_numa4_dicom(file_list[ifile], max_group);
         }
         else if (G.file_type == IMA) {
@@ -574,77 +580,55 @@ dicom_to_minc(int num_files,
             }
         }
 
-        /* initialize big and small images, if mosaic
+        /* Work out where the images in this file go in the minc file,
+         * so that they can be unpacked straight into one slab. The
+         * coordinates of each image were found on the first pass, so
+         * the group list does not need to be updated for each one.
+         */
+        slab_order = malloc(n_slices_in_file * sizeof(*slab_order));
+        CHKMEM(slab_order);
+        get_minc_slab_order(&gi, &fi_ptr[iimage], n_slices_in_file,
+                            slab_order);
+
+        /* Get the images, splitting up the mosaic or multiframe image
          */
         switch (gi.subimage_type) {
         case SUBIMAGE_TYPE_MOSAIC:
-            mosaic_init(group_list, &mi, TRUE);
+            mosaic_init(group_list, &mi);
+            mosaic_get_image_data(group_list, &mi, n_slices_in_file,
+                                  slab_order, &image);
             break;
 
         case SUBIMAGE_TYPE_MULTIFRAME:
-            multiframe_init(group_list, &mfi, TRUE);
+            multiframe_init(group_list, &mfi);
+            multiframe_get_image_data(group_list, &mfi, n_slices_in_file,
+                                      slab_order, &image);
             break;
 
         default:
+            get_dicom_image_data(group_list, &image);
             break;
         }
 
-        /* loop over subimages in mosaic
+        /* Save the images and any other information
          */
-        for (subimage = 0; subimage < n_slices_in_file; subimage++) {
-
-            /* Modify the group list for this image if mosaic
-             */
-            switch (gi.subimage_type) {
-            case SUBIMAGE_TYPE_MOSAIC:
-                mosaic_insert_subframe(group_list, &mi, subimage, TRUE);
-                break;
-
-            case SUBIMAGE_TYPE_MULTIFRAME:
-                multiframe_insert_subframe(group_list, &mfi, subimage, TRUE);
-                break;
-
-            default:
-                break;
-            }
-       
-            /* Get image
-             */
-            get_dicom_image_data(group_list, &image);
-       
-            /* Save the image and any other information
-             */
-            save_minc_image(icvid, &gi, &fi_ptr[iimage], &image);
-
-            /* Free the image data */
-            if (image.data != NULL) {
-                free(image.data);
-                image.data = NULL;
-            }
+        save_minc_slab(icvid, &gi, &fi_ptr[iimage], n_slices_in_file,
+                       slab_order, &image);
 
-            /* increment image counter
-             */
-            iimage++;
+        /* Free the image data */
+        if (image.data != NULL) {
+            free(image.data);
+            image.data = NULL;
         }
+        free(slab_order);
+
+        /* increment image counter
+         */
+        iimage += n_slices_in_file;
      
         /* Delete the group list
          */
         acr_delete_group_list(group_list);
-
-        /* cleanup mosaic struct if used
-         */
-        switch (gi.subimage_type) {
-        case SUBIMAGE_TYPE_MOSAIC:
-            mosaic_cleanup(&mi);
-            break;
-
-        case SUBIMAGE_TYPE_MULTIFRAME:
-            multiframe_cleanup(&mfi);
-            break;
-
-        default:
-            break;
-        }
     }
 
     /* Close the output file */
@@ -674,21 +658,35 @@ dicom_to_minc(int num_files,
 Acr_Group
 read_std_dicom(const char *filename, int max_group)
 {
-    FILE *fp;
+    return read_std_dicom_file(filename, max_group, NULL);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : read_std_dicom_file
+   @INPUT      : filename - name of siemens Numaris 4 `dicom' file to read
+                 max_group - maximum group number to read
+   @OUTPUT     : hdr_ptr - if not NULL, gets the position and encoding of
+                 the group following the ones read in
+   @RETURNS    : group list read in from file
+   @DESCRIPTION: Routine to read in a group list from a file.
+   @METHOD     : 
+   @GLOBALS    : 
+   @CALLS      : 
+   @CREATED    : December 18, 2001 (Rick Hoge)
+   @MODIFIED   : October 17, 2026
+   ---------------------------------------------------------------------------- */
+
+static Acr_Group
+read_std_dicom_file(const char *filename, int max_group, Dicom_Header *hdr_ptr)
+{
     Acr_File *afp;
     Acr_Group group_list;
     int status;
 
-    /* Open the file
-     */
-    fp = fopen(filename, "rb");
-    if (fp == NULL) {
-        return NULL;
-    }
-
-    /* Connect to input stream
+    /* Open the file and connect to input stream. The file is mapped if
+     * possible, so that the pixel data is not copied.
      */
-    afp = acr_file_initialize(fp, 0, acr_stdio_read);
+    afp = acr_file_initialize_path(filename, 0);
     if (afp == NULL) {
         return NULL;
     }
@@ -696,18 +694,28 @@ read_std_dicom(const char *filename, int max_group)
     acr_set_ignore_errors(afp, 1); /* ignore protocol errors */
 
     if (acr_test_dicom_file(afp) != ACR_OK) {
+        acr_file_free(afp);
         return NULL;
     }
 
     // Read in group list
     status = acr_input_group_list(afp, &group_list, max_group);
     if (status != ACR_END_OF_INPUT && status != ACR_OK) {
+        acr_file_free(afp);
         return NULL;
     }
 
+    /* Remember where the next group starts. The group reading stops
+     * after peeking at its first element, so it has not been consumed.
+     */
+    if (hdr_ptr != NULL) {
+        hdr_ptr->pixel_offset = acr_file_tell(afp);
+        hdr_ptr->byte_order = acr_get_byte_order(afp);
+        hdr_ptr->vr_encoding = acr_get_vr_encoding(afp);
+    }
+
     // Close the file
     acr_file_free(afp);
-    fclose(fp);
 
     return (group_list);
 }
@@ -1970,11 +1978,34 @@ add_shimadzu_info(Acr_Group group_list)
 
 Acr_Group
 read_numa4_dicom(const char *filename, int max_group)
+{
+    return read_numa4_dicom_file(filename, max_group, NULL);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : read_numa4_dicom_file
+   @INPUT      : filename - read a standard DICOM file
+   max_group - maximum group number to read
+   @OUTPUT     : hdr_ptr - if not NULL, gets the position and encoding of
+   the group following the ones read in
+   @RETURNS    : group list read in from file
+   @DESCRIPTION: Routine to read in a group list from a file and interpret
+   any manufacturer-specific information in it.
+   @METHOD     : 
+   @GLOBALS    : 
+   @CALLS      : 
+   @CREATED    : December 18, 2001 (Rick Hoge)
+   @MODIFIED   : October 17, 2026
+   ---------------------------------------------------------------------------- */
+
+static Acr_Group
+read_numa4_dicom_file(const char *filename, int max_group,
+                      Dicom_Header *hdr_ptr)
 {
     Acr_Group group_list;
     Acr_String str_ptr;
 
-    group_list = read_std_dicom(filename, max_group);
+    group_list = read_std_dicom_file(filename, max_group, hdr_ptr);
     if (group_list == NULL) {
         return NULL;
     }
@@ -2007,6 +2038,153 @@ read_numa4_dicom(const char *filename, int max_group)
     return (group_list);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : read_dicom_header
+   @INPUT      : filename - name of file to read
+   @OUTPUT     : hdr_ptr - header of the file, with the position of its
+   pixel data if the file type allows it to be read separately
+   @RETURNS    : group list read in from file (owned by hdr_ptr), or NULL
+   @DESCRIPTION: Routine to read in the header of a file (everything up to
+   the pixel data, less the Siemens protocol elements) so that
+   it can be passed to dicom_to_minc without the file being
+   parsed again.
+   @METHOD     : 
+   @GLOBALS    : 
+   @CALLS      : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   : 
+   ---------------------------------------------------------------------------- */
+
+Acr_Group
+read_dicom_header(const char *filename, Dicom_Header *hdr_ptr)
+{
+    hdr_ptr->pixel_offset = -1;
+
+    if (G.file_type == IMA) {
+        /* The image is converted along with the rest of the file, so
+         * there is no pixel data group to seek to.
+         */
+        hdr_ptr->group_list = siemens_to_dicom(filename, ACR_IMAGE_GID - 1);
+    }
+    else {
+        hdr_ptr->group_list = read_numa4_dicom_file(filename, 
+                                                    ACR_IMAGE_GID - 1,
+                                                    hdr_ptr);
+    }
+
+    /* The header is kept until its series is converted, so drop the
+     * Siemens protocol elements, which can be hundreds of kilobytes
+     * per file. Their contents were added to the header above, and
+     * dicom_to_minc reads the file that sets up the MINC header again.
+     */
+    if (hdr_ptr->group_list != NULL) {
+        remove_group_element(hdr_ptr->group_list, SPI_Protocol);
+        remove_group_element(hdr_ptr->group_list, SPI_Protocol2);
+        remove_group_element(hdr_ptr->group_list, EXT_MrProt_dump);
+    }
+    return (hdr_ptr->group_list);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : remove_group_element
+   @INPUT      : group_list - list of groups
+   elid - element to remove
+   @OUTPUT     : (none)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to delete an element from a group list, if it
+   is there.
+   @METHOD     : 
+   @GLOBALS    : 
+   @CALLS      : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   : 
+   ---------------------------------------------------------------------------- */
+
+static void
+remove_group_element(Acr_Group group_list, Acr_Element_Id elid)
+{
+    Acr_Group group;
+
+    group = acr_find_group(group_list, elid->group_id);
+    if (group != NULL) {
+        acr_group_remove_element(group, elid->element_id);
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : read_cached_dicom
+   @INPUT      : filename - name of file to read
+   hdr_ptr - header of the file from read_dicom_header
+   @OUTPUT     : (none)
+   @RETURNS    : group list including the pixel data, or NULL on error
+   @DESCRIPTION: Routine to read in the pixel data of a file whose header
+   has already been read, and add it to a copy of the header.
+   This gives the same group list as read_numa4_dicom with
+   a maximum group of ACR_IMAGE_GID.
+   @METHOD     : 
+   @GLOBALS    : 
+   @CALLS      : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   : 
+   ---------------------------------------------------------------------------- */
+
+static Acr_Group
+read_cached_dicom(const char *filename, const Dicom_Header *hdr_ptr)
+{
+    Acr_File *afp;
+    Acr_Group group_list;
+    Acr_Group pixel_list;
+    Acr_Group last_group;
+    int status;
+
+    afp = acr_file_initialize_path(filename, 0);
+    if (afp == NULL) {
+        return NULL;
+    }
+    if (acr_skip_input_data(afp, hdr_ptr->pixel_offset) != ACR_OK) {
+        acr_file_free(afp);
+        return NULL;
+    }
+    acr_set_ignore_errors(afp, 1); /* ignore protocol errors */
+    acr_set_byte_order(afp, hdr_ptr->byte_order);
+    acr_set_vr_encoding(afp, hdr_ptr->vr_encoding);
+
+    /* The pixel data is left in the mapped file, which stays mapped
+     * until the group list is deleted.
+     */
+    status = acr_input_group_list(afp, &pixel_list, ACR_IMAGE_GID);
+
+    acr_file_free(afp);
+
+    if (status != ACR_END_OF_INPUT && status != ACR_OK) {
+        if (pixel_list != NULL) {
+            acr_delete_group_list(pixel_list);
+        }
+        return NULL;
+    }
+
+    group_list = acr_copy_group_list(hdr_ptr->group_list);
+    if (pixel_list == NULL) {
+        return (group_list);
+    }
+
+    /* The new groups should follow all of the header groups. If the
+     * header processing added one of them, read the whole file instead.
+     */
+    last_group = group_list;
+    while (acr_get_group_next(last_group) != NULL) {
+        last_group = acr_get_group_next(last_group);
+    }
+    if (acr_get_group_group(last_group) >= acr_get_group_group(pixel_list)) {
+        acr_delete_group_list(pixel_list);
+        acr_delete_group_list(group_list);
+        return read_numa4_dicom(filename, ACR_IMAGE_GID);
+    }
+    acr_set_group_next(last_group, pixel_list);
+
+    return (group_list);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
    @NAME       : free_info
    @INPUT      : gi_ptr
@@ -2424,17 +2602,6 @@ dump_protocol_text(Acr_Element elem_ptr)
     return (output);
 }
 
-static void
-copy_element_properties(Acr_Element new_element, Acr_Element old_element)
-{
-    acr_set_element_byte_order(new_element,
-                               acr_get_element_byte_order(old_element));
-
-    acr_set_element_vr_encoding(new_element,
-                                acr_get_element_vr_encoding(old_element));
-}
-
-
 /* Since at least software version VA25 (and thus VA30, VB15), 
  * the mosaic sequencing in the file is the same, regardless
  * of the acquisition (always ascending). 
@@ -2476,12 +2643,9 @@ old_mosaic_ordering(Acr_Group group_list)
 }
 
 static int 
-mosaic_init(Acr_Group group_list, Mosaic_Info *mi_ptr, int load_image)
+mosaic_init(Acr_Group group_list, Mosaic_Info *mi_ptr)
 {
-    int group_id, element_id;
     int grid_size;
-    long new_image_size;
-    void *data;
     Acr_Element element;
     int i;
     double pixel_spacing[2];
@@ -2492,9 +2656,8 @@ mosaic_init(Acr_Group group_list, Mosaic_Info *mi_ptr, int load_image)
     int old = 1;
 
     if (G.Debug >= HI_LOGGING) {
-        printf("mosaic_init(%lx, %lx, %d)\n",
-               (unsigned long) group_list, (unsigned long) mi_ptr,
-               load_image);
+        printf("mosaic_init(%lx, %lx)\n",
+               (unsigned long) group_list, (unsigned long) mi_ptr);
     }
 
     str_tmp = acr_find_string(group_list, EXT_Slice_inverted, "0");
@@ -2580,16 +2743,10 @@ mosaic_init(Acr_Group group_list, Mosaic_Info *mi_ptr, int load_image)
     }
 
     // Check whether we need to do anything (1x1 grid may be the whole image)
-    mi_ptr->big_image = NULL;
-    mi_ptr->small_image = NULL;
-    mi_ptr->packed = FALSE;
     grid_size = mi_ptr->grid[0] * mi_ptr->grid[1];
     if ((grid_size == 1) &&
         (mi_ptr->size[0] == mi_ptr->big[0]) &&
         (mi_ptr->size[1] == mi_ptr->big[1])) {
-        /* had to remove this as now ANY images acquired with 
-           the mosaic sequence need special treatment */
-        mi_ptr->packed = FALSE;
         return 1;
     }
 
@@ -2796,74 +2953,19 @@ mosaic_init(Acr_Group group_list, Mosaic_Info *mi_ptr, int load_image)
         }
     }
 
-    if (!load_image) {
-        mi_ptr->big_image = NULL;
-        mi_ptr->small_image = NULL;
-    }
-    else {
-
-        /* Steal the image element from the group list
-         */
-        mi_ptr->packed = TRUE;
-        mi_ptr->big_image = acr_find_group_element(group_list, ACR_Pixel_data);
-        if (mi_ptr->big_image == NULL) {
-            fprintf(stderr, "Couldn't find an image\n");
-            exit(EXIT_FAILURE);
-        }
-        group_id = acr_get_element_group(mi_ptr->big_image);
-        element_id = acr_get_element_element(mi_ptr->big_image);
-        acr_group_steal_element(acr_find_group(group_list, group_id),
-                                mi_ptr->big_image);
-        
-        /* Add a small image
-         */
-        new_image_size = mi_ptr->size[0] * mi_ptr->size[1] * mi_ptr->pixel_size;
-        data = malloc(new_image_size);
-        CHKMEM(data);
-        mi_ptr->small_image = acr_create_element(group_id, element_id,
-                                                 acr_get_element_vr(mi_ptr->big_image),
-                                                 new_image_size, data);
-        acr_set_element_vr(mi_ptr->small_image,
-                           acr_get_element_vr(mi_ptr->big_image));
-
-        copy_element_properties(mi_ptr->small_image, mi_ptr->big_image);
-
-        acr_insert_element_into_group_list(&group_list, mi_ptr->small_image);
-    }
-
     /* Return number of sub-images in this image */
     return mi_ptr->sub_images;
 }
 
+/* Map an image number in a mosaic to the sub-image that holds it, taking
+ * the slice ordering into account.
+ */
 static int 
-mosaic_insert_subframe(Acr_Group group_list, Mosaic_Info *mi_ptr,
-                       int iimage, int load_image)
+mosaic_slice_index(const Mosaic_Info *mi_ptr, int iimage, int old_ordering)
 {
-    int irow;
-    int idim;
-    int nbyte;
-    int isub;
-    int jsub;
-    char *new;
-    char *old;
-    long old_offset;
-    long new_offset;
-    double position[WORLD_NDIMS];
-    string_t string;
     int islice;
-    int oldb=1;
-
-    if (G.Debug >= HI_LOGGING) {
-        printf("mosaic_insert_subframe(%lx, %lx, %d, %d)\n",
-               (unsigned long)group_list, (unsigned long)mi_ptr,
-               iimage, load_image);
-    }
 
-    /* Figure out what to do based upon the mosaic sequencing.
-     */
-    oldb = old_mosaic_ordering(group_list);
-
-    if (mi_ptr->mosaic_seq == MOSAIC_SEQ_INTERLEAVED && oldb) { //old behavior
+    if (mi_ptr->mosaic_seq == MOSAIC_SEQ_INTERLEAVED && old_ordering) { //old behavior
         /* For interleaved sequences, we have to map the odd slices to
          * the range slice_count/2..slice_count-1 and the even slices
          * from zero to slice_count/2-1
@@ -2893,6 +2995,23 @@ mosaic_insert_subframe(Acr_Group group_list, Mosaic_Info *mi_ptr,
     }
 #endif
 
+    return islice;
+}
+
+static int 
+mosaic_insert_subframe(Acr_Group group_list, Mosaic_Info *mi_ptr,
+                       int iimage)
+{
+    int idim;
+    double position[WORLD_NDIMS];
+    string_t string;
+
+    if (G.Debug >= HI_LOGGING) {
+        printf("mosaic_insert_subframe(%lx, %lx, %d)\n",
+               (unsigned long)group_list, (unsigned long)mi_ptr,
+               iimage);
+    }
+
     /* Check the image number 
      */
     if ((iimage < 0) || (iimage > mi_ptr->sub_images)) {
@@ -2937,47 +3056,59 @@ mosaic_insert_subframe(Acr_Group group_list, Mosaic_Info *mi_ptr,
         printf(" position %s\n", string);
     }
 
-    if (load_image) {
-        /* Figure out the sub-image indices 
-         */
-        isub = islice % mi_ptr->grid[0];
-        jsub = islice / mi_ptr->grid[0];
-
-        /* Get pointers
-         */
-        old = acr_get_element_data(mi_ptr->big_image);
-        new = acr_get_element_data(mi_ptr->small_image);
-
-        /* Copy the image
-         */
-        nbyte = mi_ptr->size[0] * mi_ptr->pixel_size;
-        for (irow = 0; irow < mi_ptr->size[1]; irow++) {
-            old_offset = isub * mi_ptr->size[0] +
-                (jsub * mi_ptr->size[1] + irow) * mi_ptr->big[0];
-            old_offset *= mi_ptr->pixel_size;
-            new_offset = (irow * mi_ptr->size[0]) * mi_ptr->pixel_size;
-            memcpy(&new[new_offset], &old[old_offset], nbyte);
-        }
-
-        /* Reset the byte order and VR encoding. This will be modified on each
-         * send according to what the connection needs.
-         */
-        copy_element_properties(mi_ptr->small_image, mi_ptr->big_image);
-    }
     return 1;
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : mosaic_get_image_data
+   @INPUT      : group_list - the list of DICOM groups/elements that make up
+                 this file, already passed to mosaic_init()
+                 mi_ptr - mosaic information from mosaic_init()
+                 nimages - number of images to unpack
+                 slab_order - position of each image in the output
+   @OUTPUT     : image - the images of the mosaic, one after another
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Unpacks the sub-images of a mosaic straight from the mosaic
+                 pixel data into one block of image data.
+   @METHOD     :
+   @GLOBALS    :
+   @CALLS      :
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+---------------------------------------------------------------------------- */
 static void 
-mosaic_cleanup(Mosaic_Info *mi_ptr)
+mosaic_get_image_data(Acr_Group group_list, Mosaic_Info *mi_ptr,
+                      int nimages, const int slab_order[], Image_Data *image)
 {
-    if (mi_ptr) {
-      if (mi_ptr->packed && mi_ptr->big_image != NULL) {
-        acr_delete_element(mi_ptr->big_image);
-        mi_ptr->packed = FALSE;
-        mi_ptr->big_image = NULL;
-      }
+    long *offsets;
+    int iimage;
+    int islice;
+    int isub;
+    int jsub;
+    int old_ordering;
+
+    old_ordering = old_mosaic_ordering(group_list);
+
+    offsets = malloc(nimages * sizeof(*offsets));
+    CHKMEM(offsets);
+
+    /* Figure out the byte offset of each sub-image in the mosaic
+     */
+    for (iimage = 0; iimage < nimages; iimage++) {
+        islice = mosaic_slice_index(mi_ptr, iimage, old_ordering);
+        isub = islice % mi_ptr->grid[0];
+        jsub = islice / mi_ptr->grid[0];
+        offsets[iimage] = (isub * (long) mi_ptr->size[0] +
+                           jsub * (long) mi_ptr->size[1] * mi_ptr->big[0]) *
+            mi_ptr->pixel_size;
     }
+
+    get_dicom_image_slab(group_list, nimages, offsets,
+                         (long) mi_ptr->big[0] * mi_ptr->pixel_size,
+                         slab_order, image);
+
+    free(offsets);
 }
 
 /************************************************************************
@@ -2989,8 +3120,6 @@ mosaic_cleanup(Mosaic_Info *mi_ptr)
    @NAME       : multiframe_init()
    @INPUT      : group_list - the list of DICOM groups/elements that make up
                  this file.
-                 int load_image - a boolean value, non-zero if the function
-                 should actually load the data into memory.
    @OUTPUT     : mfi_ptr - a pointer to a Multiframe_Info structure that will
                  contain information used to expand this multiframe file into
                  a series of slices.
@@ -3000,16 +3129,12 @@ mosaic_cleanup(Mosaic_Info *mi_ptr)
    @GLOBALS    :
    @CALLS      : 
    @CREATED    : June 3, 2005 Bert Vincent
-   @MODIFIED   : 
+   @MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 
 static void
-multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr, int load_image)
+multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr)
 {
-    int grp_id;
-    int elm_id;
-    void *data_ptr;
-    Acr_Element element;
     int i;
     Acr_Double spacing;
     double RowColVec[6];
@@ -3019,9 +3144,8 @@ multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr, int load_image)
     int pixel_size;
 
     if (G.Debug >= HI_LOGGING) {
-        printf("multiframe_init(%lx, %lx, %d)\n",
-               (unsigned long) group_list, (unsigned long) mfi_ptr,
-               load_image);
+        printf("multiframe_init(%lx, %lx)\n",
+               (unsigned long) group_list, (unsigned long) mfi_ptr);
     }
 
     cols = acr_find_int(group_list, ACR_Columns, 1);
@@ -3033,6 +3157,11 @@ multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr, int load_image)
      */
     mfi_ptr->frame_count = acr_find_int(group_list, ACR_Number_of_frames, 1);
 
+    /* Get the size of each frame in bytes
+     */
+    mfi_ptr->row_size = cols * pixel_size;
+    mfi_ptr->frame_size = rows * mfi_ptr->row_size;
+
     /* Get spacing between slices
      */
     spacing = acr_find_double(group_list, ACR_Slice_thickness, 0.0);
@@ -3104,45 +3233,6 @@ multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr, int load_image)
                mfi_ptr->position[1],
                mfi_ptr->position[2]);
     }
-
-    if (!load_image) {
-        mfi_ptr->big_image = NULL;
-        mfi_ptr->sub_image = NULL;
-    }
-    else {
-        /* We need to load the image (we're probably on the second pass).
-         */
-
-        /* Steal the image element from the group list
-         */
-        element = acr_find_group_element(group_list, ACR_Pixel_data);
-        if (element == NULL) {
-            fprintf(stderr, "Couldn't find an image\n");
-            exit(EXIT_FAILURE);
-        }
-
-        mfi_ptr->big_image = element; /* Save pointer to pixel data element. */
-
-        grp_id = acr_get_element_group(element);
-        elm_id = acr_get_element_element(element);
-        acr_group_steal_element(acr_find_group(group_list, grp_id), element);
-        
-        /* Add a small image
-         */
-        mfi_ptr->frame_size = rows * cols * pixel_size;
-        data_ptr = malloc(mfi_ptr->frame_size);
-        CHKMEM(data_ptr);
-
-        mfi_ptr->sub_image = acr_create_element(grp_id,
-                                                elm_id,
-                                                acr_get_element_vr(element),
-                                                mfi_ptr->frame_size, 
-                                                data_ptr);
-
-        copy_element_properties(mfi_ptr->sub_image, mfi_ptr->big_image);
-        
-        acr_insert_element_into_group_list(&group_list, mfi_ptr->sub_image);
-    }
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -3152,37 +3242,33 @@ multiframe_init(Acr_Group group_list, Multiframe_Info *mfi_ptr, int load_image)
                  mfi_ptr - a pointer to a Multiframe_Info structure that will
                  contain information used to expand this multiframe file into
                  a series of slices.
-                 int iimage - the index of the subimage to parse and possibly
-                 to load.
-                 int load_image - a boolean value, non-zero if the function
-                 should actually load the data into memory.
+                 int iimage - the index of the subimage to parse.
    @OUTPUT     : mfi_ptr - may be modified by the function.
    @RETURNS    : void
    @DESCRIPTION: This function decomposes a multiframe DICOM image
                  into a series of single-frame images. Modifies the
-                 group_list to include updated image and position
-                 information.
+                 group_list to include updated position information.
+                 The pixel data is unpacked separately by
+                 multiframe_get_image_data().
    @METHOD     : 
    @GLOBALS    :
    @CALLS      : 
    @CREATED    : June 3, 2005 Bert Vincent
-   @MODIFIED   : 
+   @MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void
 multiframe_insert_subframe(Acr_Group group_list, Multiframe_Info *mfi_ptr,
-                           int iframe, int load_image)
+                           int iframe)
 {
     int idim;
-    char *new_ptr;
-    char *old_ptr;
     double position[WORLD_NDIMS];
     string_t string;
     int result;
 
     if (G.Debug >= HI_LOGGING) {
-        printf("multiframe_insert_subframe(%lx, %lx, %d, %d)\n",
+        printf("multiframe_insert_subframe(%lx, %lx, %d)\n",
                (unsigned long)group_list, (unsigned long)mfi_ptr,
-               iframe, load_image);
+               iframe);
     }
 
     /* Check the frame number 
@@ -3222,34 +3308,43 @@ multiframe_insert_subframe(Acr_Group group_list, Multiframe_Info *mfi_ptr,
     if (G.Debug >= HI_LOGGING) {
         printf(" position %s\n", string);
     }
-
-    if (load_image) {
-        /* Get pointers
-         */
-        old_ptr = acr_get_element_data(mfi_ptr->big_image);
-        new_ptr = acr_get_element_data(mfi_ptr->sub_image);
-
-        /* Copy the image
-         */
-        memcpy(new_ptr,         /* destination */
-               old_ptr + (iframe * mfi_ptr->frame_size), /* source */
-               mfi_ptr->frame_size); /* length */
-        
-        /* Reset the byte order and VR encoding. This will be modified
-         * on each send according to what the connection needs.
-         */
-        copy_element_properties(mfi_ptr->sub_image, mfi_ptr->big_image);
-    }
 }
 
-static void 
-multiframe_cleanup(Multiframe_Info *mfi_ptr)
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : multiframe_get_image_data()
+   @INPUT      : group_list - the list of DICOM groups/elements that make up
+                 this file.
+                 mfi_ptr - multiframe information from multiframe_init().
+                 nimages - the number of frames to unpack.
+                 slab_order - the position of each frame in the output.
+   @OUTPUT     : image - the frames, one after another.
+   @RETURNS    : void
+   @DESCRIPTION: Unpacks the frames of a multiframe DICOM image straight
+                 from its pixel data into one block of image data.
+   @METHOD     : 
+   @GLOBALS    :
+   @CALLS      : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void
+multiframe_get_image_data(Acr_Group group_list, Multiframe_Info *mfi_ptr,
+                          int nimages, const int slab_order[],
+                          Image_Data *image)
 {
-    if (mfi_ptr) {
-      if (mfi_ptr->big_image != NULL) {
-        acr_delete_element(mfi_ptr->big_image);
-        mfi_ptr->big_image = NULL;
-      }
+    long *offsets;
+    int iframe;
+
+    offsets = malloc(nimages * sizeof(*offsets));
+    CHKMEM(offsets);
+
+    for (iframe = 0; iframe < nimages; iframe++) {
+        offsets[iframe] = (long) iframe * mfi_ptr->frame_size;
     }
+
+    get_dicom_image_slab(group_list, nimages, offsets, mfi_ptr->row_size,
+                         slab_order, image);
+
+    free(offsets);
 }
 
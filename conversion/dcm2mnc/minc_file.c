@@ -1143,38 +1143,26 @@ put_att_dbl(int mincid, int varid, char *attname, int length, int position,
 }
             
 /* ----------------------------- MNI Header -----------------------------------
-   @NAME       : save_minc_image
-   @INPUT      : icvid
-   general_info
-   file_info
-   image
-   @OUTPUT     : (none)
-   @RETURNS    : (nothing)
-   @DESCRIPTION: Routine to save the image in the minc file
+   @NAME       : get_minc_image_start
+   @INPUT      : gi_ptr - general information
+                 fi_ptr - information for this image
+   @OUTPUT     : start, count - hyperslab of this image in the image variable
+   @RETURNS    : number of image dimensions
+   @DESCRIPTION: Routine to find where an image goes in the minc file
    @METHOD     : 
    @GLOBALS    : 
    CALLS       : 
-   @CREATED    : November 26, 1993 (Peter Neelin)
+   @CREATED    : October 17, 2026
    @MODIFIED   :
    ---------------------------------------------------------------------------- */
-
-void
-save_minc_image(int icvid, General_Info *gi_ptr, 
-                File_Info *fi_ptr, Image_Data *image)
+static int
+get_minc_image_start(General_Info *gi_ptr, File_Info *fi_ptr,
+                     long start[], long count[])
 {
-    int mincid;
-    long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
     int file_index, array_index;
     int idim;
     Mri_Index imri;
-    char *dimname;
-    int pvalue, pmax, pmin;
-    double dvalue, maximum, minimum, scale, offset;
-    long ipix, imagepix;
 
-    /* Get the minc file id */
-    miicv_inqint(icvid, MI_ICV_CDFID, &mincid);
-    
     /* Create start and count variables */
     idim = 0;
     for (imri=MRI_NDIMS-1; (int) imri >= 0; imri--) {
@@ -1201,6 +1189,31 @@ save_minc_image(int icvid, General_Info *gi_ptr,
     count[idim] = gi_ptr->nrows;
     count[idim+1] = gi_ptr->ncolumns;
 
+    return idim + 2;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : save_minc_image_info
+   @INPUT      : mincid
+                 gi_ptr - general information
+                 fi_ptr - information for this image
+                 start - position of this image in the image variable
+   @OUTPUT     : (none)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to save the slice position, time, echo time and
+                 diffusion information of an image in the minc file
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+static void
+save_minc_image_info(int mincid, General_Info *gi_ptr, File_Info *fi_ptr,
+                     long start[])
+{
+    char *dimname;
+
     /* Write out slice position */
     switch (gi_ptr->slice_world) {
     case XCOORD: dimname = MIxspace; break;
@@ -1225,28 +1238,28 @@ save_minc_image(int icvid, General_Info *gi_ptr,
                         gi_ptr->cur_size[TIME],
                         start[gi_ptr->image_index[TIME]],
                         fi_ptr->b_value);
-            
+
             put_att_dbl(mincid, 
                         ncvarid(mincid, MIacquisition),
                         "direction_x", 
                         gi_ptr->cur_size[TIME],
                         start[gi_ptr->image_index[TIME]],
                         fi_ptr->grad_direction[XCOORD]);
-                              
+
             put_att_dbl(mincid, 
                         ncvarid(mincid, MIacquisition),
                         "direction_y", 
                         gi_ptr->cur_size[TIME],
                         start[gi_ptr->image_index[TIME]],
                         fi_ptr->grad_direction[YCOORD]);
-                              
+
             put_att_dbl(mincid, 
                         ncvarid(mincid, MIacquisition),
                         "direction_z",
                         gi_ptr->cur_size[TIME],
                         start[gi_ptr->image_index[TIME]],
                         fi_ptr->grad_direction[ZCOORD]);
-	    
+
 	    int i;
 	    int num_elements=6;
 	    for(i=0;i<num_elements;i++){ 
@@ -1293,6 +1306,31 @@ save_minc_image(int icvid, General_Info *gi_ptr,
                   &start[gi_ptr->image_index[ECHO]], 
                   NC_DOUBLE, NULL, &fi_ptr->coordinate[ECHO]);
     }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : scale_minc_image
+   @INPUT      : gi_ptr - general information
+                 fi_ptr - information for this image
+                 data - pixels of one image
+   @OUTPUT     : data - rescaled pixels
+                 minimum, maximum - real range of the rescaled image
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to rescale an image to the full pixel range and
+                 work out its real minimum and maximum
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+static void
+scale_minc_image(General_Info *gi_ptr, File_Info *fi_ptr,
+                 unsigned short *data, double *minimum, double *maximum)
+{
+    int pvalue, pmax, pmin;
+    double dvalue, scale, offset;
+    long ipix, imagepix;
 
     /* Search image for max and min.  This needs to be done such
      * that we interpret signed data correctly, so there are separate
@@ -1313,7 +1351,7 @@ save_minc_image(int icvid, General_Info *gi_ptr,
     pmin = INT_MAX;             /* Initialize to largest possible int */
 
     if (gi_ptr->is_signed) {
-        short *ssh_ptr = (short *) image->data; /* Cast to signed data */
+        short *ssh_ptr = (short *) data; /* Cast to signed data */
 
         for (ipix = 0; ipix < imagepix; ipix++) {
             pvalue = ssh_ptr[ipix];
@@ -1324,7 +1362,7 @@ save_minc_image(int icvid, General_Info *gi_ptr,
         }
     }
     else {
-        unsigned short *ush_ptr = (unsigned short *) image->data;
+        unsigned short *ush_ptr = (unsigned short *) data;
 
         for (ipix = 0; ipix < imagepix; ipix++) {
             pvalue = ush_ptr[ipix];
@@ -1366,7 +1404,7 @@ save_minc_image(int icvid, General_Info *gi_ptr,
      */
 
     if (gi_ptr->is_signed) {
-        short *ssh_ptr = (short *) image->data;
+        short *ssh_ptr = (short *) data;
 
         for (ipix = 0; ipix < imagepix; ipix++) {
             dvalue = ssh_ptr[ipix];
@@ -1374,7 +1412,7 @@ save_minc_image(int icvid, General_Info *gi_ptr,
         }
     }
     else {
-        unsigned short *ush_ptr = (unsigned short *) image->data;
+        unsigned short *ush_ptr = (unsigned short *) data;
 
         for (ipix = 0; ipix < imagepix; ipix++) {
             dvalue = ush_ptr[ipix];
@@ -1391,21 +1429,37 @@ save_minc_image(int icvid, General_Info *gi_ptr,
     }
 
     offset = fi_ptr->slice_min - scale * gi_ptr->pixel_min;
-    minimum = (double) pmin * scale + offset;
-    maximum = (double) pmax * scale + offset;
+    *minimum = (double) pmin * scale + offset;
+    *maximum = (double) pmax * scale + offset;
 
     if (G.Debug >= HI_LOGGING) {
         printf("2. scale %.2f offset %.2f min %.2f max %.2f\n", scale, offset,
-               minimum, maximum);
-        printf("3. position %ld,%ld,%ld\n", start[0], start[1], start[2]);
+               *minimum, *maximum);
     }
+}
 
-    /* Write out the max and min values */
-    mivarput1(mincid, ncvarid(mincid, MIimagemin), start, NC_DOUBLE,
-              NULL, &minimum);
-    mivarput1(mincid, ncvarid(mincid, MIimagemax), start, NC_DOUBLE,
-              NULL, &maximum);
-
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : write_minc_image
+   @INPUT      : icvid
+                 mincid
+                 gi_ptr - general information
+                 start, count - hyperslab to write
+                 data - pixels to write
+   @OUTPUT     : (none)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to write one or more rescaled images to the image
+                 variable. The image-min and image-max for the hyperslab
+                 must already have been written.
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+static void
+write_minc_image(int icvid, int mincid, General_Info *gi_ptr,
+                 long start[], long count[], unsigned short *data)
+{
     if (G.opts & OPTS_NO_RESCALE) {
         mivarput(mincid, 
                  ncvarid(mincid, MIimage),
@@ -1413,16 +1467,244 @@ save_minc_image(int icvid, General_Info *gi_ptr,
                  count,
                  NC_SHORT, 
                  (gi_ptr->is_signed) ? MI_SIGNED : MI_UNSIGNED,
-                 image->data);
+                 data);
     }
     else {
         /* Write out the image */
-        miicv_put(icvid, start, count, image->data);
+        miicv_put(icvid, start, count, data);
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : save_minc_image
+   @INPUT      : icvid
+   general_info
+   file_info
+   image
+   @OUTPUT     : (none)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to save the image in the minc file
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : November 26, 1993 (Peter Neelin)
+   @MODIFIED   : October 17, 2026
+   ---------------------------------------------------------------------------- */
+
+void
+save_minc_image(int icvid, General_Info *gi_ptr, 
+                File_Info *fi_ptr, Image_Data *image)
+{
+    int mincid;
+    long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+    double maximum, minimum;
+
+    /* Get the minc file id */
+    miicv_inqint(icvid, MI_ICV_CDFID, &mincid);
+
+    /* Find the image position and save its coordinates */
+    get_minc_image_start(gi_ptr, fi_ptr, start, count);
+    save_minc_image_info(mincid, gi_ptr, fi_ptr, start);
+
+    /* Rescale the image */
+    scale_minc_image(gi_ptr, fi_ptr, image->data, &minimum, &maximum);
+
+    if (G.Debug >= HI_LOGGING) {
+        printf("3. position %ld,%ld,%ld\n", start[0], start[1], start[2]);
     }
 
+    /* Write out the max and min values */
+    mivarput1(mincid, ncvarid(mincid, MIimagemin), start, NC_DOUBLE,
+              NULL, &minimum);
+    mivarput1(mincid, ncvarid(mincid, MIimagemax), start, NC_DOUBLE,
+              NULL, &maximum);
+
+    /* Write out the image */
+    write_minc_image(icvid, mincid, gi_ptr, start, count, image->data);
+
     return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : get_minc_slab_order
+   @INPUT      : gi_ptr - general information
+                 fi_ptr - information for each image
+                 nimages - number of images
+   @OUTPUT     : slab_order - position of each image in a block of
+                 nimages images
+   @RETURNS    : TRUE if the images cover a contiguous range of slices
+   @DESCRIPTION: Routine to work out how the images of a file, such as the
+                 slices of a mosaic, should be laid out so that they can
+                 be written to the minc file with one hyperslab. Image i
+                 goes at position slab_order[i], which follows the slice
+                 order of the minc file. If the slices are not contiguous
+                 the images are left in their original order.
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+int
+get_minc_slab_order(General_Info *gi_ptr, File_Info *fi_ptr,
+                    int nimages, int slab_order[])
+{
+    long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+    long first_slice;
+    int slice_index;
+    int iimage;
+    char *used;
+    int is_slab;
+
+    /* Get the slice number of each image and the first slice */
+    slice_index = gi_ptr->image_index[SLICE];
+    first_slice = 0;
+    for (iimage = 0; iimage < nimages; iimage++) {
+        get_minc_image_start(gi_ptr, &fi_ptr[iimage], start, count);
+        slab_order[iimage] = start[slice_index];
+        if (iimage == 0 || start[slice_index] < first_slice) {
+            first_slice = start[slice_index];
+        }
+    }
+
+    /* Check that each slice appears exactly once */
+    used = calloc(nimages, sizeof(*used));
+    CHKMEM(used);
+    is_slab = TRUE;
+    for (iimage = 0; iimage < nimages; iimage++) {
+        slab_order[iimage] -= first_slice;
+        if (slab_order[iimage] >= nimages || used[slab_order[iimage]]) {
+            is_slab = FALSE;
+            break;
+        }
+        used[slab_order[iimage]] = TRUE;
+    }
+    free(used);
+
+    /* Otherwise keep the images in the order given */
+    if (!is_slab) {
+        for (iimage = 0; iimage < nimages; iimage++) {
+            slab_order[iimage] = iimage;
+        }
+    }
+
+    return is_slab;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+   @NAME       : save_minc_slab
+   @INPUT      : icvid
+                 gi_ptr - general information
+                 fi_ptr - information for each image
+                 nimages - number of images
+                 slab_order - position of each image in the image data,
+                    from get_minc_slab_order
+                 image - image data holding nimages images one after
+                    another
+   @OUTPUT     : (none)
+   @RETURNS    : (nothing)
+   @DESCRIPTION: Routine to save several images, such as the slices of a
+                 mosaic, in the minc file. If the images fill a contiguous
+                 block of slices that differ in nothing else, the image-min,
+                 image-max and pixels are written with one hyperslab
+                 each. Otherwise each image is written on its own.
+   @METHOD     : 
+   @GLOBALS    : 
+   CALLS       : 
+   @CREATED    : October 17, 2026
+   @MODIFIED   :
+   ---------------------------------------------------------------------------- */
+void
+save_minc_slab(int icvid, General_Info *gi_ptr, File_Info *fi_ptr,
+               int nimages, const int slab_order[], Image_Data *image)
+{
+    int mincid;
+    long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+    long slab_start[MAX_VAR_DIMS], slab_count[MAX_VAR_DIMS];
+    int ndims, idim;
+    int slice_index;
+    int iimage, islab;
+    int is_slab;
+    long imagepix;
+    double *minimum, *maximum;
+
+    /* Get the minc file id */
+    miicv_inqint(icvid, MI_ICV_CDFID, &mincid);
+
+    imagepix = gi_ptr->nrows * gi_ptr->ncolumns;
+    slice_index = gi_ptr->image_index[SLICE];
+
+    minimum = malloc(nimages * sizeof(*minimum));
+    CHKMEM(minimum);
+    maximum = malloc(nimages * sizeof(*maximum));
+    CHKMEM(maximum);
+
+    /* Save the coordinates of each image and rescale it, checking that
+     * the images fill the slab in slice order
+     */
+    is_slab = TRUE;
+    for (iimage = 0; iimage < nimages; iimage++) {
+        islab = slab_order[iimage];
+        ndims = get_minc_image_start(gi_ptr, &fi_ptr[iimage], start, count);
+        save_minc_image_info(mincid, gi_ptr, &fi_ptr[iimage], start);
+        scale_minc_image(gi_ptr, &fi_ptr[iimage],
+                         &image->data[islab * imagepix],
+                         &minimum[islab], &maximum[islab]);
+
+        if (iimage == 0) {
+            for (idim = 0; idim < ndims; idim++) {
+                slab_start[idim] = start[idim];
+                slab_count[idim] = count[idim];
+            }
+            slab_start[slice_index] -= islab;
+            slab_count[slice_index] = nimages;
+        }
+        for (idim = 0; idim < ndims; idim++) {
+            if (start[idim] != slab_start[idim] +
+                ((idim == slice_index) ? islab : 0)) {
+                is_slab = FALSE;
+            }
+        }
+    }
+
+    if (is_slab) {
+        if (G.Debug >= HI_LOGGING) {
+            printf("3. position %ld,%ld,%ld, %d slices\n",
+                   slab_start[0], slab_start[1], slab_start[2], nimages);
+        }
+
+        /* Write out the max and min values and the images in one go */
+        mivarput(mincid, ncvarid(mincid, MIimagemin), slab_start, slab_count,
+                 NC_DOUBLE, NULL, minimum);
+        mivarput(mincid, ncvarid(mincid, MIimagemax), slab_start, slab_count,
+                 NC_DOUBLE, NULL, maximum);
+        write_minc_image(icvid, mincid, gi_ptr, slab_start, slab_count,
+                         image->data);
+    }
+    else {
+        /* Write out the images one at a time */
+        for (iimage = 0; iimage < nimages; iimage++) {
+            islab = slab_order[iimage];
+            get_minc_image_start(gi_ptr, &fi_ptr[iimage], start, count);
+
+            if (G.Debug >= HI_LOGGING) {
+                printf("3. position %ld,%ld,%ld\n",
+                       start[0], start[1], start[2]);
+            }
+
+            mivarput1(mincid, ncvarid(mincid, MIimagemin), start, NC_DOUBLE,
+                      NULL, &minimum[islab]);
+            mivarput1(mincid, ncvarid(mincid, MIimagemax), start, NC_DOUBLE,
+                      NULL, &maximum[islab]);
+            write_minc_image(icvid, mincid, gi_ptr, start, count,
+                             &image->data[islab * imagepix]);
+        }
+    }
+
+    free(minimum);
+    free(maximum);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
    @NAME       : close_minc_file
    @INPUT      : icvid - value returned by create_minc_file
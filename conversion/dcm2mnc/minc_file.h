@@ -8,4 +8,10 @@ extern void setup_minc_variables(int mincid, General_Info *general_info,
 				 Loop_Type loop_type);
 extern void save_minc_image(int icvid, General_Info *general_info, 
                             File_Info *file_info, Image_Data *image);
+extern int get_minc_slab_order(General_Info *general_info,
+                               File_Info *file_info, int nimages,
+                               int slab_order[]);
+extern void save_minc_slab(int icvid, General_Info *general_info,
+                           File_Info *file_info, int nimages,
+                           const int slab_order[], Image_Data *image);
 extern void close_minc_file(int icvid);
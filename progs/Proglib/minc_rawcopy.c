@@ -0,0 +1,269 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <minc.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include "minc_endian.h"
+#include "minc_rawcopy.h"
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+/* State of a copy. Slabs are read into a ring of nbuffers buffers, by a
+   separate thread if there is more than one. */
+typedef struct {
+  int mincid;
+  int imgid;
+  int ndims;
+  nc_type datatype;
+  char *sign;
+  minc_swap_fn_t swap_fn;
+  long start[MAX_VAR_DIMS];
+  long end[MAX_VAR_DIMS];
+  long slab[MAX_VAR_DIMS];      /* Size of a full slab */
+  long cur[MAX_VAR_DIMS];       /* Start of the next slab to read */
+  long nslabs;
+  int nbuffers;
+  char **buffers;
+  size_t *nbytes;               /* Bytes in each buffer */
+  long nread;                   /* Slabs read so far */
+  long nused;                   /* Slabs written so far */
+  int stop;                     /* Set if writing failed */
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+#endif
+} raw_copy_t;
+
+/**
+ * Returns TRUE if a file valid range is the full range of its type.
+ */
+static int minc_is_full_range(nc_type datatype, int is_signed,
+                              double range[2])
+{
+  double type_range[2];
+
+  (void) miget_default_range(datatype, is_signed, type_range);
+  return ((range[0] == type_range[0] && range[1] == type_range[1]) ||
+          (range[0] == type_range[1] && range[1] == type_range[0]));
+}
+
+int minc_raw_copy_possible(int mincid, int imgid, nc_type datatype,
+                           int is_signed, double valid_range[2])
+{
+  nc_type file_datatype;
+  int file_is_signed;
+  double file_range[2];
+
+  /* The type must not change, and floating point values are scaled to
+     real values by the icv */
+  (void) miget_datatype(mincid, imgid, &file_datatype, &file_is_signed);
+  if (datatype != file_datatype || is_signed != file_is_signed ||
+      datatype == NC_FLOAT || datatype == NC_DOUBLE) {
+    return FALSE;
+  }
+
+  /* Both ranges must be the full range of the type so that values are
+     neither rescaled nor clipped */
+  (void) miget_valid_range(mincid, imgid, file_range);
+  return (minc_is_full_range(datatype, is_signed, file_range) &&
+          minc_is_full_range(datatype, is_signed, valid_range));
+}
+
+/**
+ * Reads the next slab into a buffer, swapping bytes if needed, and
+ * returns the number of bytes read.
+ */
+static size_t minc_read_slab(raw_copy_t *copy, char *buffer)
+{
+  long count[MAX_VAR_DIMS];
+  size_t nbytes;
+  int idim;
+
+  nbytes = nctypelen(copy->datatype);
+  for (idim = 0; idim < copy->ndims; idim++) {
+    count[idim] = copy->end[idim] - copy->cur[idim];
+    if (count[idim] > copy->slab[idim]) count[idim] = copy->slab[idim];
+    nbytes *= count[idim];
+  }
+
+  (void) mivarget(copy->mincid, copy->imgid, copy->cur, count,
+                  copy->datatype, copy->sign, buffer);
+  if (copy->swap_fn != NULL) {
+    (*copy->swap_fn)(buffer, nbytes);
+  }
+
+  /* Move on to the next slab */
+  idim = copy->ndims - 1;
+  copy->cur[idim] += copy->slab[idim];
+  while (idim > 0 && copy->cur[idim] >= copy->end[idim]) {
+    copy->cur[idim] = copy->start[idim];
+    idim--;
+    copy->cur[idim] += copy->slab[idim];
+  }
+
+  return nbytes;
+}
+
+#ifdef HAVE_PTHREAD
+/**
+ * Thread that reads all of the slabs, waiting whenever every buffer is
+ * still waiting to be written.
+ */
+static void *minc_read_slabs(void *arg)
+{
+  raw_copy_t *copy = arg;
+  long islab;
+  int ibuf;
+  size_t nbytes;
+
+  for (islab = 0; islab < copy->nslabs; islab++) {
+    (void) pthread_mutex_lock(&copy->mutex);
+    while (!copy->stop && islab - copy->nused >= copy->nbuffers)
+      (void) pthread_cond_wait(&copy->cond, &copy->mutex);
+    (void) pthread_mutex_unlock(&copy->mutex);
+    if (copy->stop) break;
+
+    ibuf = islab % copy->nbuffers;
+    nbytes = minc_read_slab(copy, copy->buffers[ibuf]);
+
+    (void) pthread_mutex_lock(&copy->mutex);
+    copy->nbytes[ibuf] = nbytes;
+    copy->nread = islab + 1;
+    (void) pthread_cond_broadcast(&copy->cond);
+    (void) pthread_mutex_unlock(&copy->mutex);
+  }
+
+  return NULL;
+}
+#endif
+
+int minc_raw_copy(int mincid, int imgid, long start[], long count[],
+                  minc_swap_fn_t swap_fn, FILE *stream, int nahead)
+{
+  raw_copy_t copy;
+  int is_signed, idim, ibuf, partial, status;
+  long islab, nmax;
+  size_t slab_size, nbytes;
+#ifdef HAVE_PTHREAD
+  pthread_t thread;
+  int threaded;
+#endif
+
+  copy.mincid = mincid;
+  copy.imgid = imgid;
+  (void) ncvarinq(mincid, imgid, NULL, NULL, &copy.ndims, NULL, NULL);
+  (void) miget_datatype(mincid, imgid, &copy.datatype, &is_signed);
+  copy.sign = (is_signed ? MI_SIGNED : MI_UNSIGNED);
+  copy.swap_fn = swap_fn;
+
+  /* Read whole images, and as many of them at a time as fit in a slab */
+  slab_size = nctypelen(copy.datatype);
+  copy.nslabs = 1;
+  partial = FALSE;
+  for (idim = copy.ndims - 1; idim >= 0; idim--) {
+    copy.start[idim] = start[idim];
+    copy.cur[idim] = start[idim];
+    copy.end[idim] = start[idim] + count[idim];
+    copy.slab[idim] = count[idim];
+    if (idim < copy.ndims - 2) {
+      nmax = MINC_RAW_SLAB_SIZE / slab_size;
+      if (partial || nmax < 1) nmax = 1;
+      if (copy.slab[idim] > nmax) {
+        copy.slab[idim] = nmax;
+        partial = TRUE;
+      }
+    }
+    slab_size *= copy.slab[idim];
+    copy.nslabs *= (count[idim] + copy.slab[idim] - 1) / copy.slab[idim];
+  }
+
+  /* Get the buffers */
+  copy.nbuffers = (nahead > 0) ? nahead + 1 : 1;
+  if (copy.nbuffers > copy.nslabs) copy.nbuffers = copy.nslabs;
+  if (copy.nbuffers < 1) copy.nbuffers = 1;
+  copy.buffers = malloc(copy.nbuffers * sizeof(*copy.buffers));
+  copy.nbytes = malloc(copy.nbuffers * sizeof(*copy.nbytes));
+  for (ibuf = 0; ibuf < copy.nbuffers; ibuf++) {
+    copy.buffers[ibuf] = malloc(slab_size);
+    if (copy.buffers[ibuf] == NULL) {
+      (void) fprintf(stderr, "Unable to allocate %lu bytes.\n",
+                     (unsigned long) slab_size);
+      exit(EXIT_FAILURE);
+    }
+  }
+  copy.nread = 0;
+  copy.nused = 0;
+  copy.stop = FALSE;
+
+#ifdef HAVE_PTHREAD
+  threaded = (copy.nbuffers > 1);
+  if (threaded) {
+    (void) pthread_mutex_init(&copy.mutex, NULL);
+    (void) pthread_cond_init(&copy.cond, NULL);
+    if (pthread_create(&thread, NULL, minc_read_slabs, &copy) != 0) {
+      (void) fprintf(stderr, "Unable to create reader thread.\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+#endif
+
+  /* Write out the slabs as they come in */
+  status = 0;
+  for (islab = 0; islab < copy.nslabs; islab++) {
+    ibuf = islab % copy.nbuffers;
+
+#ifdef HAVE_PTHREAD
+    if (threaded) {
+      (void) pthread_mutex_lock(&copy.mutex);
+      while (copy.nread <= islab)
+        (void) pthread_cond_wait(&copy.cond, &copy.mutex);
+      nbytes = copy.nbytes[ibuf];
+      (void) pthread_mutex_unlock(&copy.mutex);
+    }
+    else
+#endif
+    {
+      nbytes = minc_read_slab(&copy, copy.buffers[ibuf]);
+    }
+
+    if (fwrite(copy.buffers[ibuf], 1, nbytes, stream) != nbytes) {
+      status = -1;
+    }
+
+#ifdef HAVE_PTHREAD
+    if (threaded) {
+      (void) pthread_mutex_lock(&copy.mutex);
+      copy.nused = islab + 1;
+      copy.stop = (status != 0);
+      (void) pthread_cond_broadcast(&copy.cond);
+      (void) pthread_mutex_unlock(&copy.mutex);
+    }
+#endif
+
+    if (status != 0) break;
+  }
+
+#ifdef HAVE_PTHREAD
+  if (threaded) {
+    (void) pthread_join(thread, NULL);
+    (void) pthread_cond_destroy(&copy.cond);
+    (void) pthread_mutex_destroy(&copy.mutex);
+  }
+#endif
+
+  for (ibuf = 0; ibuf < copy.nbuffers; ibuf++) {
+    free(copy.buffers[ibuf]);
+  }
+  free(copy.buffers);
+  free(copy.nbytes);
+
+  return status;
+}
@@ -0,0 +1,17 @@
+#define MINC_RAW_SLAB_SIZE (4*1024*1024) /* Bytes read per call */
+
+/**
+ * Returns TRUE if reading the image variable through an icv of the given
+ * type, sign and valid range, without normalization or flipping, would
+ * give back exactly the values stored in the file.
+ */
+extern int minc_raw_copy_possible(int mincid, int imgid, nc_type datatype,
+                                  int is_signed, double valid_range[2]);
+
+/**
+ * Writes the stored values of a hyperslab of the image variable to a
+ * stream, reading up to nahead slabs ahead of the writes. Returns 0 on
+ * success and -1 if the values could not be written.
+ */
+extern int minc_raw_copy(int mincid, int imgid, long start[], long count[],
+                         minc_swap_fn_t swap_fn, FILE *stream, int nahead);
@@ -0,0 +1,526 @@
+/* Compilation of scalar expressions into flat register programs.
+
+   A program is a list of values in evaluation order. Leaf values are
+   constants, scalar symbols, elements of vector symbols at a constant
+   index, or subexpressions that are left to the tree evaluator. All
+   other values are operations on earlier values. Identical values are
+   only computed once and operations on constants are done at compile
+   time. Programs are run on a block of voxels at a time, one operation
+   at a time, so that the inner loops are simple loops over arrays.
+   Once compiled, a program is never modified so it can be shared. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <float.h>
+#include "node.h"
+
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
+#define INVALID_VALUE -DBL_MAX
+
+/* Number of voxels handled by each operation at a time */
+#define PROGRAM_BLOCK 256
+
+typedef enum {
+   VALUE_CONST,
+   VALUE_SCALAR,
+   VALUE_ELEMENT,
+   VALUE_NODE,
+   VALUE_OP
+} value_kind_t;
+
+struct value {
+   value_kind_t kind;
+   enum nodetype op;          /* VALUE_OP: operation */
+   int nargs;                 /* VALUE_OP: number of arguments */
+   int args[3];               /* VALUE_OP: indices of earlier values */
+   double real;               /* VALUE_CONST: the constant */
+   double *block;             /* VALUE_CONST: block filled with constant */
+   ident_t ident;             /* VALUE_SCALAR, VALUE_ELEMENT: symbol */
+   int index;                 /* VALUE_ELEMENT: vector index */
+   node_t node;               /* VALUE_NODE, VALUE_ELEMENT: tree node */
+   int reg;                   /* VALUE_OP: register for result */
+};
+
+struct program {
+   int nvalues;
+   int maxvalues;
+   struct value *values;
+   int result;                /* Index of value giving the result */
+   int nregs;                 /* Number of registers needed */
+};
+
+extern double value_for_illegal_operations;
+
+static int compile_value(program_t prog, node_t n);
+static int add_value(program_t prog, struct value *val);
+static void allocate_registers(program_t prog);
+static void run_program(program_t prog, long nvalues,
+                        double *sources[], double *result);
+static void apply_op(enum nodetype op, long n, double *r,
+                     const double *a, const double *b, const double *c);
+
+/* Compile a scalar expression. Subexpressions that cannot be compiled
+   are passed to optimize_node and evaluated with eval_scalar when the
+   program is run, so they must not have side effects. */
+program_t compile_program(node_t n){
+   program_t prog;
+   struct value *val;
+   int ivalue, i;
+
+   prog = malloc(sizeof *prog);
+   prog->nvalues = 0;
+   prog->maxvalues = 16;
+   prog->values = malloc(prog->maxvalues * sizeof(prog->values[0]));
+   prog->result = compile_value(prog, n);
+   allocate_registers(prog);
+
+   /* Fill a block for each constant */
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      val = &prog->values[ivalue];
+      if (val->kind == VALUE_CONST) {
+         val->block = malloc(PROGRAM_BLOCK * sizeof(val->block[0]));
+         for (i=0; i < PROGRAM_BLOCK; i++)
+            val->block[i] = val->real;
+      }
+   }
+
+   return prog;
+}
+
+/* Return TRUE if the program always gives the same value */
+int program_is_constant(program_t prog, double *value){
+   struct value *val = &prog->values[prog->result];
+
+   if (val->kind != VALUE_CONST) return FALSE;
+   *value = val->real;
+   return TRUE;
+}
+
+/* Add a node (and its arguments) to a program, returning the index of
+   its value */
+static int compile_value(program_t prog, node_t n){
+   struct value val;
+   double *args[3], result;
+   int iarg, tmp;
+
+   (void) memset(&val, 0, sizeof(val));
+   val.node = n;
+
+   /* Leave errors to the tree evaluator */
+   if (!node_is_scalar(n)) {
+      val.kind = VALUE_NODE;
+      return add_value(prog, &val);
+   }
+
+   switch (n->type) {
+   case NODETYPE_REAL:
+      val.kind = VALUE_CONST;
+      val.real = n->real;
+      return add_value(prog, &val);
+
+   case NODETYPE_IDENT:
+      val.kind = VALUE_SCALAR;
+      val.ident = n->ident;
+      return add_value(prog, &val);
+
+   case NODETYPE_INDEX:
+      n->expr[1] = optimize_node(n->expr[1]);
+      if (n->expr[0]->type == NODETYPE_IDENT &&
+          n->expr[1]->type == NODETYPE_REAL &&
+          fabs(n->expr[1]->real) < INT_MAX) {
+         val.kind = VALUE_ELEMENT;
+         val.ident = n->expr[0]->ident;
+         val.index = SCALAR_ROUND(n->expr[1]->real);
+         return add_value(prog, &val);
+      }
+      break;
+
+   default:
+      break;
+   }
+
+   /* Anything that is not a simple scalar operation is left to the
+      tree evaluator */
+   if (!(n->flags & ALLARGS_SCALAR)) {
+      val.kind = VALUE_NODE;
+      val.node = optimize_node(n);
+      return add_value(prog, &val);
+   }
+
+   val.kind = VALUE_OP;
+   val.op = n->type;
+   val.nargs = n->numargs;
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      val.args[iarg] = compile_value(prog, n->expr[iarg]);
+   }
+
+   /* Put the arguments of commutative operations in a standard order so
+      that a+b and b+a are recognized as the same value */
+   switch (val.op) {
+   case NODETYPE_ADD:
+   case NODETYPE_MUL:
+   case NODETYPE_EQ:
+   case NODETYPE_NE:
+   case NODETYPE_AND:
+   case NODETYPE_OR:
+      if (val.args[0] > val.args[1]) {
+         tmp = val.args[0];
+         val.args[0] = val.args[1];
+         val.args[1] = tmp;
+      }
+      break;
+   default:
+      break;
+   }
+
+   /* Simplifications that give exactly the same result, including for
+      invalid values: x*1, x/1, x^1 and x-0 */
+#define IS_CONST(iarg, value) \
+   (prog->values[val.args[iarg]].kind == VALUE_CONST && \
+    prog->values[val.args[iarg]].real == (value) && \
+    !signbit(prog->values[val.args[iarg]].real))
+   switch (val.op) {
+   case NODETYPE_MUL:
+      if (IS_CONST(0, 1.0)) return val.args[1];
+      if (IS_CONST(1, 1.0)) return val.args[0];
+      break;
+   case NODETYPE_DIV:
+   case NODETYPE_POW:
+      if (IS_CONST(1, 1.0)) return val.args[0];
+      break;
+   case NODETYPE_SUB:
+      if (IS_CONST(1, 0.0)) return val.args[0];
+      break;
+   default:
+      break;
+   }
+#undef IS_CONST
+
+   /* Fold operations on constants */
+   for (iarg=0; iarg < val.nargs; iarg++) {
+      if (prog->values[val.args[iarg]].kind != VALUE_CONST) break;
+      args[iarg] = &prog->values[val.args[iarg]].real;
+   }
+   if (iarg == val.nargs) {
+      for (; iarg < 3; iarg++) args[iarg] = NULL;
+      apply_op(val.op, 1, &result, args[0], args[1], args[2]);
+      (void) memset(&val, 0, sizeof(val));
+      val.kind = VALUE_CONST;
+      val.real = result;
+      val.node = n;
+   }
+
+   return add_value(prog, &val);
+}
+
+/* Add a value to a program unless it is already there */
+static int add_value(program_t prog, struct value *val){
+   struct value *old;
+   int ivalue, iarg, same;
+
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      old = &prog->values[ivalue];
+      if (old->kind != val->kind) continue;
+      switch (val->kind) {
+      case VALUE_CONST:
+         same = (memcmp(&old->real, &val->real, sizeof(val->real)) == 0);
+         break;
+      case VALUE_SCALAR:
+         same = (old->ident == val->ident);
+         break;
+      case VALUE_ELEMENT:
+         same = (old->ident == val->ident && old->index == val->index);
+         break;
+      case VALUE_OP:
+         same = (old->op == val->op && old->nargs == val->nargs);
+         for (iarg=0; same && iarg < val->nargs; iarg++)
+            same = (old->args[iarg] == val->args[iarg]);
+         break;
+      default:
+         same = FALSE;
+         break;
+      }
+      if (same) return ivalue;
+   }
+
+   if (prog->nvalues == prog->maxvalues) {
+      prog->maxvalues *= 2;
+      prog->values = realloc(prog->values,
+                             prog->maxvalues * sizeof(prog->values[0]));
+   }
+   prog->values[prog->nvalues] = *val;
+   return prog->nvalues++;
+}
+
+/* Give each operation a register, re-using registers once their value
+   is no longer needed */
+static void allocate_registers(program_t prog){
+   int *last_use, *free_regs;
+   int nfree, ivalue, iarg, arg;
+   struct value *val;
+
+   last_use = malloc(prog->nvalues * sizeof(last_use[0]));
+   free_regs = malloc(prog->nvalues * sizeof(free_regs[0]));
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      last_use[ivalue] = ivalue;
+      val = &prog->values[ivalue];
+      if (val->kind != VALUE_OP) continue;
+      for (iarg=0; iarg < val->nargs; iarg++)
+         last_use[val->args[iarg]] = ivalue;
+   }
+   last_use[prog->result] = prog->nvalues;
+
+   prog->nregs = 0;
+   nfree = 0;
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      val = &prog->values[ivalue];
+      if (val->kind != VALUE_OP) continue;
+
+      /* Operations work element by element, so the result can go in the
+         register of an argument that is not needed afterwards */
+      for (iarg=0; iarg < val->nargs; iarg++) {
+         arg = val->args[iarg];
+         if (prog->values[arg].kind == VALUE_OP && last_use[arg] == ivalue) {
+            free_regs[nfree++] = prog->values[arg].reg;
+            last_use[arg] = -1;
+         }
+      }
+      if (nfree > 0)
+         val->reg = free_regs[--nfree];
+      else
+         val->reg = prog->nregs++;
+   }
+
+   free(last_use);
+   free(free_regs);
+}
+
+/* Evaluate a compiled expression node in a scalar context */
+scalar_t eval_program(int width, int *eval_flags, node_t n, sym_t sym){
+   program_t prog = n->prog;
+   struct value *val;
+   double **sources;
+   scalar_t *nodes, s, result;
+   vector_t v;
+   int ivalue;
+
+   sources = malloc(prog->nvalues * sizeof(sources[0]));
+   nodes = malloc(prog->nvalues * sizeof(nodes[0]));
+
+   /* Find the data for the leaves */
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      val = &prog->values[ivalue];
+      sources[ivalue] = NULL;
+      nodes[ivalue] = NULL;
+      switch (val->kind) {
+      case VALUE_SCALAR:
+         s = sym_lookup_scalar(val->ident, sym);
+         sources[ivalue] = s->vals;
+         break;
+      case VALUE_ELEMENT:
+         v = sym_lookup_vector(val->ident, sym);
+         if (v == NULL) {
+            /* A scalar is treated as a vector of length one */
+            s = sym_lookup_scalar(val->ident, sym);
+            if (val->index != 0)
+               show_error(val->node->pos, "index out of bounds");
+            sources[ivalue] = s->vals;
+         }
+         else {
+            if (val->index < 0 || val->index >= v->len)
+               show_error(val->node->pos, "index out of bounds");
+            sources[ivalue] = v->el[val->index]->vals;
+         }
+         break;
+      case VALUE_NODE:
+         nodes[ivalue] = eval_scalar(width, eval_flags, val->node, sym);
+         sources[ivalue] = nodes[ivalue]->vals;
+         break;
+      default:
+         break;
+      }
+   }
+
+   result = new_scalar(width);
+   run_program(prog, (long) width, sources, result->vals);
+
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      if (nodes[ivalue] != NULL) scalar_free(nodes[ivalue]);
+   }
+   free(nodes);
+   free(sources);
+
+   return result;
+}
+
+/* Evaluate a compiled expression directly on data buffers if it only
+   uses constants and elements of the given vector, which are taken from
+   buffers. Returns FALSE (and does nothing) if the expression cannot be
+   evaluated this way. */
+int eval_program_buffers(node_t n, ident_t vector_ident, long nvalues,
+                         int nbuffers, double *buffers[], double *result){
+   program_t prog;
+   struct value *val;
+   double **sources;
+   int ivalue;
+
+   if (n->type != NODETYPE_KERNEL) return FALSE;
+   prog = n->prog;
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      val = &prog->values[ivalue];
+      if (val->kind == VALUE_SCALAR || val->kind == VALUE_NODE ||
+          (val->kind == VALUE_ELEMENT && val->ident != vector_ident))
+         return FALSE;
+   }
+
+   sources = malloc(prog->nvalues * sizeof(sources[0]));
+   for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+      val = &prog->values[ivalue];
+      sources[ivalue] = NULL;
+      if (val->kind == VALUE_ELEMENT) {
+         if (val->index < 0 || val->index >= nbuffers)
+            show_error(val->node->pos, "index out of bounds");
+         sources[ivalue] = buffers[val->index];
+      }
+   }
+   run_program(prog, nvalues, sources, result);
+   free(sources);
+
+   return TRUE;
+}
+
+/* Run a program over nvalues voxels given the data for each leaf */
+static void run_program(program_t prog, long nvalues,
+                        double *sources[], double *result){
+   double *regs, **data, *args[3];
+   struct value *val;
+   long start, n;
+   int ivalue, iarg, last;
+
+   regs = malloc((prog->nregs * PROGRAM_BLOCK + 1) * sizeof(regs[0]));
+   data = malloc(prog->nvalues * sizeof(data[0]));
+
+   /* The last operation can write straight into the result if it gives
+      the result */
+   last = prog->nvalues - 1;
+
+   for (start=0; start < nvalues; start += PROGRAM_BLOCK) {
+      n = nvalues - start;
+      if (n > PROGRAM_BLOCK) n = PROGRAM_BLOCK;
+
+      for (ivalue=0; ivalue < prog->nvalues; ivalue++) {
+         val = &prog->values[ivalue];
+         switch (val->kind) {
+         case VALUE_CONST:
+            data[ivalue] = val->block;
+            break;
+         case VALUE_OP:
+            for (iarg=0; iarg < 3; iarg++)
+               args[iarg] = (iarg < val->nargs) ? data[val->args[iarg]] : NULL;
+            if (ivalue == last && ivalue == prog->result)
+               data[ivalue] = result + start;
+            else
+               data[ivalue] = regs + val->reg * PROGRAM_BLOCK;
+            apply_op(val->op, n, data[ivalue], args[0], args[1], args[2]);
+            break;
+         default:
+            data[ivalue] = sources[ivalue] + start;
+            break;
+         }
+      }
+
+      if (data[prog->result] != result + start) {
+         (void) memcpy(result + start, data[prog->result],
+                       n * sizeof(result[0]));
+      }
+   }
+
+   free(data);
+   free(regs);
+}
+
+/* Loops for operations with one, two or three arguments. Any invalid
+   argument gives an invalid result. */
+#define UNARY_OP(expr) \
+   for (i=0; i < n; i++) { \
+      if (a[i] == INVALID_VALUE) r[i] = INVALID_VALUE; \
+      else r[i] = (expr); \
+   } \
+   break
+
+#define BINARY_OP(expr) \
+   for (i=0; i < n; i++) { \
+      if (a[i] == INVALID_VALUE || b[i] == INVALID_VALUE) \
+         r[i] = INVALID_VALUE; \
+      else r[i] = (expr); \
+   } \
+   break
+
+#define TERNARY_OP(expr) \
+   for (i=0; i < n; i++) { \
+      if (a[i] == INVALID_VALUE || b[i] == INVALID_VALUE || \
+          c[i] == INVALID_VALUE) \
+         r[i] = INVALID_VALUE; \
+      else r[i] = (expr); \
+   } \
+   break
+
+/* Apply a scalar operation to n values. This must give the same results
+   as the ALLARGS_SCALAR case of eval_scalar. The result may be the same
+   array as one of the arguments. */
+static void apply_op(enum nodetype op, long n, double *r,
+                     const double *a, const double *b, const double *c){
+   double illegal = value_for_illegal_operations;
+   long i;
+
+   switch (op) {
+   case NODETYPE_ADD:  BINARY_OP(a[i] + b[i]);
+   case NODETYPE_SUB:  BINARY_OP(a[i] - b[i]);
+   case NODETYPE_MUL:  BINARY_OP(a[i] * b[i]);
+   case NODETYPE_DIV:  BINARY_OP(b[i] == 0.0 ? illegal : a[i] / b[i]);
+   case NODETYPE_LT:   BINARY_OP(a[i] < b[i]);
+   case NODETYPE_LE:   BINARY_OP(a[i] <= b[i]);
+   case NODETYPE_GT:   BINARY_OP(a[i] > b[i]);
+   case NODETYPE_GE:   BINARY_OP(a[i] >= b[i]);
+   case NODETYPE_EQ:   BINARY_OP(a[i] == b[i]);
+   case NODETYPE_NE:   BINARY_OP(a[i] != b[i]);
+   case NODETYPE_NOT:  UNARY_OP(a[i] == 0.0);
+   case NODETYPE_AND:  BINARY_OP((a[i] != 0.0) && (b[i] != 0.0));
+   case NODETYPE_OR:   BINARY_OP((a[i] != 0.0) || (b[i] != 0.0));
+   case NODETYPE_POW:  BINARY_OP(pow(a[i], b[i]));
+   case NODETYPE_SQRT: UNARY_OP(a[i] < 0.0 ? illegal : sqrt(a[i]));
+   case NODETYPE_ABS:  UNARY_OP(fabs(a[i]));
+   case NODETYPE_EXP:  UNARY_OP(exp(a[i]));
+   case NODETYPE_LOG:  UNARY_OP(a[i] <= 0.0 ? illegal : log(a[i]));
+   case NODETYPE_SIN:  UNARY_OP(sin(a[i]));
+   case NODETYPE_COS:  UNARY_OP(cos(a[i]));
+   case NODETYPE_TAN:  UNARY_OP(tan(a[i]));
+   case NODETYPE_ASIN: UNARY_OP(asin(a[i]));
+   case NODETYPE_ACOS: UNARY_OP(acos(a[i]));
+   case NODETYPE_ATAN: UNARY_OP(atan(a[i]));
+   case NODETYPE_CLAMP:
+      TERNARY_OP(a[i] < b[i] ? b[i] : (a[i] > c[i] ? c[i] : a[i]));
+   case NODETYPE_SEGMENT:
+      TERNARY_OP((a[i] >= b[i] && a[i] <= c[i]) ? 1.0 : 0.0);
+
+   case NODETYPE_ISNAN:
+      for (i=0; i < n; i++)
+         r[i] = (a[i] == INVALID_VALUE) ? 1.0 : 0.0;
+      break;
+
+   default:
+      (void) fprintf(stderr, "Internal error: unknown operation %d\n",
+                     (int) op);
+      exit(1);
+   }
+}
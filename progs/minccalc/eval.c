@@ -342,6 +342,9 @@ scalar_t eval_scalar(int width, int *eval_flags, node_t n, sym_t sym){
    case NODETYPE_FOR:
       return for_loop(width, eval_flags, n, sym);
 
+   case NODETYPE_KERNEL:
+      return eval_program(width, eval_flags, n, sym);
+
    case NODETYPE_IDENT:
       s = sym_lookup_scalar(n->ident, sym);
       if (s == NULL) {
@@ -117,6 +117,9 @@ Mon May 21 01:01:01 EST 2000 - Original version "imgcalc" by David Leonard
 #include <float.h>
 #include <limits.h>
 #include <math.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include <ParseArgv.h>
 #include <voxel_loop.h>
 #include <time_stamp.h>
@@ -138,7 +141,32 @@ Mon May 21 01:01:01 EST 2000 - Original version "imgcalc" by David Leonard
 #define DEFAULT_DBL DBL_MAX
 #define DEFAULT_BOOL -1
 
+/* Evaluation state. Each thread has its own symbol table, with its own
+   copies of the input vector and the output symbols. */
+typedef struct {
+   sym_t sym;                /* Symbol table */
+   vector_t A;               /* Input values (held in sym) */
+   scalar_t *output_values;  /* Output symbols (held in sym) or NULL */
+} Calc_State;
+
+/* Range of values in the voxel_loop buffers given to one thread */
+typedef struct {
+   Calc_State *state;
+   long start;
+   long end;
+   int input_num_buffers;
+   double **input_data;
+   double **output_data;
+} Calc_Work;
+
 /* Function prototypes */
+static void create_calc_state(Calc_State *state, int nfiles, 
+                              ident_t output_idents[]);
+static void delete_calc_state(Calc_State *state);
+static void calc_values(Calc_Work *work);
+#ifdef HAVE_PTHREAD
+static void *calc_thread(void *arg);
+#endif
 static void do_math(void *caller_data, long num_voxels, 
                     int input_num_buffers, 
                     int input_vector_length, double *input_data[],
@@ -170,6 +198,7 @@ static char *filelist = NULL;
 static char *expr_file = NULL;
 char *expression = NULL;
 static int eval_width = 200;
+static int nthreads = 1;
 #if MINC2
 static int minc2_format = FALSE;
 #endif /* MINC2 */
@@ -250,13 +279,14 @@ ArgvInfo argTable[] = {
           "Symbol to save in an output file (2 args)."}, 
    {"-eval_width",  ARGV_INT,  (char*)1,    (char*) &eval_width,
           "Number of voxels to evaluate simultaneously."}, 
+   {"-threads",  ARGV_INT,  (char*)1,    (char*) &nthreads,
+          "Number of threads used to evaluate the expression (default 1)."}, 
    {NULL, ARGV_END, NULL, NULL, NULL}
 };
 
 extern int yydebug;
-sym_t      rootsym;
-vector_t   A;
-scalar_t   *Output_values;
+static ident_t A_ident;
+static Calc_State *Calc_states;
 
 /* Main program */
 int main(int argc, char *argv[]){
@@ -266,8 +296,7 @@ int main(int argc, char *argv[]){
    Loop_Options *loop_options;
    char *pname;
    int i;
-   ident_t ident;
-   scalar_t scalar;
+   ident_t *output_idents;
 
    /* Save time stamp and args */
    arg_string = time_stamp(argc, argv);
@@ -351,46 +380,41 @@ int main(int argc, char *argv[]){
    yyparse();
    lex_finalize();
    
-   /* Optimize the expression tree */
-   root = optimize(root);
-   
-   /* Setup the input vector from the input files */
-   A = new_vector();
-   for (i=0; i<nfiles; i++) {
-      if (debug) fprintf(stderr,"Getting file[%d] %s\n", i, argv[i+1]);
-      scalar = new_scalar(eval_width);
-      vector_append(A, scalar);
-      scalar_free(scalar);
-   }
-      
-   /* Construct initial symbol table from the A vector. Since setting
-      a symbol makes a copy, we have to get a handle to that copy. */
-   rootsym = sym_enter_scope(NULL);
-   ident = new_ident("A");
-   sym_set_vector(eval_width, NULL, A, ident, rootsym);
-   vector_free(A);
-   A = sym_lookup_vector(ident, rootsym);
-   if (A==NULL) {
-      (void) fprintf(stderr, "Error initializing symbol table\n");
+   /* Check the number of threads */
+   if (nthreads < 1) {
+      (void) fprintf(stderr, "Number of threads must be at least 1.\n");
       exit(EXIT_FAILURE);
    }
-   vector_incr_ref(A);
+#ifndef HAVE_PTHREAD
+   if (nthreads > 1) {
+      (void) fprintf(stderr, 
+                     "Warning: no thread support, ignoring -threads.\n");
+      nthreads = 1;
+   }
+#endif
 
-   /* Add output symbols to the table */
+   /* Get the output symbols */
+   A_ident = new_ident("A");
    if (Output_list == NULL) {
-      Output_values = NULL;
+      output_idents = NULL;
    }
    else {
-      Output_values = malloc(Output_list_size * sizeof(*Output_values));
+      output_idents = malloc(Output_list_size * sizeof(*output_idents));
       for (i=0; i < Output_list_size; i++) {
-         ident = ident_lookup(Output_list[i].symbol);
-         scalar = new_scalar(eval_width);
-         sym_set_scalar(eval_width, NULL, scalar, ident, rootsym);
-         scalar_free(scalar);
-         Output_values[i] = sym_lookup_scalar(ident, rootsym);
+         output_idents[i] = ident_lookup(Output_list[i].symbol);
       }
    }
 
+   /* Set up the symbol table for each thread */
+   if (debug) {
+      for (i=0; i<nfiles; i++)
+         (void) fprintf(stderr,"Getting file[%d] %s\n", i, argv[i+1]);
+   }
+   Calc_states = malloc(nthreads * sizeof(*Calc_states));
+   for (i=0; i < nthreads; i++) {
+      create_calc_state(&Calc_states[i], nfiles, output_idents);
+   }
+
    /* Set default copy_all_header according to number of input files */
    if (copy_all_header == DEFAULT_BOOL)
       copy_all_header = (nfiles == 1);
@@ -402,6 +426,12 @@ int main(int argc, char *argv[]){
          value_for_illegal_operations = 0.0;
    }
 
+   /* Optimize the expression tree. This needs the value for illegal
+      operations for constant folding and the output symbols so that 
+      assignments to them are kept. */
+   root = optimize(root, (Output_list == NULL ? 0 : Output_list_size), 
+                   output_idents);
+
    /* Do math */
    loop_options = create_loop_options();
    set_loop_verbose(loop_options, verbose);
@@ -425,23 +455,106 @@ int main(int argc, char *argv[]){
 
    
    /* Clean up */
-   vector_free(A);
-   sym_leave_scope(rootsym);
+   for (i=0; i < nthreads; i++) {
+      delete_calc_state(&Calc_states[i]);
+   }
+   free(Calc_states);
    if (expr_file != NULL) free(expression);
    free(outfiles);
    if (Output_list != NULL) free(Output_list);
-   if (Output_values != NULL) free(Output_values);
+   if (output_idents != NULL) free(output_idents);
    exit(EXIT_SUCCESS);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_calc_state
+@INPUT      : nfiles - number of input files
+              output_idents - identifiers of output symbols (NULL if the
+                 value of the expression is written out)
+@OUTPUT     : state - new evaluation state
+@RETURNS    : (nothing)
+@DESCRIPTION: Sets up a symbol table holding the input vector A and the
+              output symbols.
+@METHOD     : 
+@GLOBALS    : eval_width, A_ident, Output_list_size
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void create_calc_state(Calc_State *state, int nfiles, 
+                              ident_t output_idents[])
+{
+   vector_t A;
+   scalar_t scalar;
+   int i;
+
+   /* Setup the input vector from the input files */
+   A = new_vector();
+   for (i=0; i<nfiles; i++) {
+      scalar = new_scalar(eval_width);
+      vector_append(A, scalar);
+      scalar_free(scalar);
+   }
+      
+   /* Construct initial symbol table from the A vector. Since setting
+      a symbol makes a copy, we have to get a handle to that copy. */
+   state->sym = sym_enter_scope(NULL);
+   sym_set_vector(eval_width, NULL, A, A_ident, state->sym);
+   vector_free(A);
+   state->A = sym_lookup_vector(A_ident, state->sym);
+   if (state->A == NULL) {
+      (void) fprintf(stderr, "Error initializing symbol table\n");
+      exit(EXIT_FAILURE);
+   }
+   vector_incr_ref(state->A);
+
+   /* Add output symbols to the table */
+   if (output_idents == NULL) {
+      state->output_values = NULL;
+   }
+   else {
+      state->output_values = 
+         malloc(Output_list_size * sizeof(*state->output_values));
+      for (i=0; i < Output_list_size; i++) {
+         scalar = new_scalar(eval_width);
+         sym_set_scalar(eval_width, NULL, scalar, output_idents[i], 
+                        state->sym);
+         scalar_free(scalar);
+         state->output_values[i] = 
+            sym_lookup_scalar(output_idents[i], state->sym);
+      }
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_calc_state
+@INPUT      : state - evaluation state
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Frees an evaluation state.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void delete_calc_state(Calc_State *state)
+{
+   vector_free(state->A);
+   sym_leave_scope(state->sym);
+   if (state->output_values != NULL) free(state->output_values);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : do_math
 @INPUT      : Standard for voxel loop
 @OUTPUT     : Standard for voxel loop
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine doing math operations.
-@METHOD     : 
-@GLOBALS    : Output_values, A
+@METHOD     : The values are split into one range per thread (in whole
+              multiples of eval_width, so that each thread evaluates the
+              same groups of voxels as a single thread would).
+@GLOBALS    : Calc_states, nthreads, eval_width
 @CALLS      : 
 @CREATED    : April 25, 1995 (Peter Neelin)
 @MODIFIED   : Thu Dec 21 17:08:40 EST 2000 (Andrew Janke - a.janke@gmail.com)
@@ -452,10 +565,13 @@ static void do_math(void *caller_data, long num_voxels,
                     int output_num_buffers, int output_vector_length,
                     double *output_data[],
                     Loop_Info *loop_info){
-   long ivox, ibuff, ivalue, nvox;
-   scalar_t scalar, *output_scalars;
-   int num_output, iout;
+   Calc_Work *work;
    long total_values;  /* Total # of values to process in this call */
+   long values_per_thread;
+   int ithread;
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+#endif
 
    /* Check arguments */
    if ((output_num_buffers < 1) || 
@@ -466,18 +582,113 @@ static void do_math(void *caller_data, long num_voxels,
 
    total_values = num_voxels * input_vector_length;
 
+   /* Divide up the values */
+   values_per_thread = (total_values + nthreads - 1) / nthreads;
+   values_per_thread = 
+      ((values_per_thread + eval_width - 1) / eval_width) * eval_width;
+   work = malloc(nthreads * sizeof(*work));
+   for (ithread=0; ithread < nthreads; ithread++) {
+      work[ithread].state = &Calc_states[ithread];
+      work[ithread].start = ithread * values_per_thread;
+      work[ithread].end = work[ithread].start + values_per_thread;
+      if (work[ithread].start > total_values) 
+         work[ithread].start = total_values;
+      if (work[ithread].end > total_values) 
+         work[ithread].end = total_values;
+      work[ithread].input_num_buffers = input_num_buffers;
+      work[ithread].input_data = input_data;
+      work[ithread].output_data = output_data;
+   }
+
+#ifdef HAVE_PTHREAD
+   /* The first range is done by this thread while the others run */
+   if (nthreads > 1) {
+      threads = malloc(nthreads * sizeof(*threads));
+      for (ithread=1; ithread < nthreads; ithread++) {
+         if (pthread_create(&threads[ithread], NULL, 
+                            calc_thread, &work[ithread]) != 0) {
+            (void) fprintf(stderr, "Unable to start thread.\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+      calc_values(&work[0]);
+      for (ithread=1; ithread < nthreads; ithread++) {
+         (void) pthread_join(threads[ithread], NULL);
+      }
+      free(threads);
+   }
+   else
+#endif
+   {
+      calc_values(&work[0]);
+   }
+
+   free(work);
+
+   return;
+}
+
+#ifdef HAVE_PTHREAD
+/* Thread entry point for calc_values */
+static void *calc_thread(void *arg)
+{
+   calc_values((Calc_Work *) arg);
+   return NULL;
+}
+#endif
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : calc_values
+@INPUT      : work - range of values and buffers to use
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Evaluates the expression for a range of the voxel_loop 
+              buffers, eval_width values at a time, using the symbol 
+              table of the given state.
+@METHOD     : 
+@GLOBALS    : root, A_ident, eval_width, Output_list_size
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void calc_values(Calc_Work *work)
+{
+   Calc_State *state = work->state;
+   long ivox, ibuff, ivalue, nvox;
+   scalar_t scalar, *output_scalars;
+   int num_output, iout;
+   double **inputs;
+
+   if (work->start >= work->end) return;
+
+   /* An expression that only uses the input values (and was compiled
+      into a single program) can work on the whole range at once */
+   if (state->output_values == NULL) {
+      inputs = malloc(work->input_num_buffers * sizeof(*inputs));
+      for (ibuff=0; ibuff < work->input_num_buffers; ibuff++)
+         inputs[ibuff] = work->input_data[ibuff] + work->start;
+      if (eval_program_buffers(root, A_ident, work->end - work->start, 
+                               work->input_num_buffers, inputs,
+                               work->output_data[0] + work->start)) {
+         free(inputs);
+         return;
+      }
+      free(inputs);
+   }
+
    /* Loop through the voxels */
-   for (ivox=0; ivox < total_values; ivox+=eval_width) {
+   for (ivox=work->start; ivox < work->end; ivox+=eval_width) {
 
       /* Figure out how many voxels to work on at once */
       nvox = eval_width;
-      if (ivox + nvox > total_values) 
-          nvox = total_values - ivox;
+      if (ivox + nvox > work->end) 
+          nvox = work->end - ivox;
       
       /* Copy the data into the A vector */
       for (ivalue=0; ivalue < nvox; ivalue++) {
-         for (ibuff=0; ibuff < input_num_buffers; ibuff++){
-            A->el[ibuff]->vals[ivalue] = input_data[ibuff][ivox+ivalue];
+         for (ibuff=0; ibuff < work->input_num_buffers; ibuff++){
+            state->A->el[ibuff]->vals[ivalue] = 
+               work->input_data[ibuff][ivox+ivalue];
          }
       }
 
@@ -487,22 +698,22 @@ static void do_math(void *caller_data, long num_voxels,
       }
 
       /* Evaluate the expression */
-      scalar = eval_scalar((int) nvox, NULL, root, rootsym);
+      scalar = eval_scalar((int) nvox, NULL, root, state->sym);
 
       /* Get the list of scalar values to write out */
-      if (Output_values == NULL) {
+      if (state->output_values == NULL) {
          num_output = 1;
          output_scalars = &scalar;
       }
       else {
          num_output = Output_list_size;
-         output_scalars = Output_values;
+         output_scalars = state->output_values;
       }
 
       /* Copy the scalar values into the right buffers */
       for (iout=0; iout < num_output; iout++) {
          for (ivalue=0; ivalue < nvox; ivalue++) {
-            output_data[iout][ivox+ivalue] = 
+            work->output_data[iout][ivox+ivalue] = 
                output_scalars[iout]->vals[ivalue];
          }
       }
@@ -511,7 +722,7 @@ static void do_math(void *caller_data, long num_voxels,
       scalar_free(scalar);
 
       if (debug) {
-         (void) printf("Voxel result = %g\n", output_data[0][ivox]);
+         (void) printf("Voxel result = %g\n", work->output_data[0][ivox]);
       }
          
 
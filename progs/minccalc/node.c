@@ -52,6 +52,7 @@ nodenames[] = {
         { NODETYPE_ASSIGN,   "assign" },
         { NODETYPE_IFELSE,   "ifelse" },
         { NODETYPE_FOR,      "for" },
+        { NODETYPE_KERNEL,   "kernel" },
         { (enum nodetype) 0, NULL }
 };
 
@@ -60,6 +61,7 @@ node_t new_node(int numargs, int is_scalar) {
    n = malloc(sizeof *n);
    n->numargs = numargs;
    n->flags = 0;
+   n->prog = NULL;
    if (is_scalar) {
       n->flags |= NODE_IS_SCALAR;
    }
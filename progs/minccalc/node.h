@@ -4,12 +4,14 @@ struct node;
 struct scalar;
 struct vector;
 struct sym;
+struct program;
 
 typedef int      ident_t;
 typedef struct node    *node_t;
 typedef struct scalar  *scalar_t;
 typedef struct vector  *vector_t;
 typedef struct sym     *sym_t;
+typedef struct program *program_t;
 
 #define SCALAR_ROUND(s)   (floor(s + 0.5))
 
@@ -73,7 +75,8 @@ enum nodetype {
    NODETYPE_EXPRLIST,
    NODETYPE_ASSIGN,
    NODETYPE_IFELSE,
-   NODETYPE_FOR
+   NODETYPE_FOR,
+   NODETYPE_KERNEL
 };
 
 #define RANGE_EXACT_UPPER   1
@@ -89,6 +92,7 @@ struct node {
    double real;
    int   pos;
    int   numargs;
+   program_t prog;
 };
 
 ident_t       new_ident(const char *);
@@ -101,7 +105,8 @@ node_t      new_scalar_node(int);
 node_t      new_vector_node(int);
 const char *   node_name(node_t);
 int         node_is_scalar(node_t);
-node_t      optimize(node_t);
+node_t      optimize(node_t, int, ident_t *);
+node_t      optimize_node(node_t);
 
 vector_t    new_vector(void);
 void        vector_append(vector_t, scalar_t);
@@ -124,6 +129,10 @@ void       lex_init(const char *);
 void       lex_finalize(void);
 
 scalar_t   eval_scalar(int, int *, node_t, sym_t);
+scalar_t   eval_program(int, int *, node_t, sym_t);
+int        eval_program_buffers(node_t, ident_t, long, int, double **, double *);
+program_t  compile_program(node_t);
+int        program_is_constant(program_t, double *);
 void       show_error(int, const char *);
 
 int      yyparse(void);
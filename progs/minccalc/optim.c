@@ -1,5 +1,195 @@
+/* Copyright David Leonard & Andrew Janke, 2000. All rights reserved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
 #include "node.h"
 
-node_t optimize(node_t root){
-   return root;
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
+#define INVALID_VALUE -DBL_MAX
+
+extern int debug;
+extern double value_for_illegal_operations;
+
+static int max_ident(node_t n);
+static void mark_used_idents(node_t n, char *used);
+static int has_side_effects(node_t n);
+static node_t remove_dead_code(node_t n, char *used);
+static node_t new_real_node(double value, int pos);
+
+/* Optimize an expression tree. The live identifiers are symbols whose
+   values are used after evaluation (output symbols). Nothing is done
+   when debugging so that the debug output follows the expression as
+   written. */
+node_t optimize(node_t root, int nlive, ident_t live[]){
+   char *used;
+   int nidents, i;
+
+   if (debug || root == NULL) return root;
+
+   /* Find the symbols that are ever read */
+   nidents = max_ident(root) + 1;
+   for (i=0; i < nlive; i++) {
+      if (live[i] >= nidents) nidents = live[i] + 1;
+   }
+   used = calloc(nidents, sizeof(*used));
+   mark_used_idents(root, used);
+   for (i=0; i < nlive; i++) {
+      if (live[i] >= 0) used[live[i]] = TRUE;
+   }
+
+   root = remove_dead_code(root, used);
+   free(used);
+
+   return optimize_node(root);
+}
+
+/* Fold constants and compile scalar operations into programs */
+node_t optimize_node(node_t n){
+   node_t branch;
+   double value;
+   int iarg;
+
+   if (n->type == NODETYPE_KERNEL) return n;
+
+   /* Compile simple scalar operations (with their arguments). The
+      arguments must not change any symbols, since the order in which
+      they are evaluated is not kept. */
+   if ((n->flags & ALLARGS_SCALAR) && !has_side_effects(n)) {
+      for (iarg=0; iarg < n->numargs; iarg++) {
+         if (!node_is_scalar(n->expr[iarg])) break;
+      }
+      if (iarg == n->numargs) {
+         n->prog = compile_program(n);
+         if (program_is_constant(n->prog, &value)) {
+            return new_real_node(value, n->pos);
+         }
+         n->type = NODETYPE_KERNEL;
+         n->flags &= ~ALLARGS_SCALAR;
+         return n;
+      }
+   }
+
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      n->expr[iarg] = optimize_node(n->expr[iarg]);
+   }
+
+   /* Choose the branch of an if with a constant test, as long as the
+      other branch would not have changed any symbols */
+   if (n->type == NODETYPE_IFELSE && n->expr[0]->type == NODETYPE_REAL) {
+      value = n->expr[0]->real;
+      if (value == INVALID_VALUE) {
+         if (node_is_scalar(n) &&
+             (n->numargs < 3 || !has_side_effects(n->expr[2]))) {
+            return new_real_node(value_for_illegal_operations, n->pos);
+         }
+      }
+      else if (value != 0.0) {
+         if (n->numargs < 3 || !has_side_effects(n->expr[2]))
+            return n->expr[1];
+      }
+      else if (!has_side_effects(n->expr[1])) {
+         if (n->numargs > 2)
+            return n->expr[2];
+         else if (node_is_scalar(n))
+            return new_real_node(0.0, n->pos);
+      }
+   }
+
+   return n;
+}
+
+/* Remove expressions whose values are never used and assignments to
+   symbols that are never read */
+static node_t remove_dead_code(node_t n, char *used){
+   node_t first;
+   int iarg;
+
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      n->expr[iarg] = remove_dead_code(n->expr[iarg], used);
+   }
+
+   /* The value of an assignment is the assigned value */
+   if (n->type == NODETYPE_ASSIGN && !used[n->ident]) {
+      return n->expr[0];
+   }
+
+   /* The value of the first expression of a list is thrown away */
+   if (n->type == NODETYPE_EXPRLIST) {
+      first = n->expr[0];
+      if (!has_side_effects(first)) {
+         return n->expr[1];
+      }
+   }
+
+   return n;
+}
+
+/* Get the largest identifier in a tree */
+static int max_ident(node_t n){
+   int iarg, id, maxid;
+
+   maxid = -1;
+   switch (n->type) {
+   case NODETYPE_IDENT:
+   case NODETYPE_ASSIGN:
+   case NODETYPE_LET:
+   case NODETYPE_GEN:
+   case NODETYPE_FOR:
+      maxid = n->ident;
+      break;
+   default:
+      break;
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      id = max_ident(n->expr[iarg]);
+      if (id > maxid) maxid = id;
+   }
+   return maxid;
+}
+
+/* Mark every identifier that is read somewhere in a tree */
+static void mark_used_idents(node_t n, char *used){
+   int iarg;
+
+   if (n->type == NODETYPE_IDENT) used[n->ident] = TRUE;
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      mark_used_idents(n->expr[iarg], used);
+   }
+}
+
+/* Return TRUE if evaluating a tree can change the symbol table */
+static int has_side_effects(node_t n){
+   int iarg;
+
+   switch (n->type) {
+   case NODETYPE_ASSIGN:
+   case NODETYPE_LET:
+   case NODETYPE_GEN:
+   case NODETYPE_FOR:
+      return TRUE;
+   default:
+      break;
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      if (has_side_effects(n->expr[iarg])) return TRUE;
+   }
+   return FALSE;
+}
+
+static node_t new_real_node(double value, int pos){
+   node_t n;
+
+   n = new_scalar_node(0);
+   n->type = NODETYPE_REAL;
+   n->real = value;
+   n->pos = pos;
+   return n;
 }
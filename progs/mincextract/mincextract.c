@@ -8,7 +8,7 @@
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : June 10, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
  * $Log: mincextract.c,v $
  * Revision 6.9  2008-01-17 02:33:02  rotor
  *  * removed all rcsids
@@ -115,6 +115,7 @@
 #include <ctype.h>
 #include <ParseArgv.h>
 #include <minc_endian.h>
+#include <minc_rawcopy.h>
 
 /* Constants */
 #ifndef TRUE
@@ -130,6 +131,7 @@
 #define TYPE_FLOAT  4
 #define TYPE_DOUBLE 5
 #define TYPE_FILE   6
+#define DEF_READ_AHEAD 2
 static nc_type nc_type_list[8] = {
    NC_DOUBLE, NC_BYTE, NC_SHORT, NC_INT, NC_FLOAT, NC_DOUBLE, NC_DOUBLE
 };
@@ -151,6 +153,7 @@ static int xdirection = INT_MAX;
 static int ydirection = INT_MAX;
 static int zdirection = INT_MAX;
 static int default_direction = INT_MAX;
+static int read_ahead = DEF_READ_AHEAD;
 
 /* Argument table */
 ArgvInfo argTable[] = {
@@ -230,6 +233,8 @@ ArgvInfo argTable[] = {
    {"-zanydirection", ARGV_CONSTANT, (char *) MI_ICV_ANYDIR, 
        (char *) &zdirection,
        "Don't flip images along z-axis (default)."},
+   {"-read_ahead", ARGV_INT, (char *) 1, (char *) &read_ahead,
+       "Number of slabs to read ahead while writing unconverted data."},
    {NULL, ARGV_END, NULL, NULL, NULL}
 };
 
@@ -268,6 +273,20 @@ int main(int argc, char *argv[])
       normalize_output = TRUE;
    }
 
+   /* Check the number of slabs to read ahead */
+   if (read_ahead < 0) {
+      (void) fprintf(stderr, 
+                     "Number of slabs to read ahead must not be negative.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if (read_ahead != DEF_READ_AHEAD && read_ahead > 0) {
+      (void) fprintf(stderr, 
+                     "Warning: no thread support, ignoring -read_ahead.\n");
+   }
+   read_ahead = 0;
+#endif
+
    /* Check direction values */
    if (default_direction == INT_MAX)
       default_direction = MI_ICV_ANYDIR;
@@ -394,11 +413,30 @@ int main(int argc, char *argv[])
    }
    element_size = nctypelen(output_datatype);
 
+   swap_fn = minc_get_swap_function(output_endian, element_size);
+
+   /* If the stored values would come out unchanged, copy them straight
+      to the output without an icv, in as few reads as possible */
+   if ((arg_odatatype != TYPE_ASCII) && !normalize_output &&
+       (xdirection == MI_ICV_ANYDIR) && (ydirection == MI_ICV_ANYDIR) &&
+       (zdirection == MI_ICV_ANYDIR) &&
+       minc_raw_copy_possible(mincid, imgid, output_datatype, output_signed,
+                              valid_range)) {
+      for (idim=0; idim < ndims; idim++)
+         count[idim] = end[idim] - start[idim];
+      if (minc_raw_copy(mincid, imgid, start, count, swap_fn, stdout, 
+                        read_ahead) != 0) {
+         (void) fprintf(stderr, "Error writing data.\n");
+         exit(EXIT_FAILURE);
+      }
+      (void) miclose(mincid);
+      (void) miicv_free(icvid);
+      exit(EXIT_SUCCESS);
+   }
+
    /* Allocate space */
    data = malloc(element_size*nelements);
 
-   swap_fn = minc_get_swap_function(output_endian, element_size);
-
    /* Loop over input slices */
 
    while (cur[0] < end[0]) {
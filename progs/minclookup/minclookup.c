@@ -93,6 +93,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 #include <math.h>
 #include <float.h>
 #include <minc.h>
@@ -108,6 +109,11 @@
 #define DEFAULT_RANGE DBL_MAX
 #define NCOPTS_DEFAULT NC_VERBOSE | NC_FATAL
 
+/* Number of search bins per table entry and largest direct index for 
+   discrete tables */
+#define BINS_PER_ENTRY 4
+#define MAX_DIRECT_ENTRIES 65536
+
 /* Types */
 typedef enum {LU_TABLE, LU_GRAY, LU_HOTMETAL, LU_SPECTRAL} Lookup_Type;
 
@@ -117,6 +123,13 @@ typedef struct {
    int vector_length;
    double *table;
    int free_data;
+   int nbins;                   /* Bins of a uniform grid over the keys, */
+   double bin_origin;           /* giving the first entry to try for */
+   double bin_scale;            /* each bin */
+   int *bin_entry;
+   long direct_min;             /* Table row for each integer from */
+   long ndirect;                /* direct_min (NULL if none) for */
+   double **direct_entry;       /* discrete tables */
 } Lookup_Table;
 
 /* Structure for lookup information */
@@ -140,6 +153,9 @@ static double *get_values_from_string(char *string, int array_size,
                                       double *array, int *nread);
 static double *get_null_value(int vector_length, char *null_value_string);
 static void get_full_range(int mincid, double lookup_range[2]);
+static void setup_lookup_index(Lookup_Table *lookup_table, 
+                               int discrete_values);
+static void free_lookup_index(Lookup_Table *lookup_table);
 static void do_lookup(void *caller_data, long num_voxels,
                       int input_num_buffers, int input_vector_length,
                       double *input_data[],
@@ -148,6 +164,8 @@ static void do_lookup(void *caller_data, long num_voxels,
 static void lookup_in_table(double index, Lookup_Table *lookup_table,
                             int discrete_values, double null_value[],
                             double output_value[]);
+static int find_table_entry(double index, Lookup_Table *lookup_table);
+static int search_table(double index, Lookup_Table *lookup_table);
 static char *get_next_line(char *line, int linelen, FILE *fp, char **string);
 static int sorting_function(const void *value1, const void *value2);
 
@@ -340,6 +358,9 @@ int main(int argc, char *argv[])
       }
    }
 
+   /* Set up the index for searching the table */
+   setup_lookup_index(lookup_data.lookup_table, discrete_lookup);
+
    /* Get the null value */
    lookup_data.null_value = 
       get_null_value(lookup_data.lookup_table->vector_length, 
@@ -382,6 +403,7 @@ int main(int argc, char *argv[])
 
    /* Free stuff */
    if (lookup_data.null_value != NULL) free(lookup_data.null_value);
+   free_lookup_index(lookup_data.lookup_table);
    if (lookup_data.lookup_table->free_data) {
       free(lookup_data.lookup_table->table);
       free(lookup_data.lookup_table);
@@ -810,6 +832,123 @@ static void get_full_range(int mincid, double range[2])
    return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : setup_lookup_index
+@INPUT      : lookup_table - the lookup table
+              discrete_values - flag indicating whether the table is
+                 discrete (see lookup_in_table)
+@OUTPUT     : lookup_table - the lookup table with its search index
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to set up an index for finding entries in the table 
+              without a binary search. The keys are split into uniform
+              bins giving the entry to try first for each bin. For 
+              discrete tables with integer keys over a small range, the 
+              table row for every integer in the range is also stored so
+              that no search is needed at all.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void setup_lookup_index(Lookup_Table *lookup_table, 
+                               int discrete_values)
+{
+   int vector_length, nentries, stride;
+   int ientry, ibin, nbins, have_integer;
+   long idirect;
+   double *table, first, last, key, key_min, key_max;
+
+   /* Check for bad lookup table */
+   nentries = lookup_table->nentries;
+   vector_length = lookup_table->vector_length;
+   if ((nentries < 1) || (vector_length < 1)) {
+      (void) fprintf(stderr, "Bad table size %d x %d\n", 
+                     nentries, vector_length);
+      exit(EXIT_FAILURE);
+   }
+   table = lookup_table->table;
+   stride = vector_length + 1;
+
+   /* Start with no index */
+   lookup_table->nbins = 0;
+   lookup_table->bin_entry = NULL;
+   lookup_table->ndirect = 0;
+   lookup_table->direct_entry = NULL;
+
+   /* Look at the keys - give up if any are not numbers */
+   have_integer = FALSE;
+   key_min = key_max = 0.0;
+   for (ientry=0; ientry < nentries; ientry++) {
+      key = table[ientry*stride];
+      if (key != key) return;
+      if ((key == rint(key)) && (fabs(key) < LONG_MAX / 2)) {
+         if (!have_integer || (key < key_min)) key_min = key;
+         if (!have_integer || (key > key_max)) key_max = key;
+         have_integer = TRUE;
+      }
+   }
+
+   /* Set up the bins */
+   first = table[0];
+   last = table[(nentries-1)*stride];
+   if ((last > first) && ((last - first) <= DBL_MAX)) {
+      nbins = BINS_PER_ENTRY * nentries;
+      lookup_table->bin_origin = first;
+      lookup_table->bin_scale = nbins / (last - first);
+      lookup_table->bin_entry = malloc(sizeof(int) * nbins);
+      for (ibin=0; ibin < nbins; ibin++) {
+         lookup_table->bin_entry[ibin] = 
+            search_table(first + ibin / lookup_table->bin_scale, 
+                         lookup_table);
+      }
+      lookup_table->nbins = nbins;
+   }
+
+   /* Set up the direct index for discrete tables. Only integer keys can
+      ever match a rounded value. */
+   if (discrete_values && have_integer &&
+       ((key_max - key_min) < MAX_DIRECT_ENTRIES)) {
+      lookup_table->direct_min = (long) key_min;
+      lookup_table->ndirect = (long) (key_max - key_min) + 1;
+      lookup_table->direct_entry = 
+         malloc(sizeof(double *) * lookup_table->ndirect);
+      for (idirect=0; idirect < lookup_table->ndirect; idirect++) {
+         key = (double) (lookup_table->direct_min + idirect);
+         ientry = find_table_entry(key, lookup_table);
+         if (table[ientry*stride] == key)
+            lookup_table->direct_entry[idirect] = &table[ientry*stride+1];
+         else
+            lookup_table->direct_entry[idirect] = NULL;
+      }
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : free_lookup_index
+@INPUT      : lookup_table - the lookup table
+@OUTPUT     : lookup_table - the lookup table without its search index
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to free the search index of a lookup table.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void free_lookup_index(Lookup_Table *lookup_table)
+{
+   if (lookup_table->bin_entry != NULL)
+      free(lookup_table->bin_entry);
+   if (lookup_table->direct_entry != NULL)
+      free(lookup_table->direct_entry);
+   lookup_table->nbins = 0;
+   lookup_table->bin_entry = NULL;
+   lookup_table->ndirect = 0;
+   lookup_table->direct_entry = NULL;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : do_lookup
 @INPUT      : caller_data - pointer to structure containing lookup info
@@ -829,7 +968,7 @@ static void get_full_range(int mincid, double range[2])
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : December 8, 1994 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void do_lookup(void *caller_data, long num_voxels,
                       int input_num_buffers, int input_vector_length,
@@ -839,8 +978,11 @@ static void do_lookup(void *caller_data, long num_voxels,
      /* ARGSUSED */
 {
    Lookup_Data *lookup_data;
-   long ivoxel;
+   Lookup_Table *lookup_table;
+   long ivoxel, idirect;
+   int ivalue;
    double lookup_value, scale, offset, denom;
+   double *result, *output;
 
    /* Get pointer to lookup info */
    lookup_data = (Lookup_Data *) caller_data;
@@ -873,6 +1015,29 @@ static void do_lookup(void *caller_data, long num_voxels,
       }
    }
 
+   /* Use the direct index for discrete tables if we can, copying
+      the table rows straight into the output buffer */
+   lookup_table = lookup_data->lookup_table;
+   if (lookup_data->discrete && (lookup_table->ndirect > 0)) {
+      output = output_data[0];
+      for (ivoxel=0; ivoxel < num_voxels; ivoxel++) {
+         lookup_value = rint(input_data[0][ivoxel]);
+         result = lookup_data->null_value;
+         if ((lookup_value >= lookup_table->direct_min) &&
+             (lookup_value < lookup_table->direct_min + 
+                             lookup_table->ndirect)) {
+            idirect = (long) lookup_value - lookup_table->direct_min;
+            if (lookup_table->direct_entry[idirect] != NULL)
+               result = lookup_table->direct_entry[idirect];
+         }
+         for (ivalue=0; ivalue < output_vector_length; ivalue++) {
+            output[ivalue] = ((result != NULL) ? result[ivalue] : 0.0);
+         }
+         output += output_vector_length;
+      }
+      return;
+   }
+
    /* Loop through the voxels */
    for (ivoxel=0; ivoxel < num_voxels; ivoxel++) {
 
@@ -905,59 +1070,31 @@ static void do_lookup(void *caller_data, long num_voxels,
                  discrete valued tables (may be NULL otherwise).
 @OUTPUT     : output_value - vector of output values.
 @RETURNS    : (nothing)
-@DESCRIPTION: Routine to look up a value in the table.
+@DESCRIPTION: Routine to look up a value in the table. The table must have
+              been set up with setup_lookup_index.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : December 8, 1994 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void lookup_in_table(double index, Lookup_Table *lookup_table,
                             int discrete_values, double null_value[],
                             double output_value[])
 {
    int vector_length, nentries;
-   int start, length, mid;
+   int start;
    int offset, offset1, offset2, ivalue;
    double value1, value2, *result, frac, rfrac, denom;
 
-   /* Check for bad lookup table */
    nentries = lookup_table->nentries;
    vector_length = lookup_table->vector_length;
-   if ((nentries < 1) || (vector_length < 1)) {
-      (void) fprintf(stderr, "Bad table size %d x %d\n", 
-                     nentries, vector_length);
-      exit(EXIT_FAILURE);
-   }
 
    /* Round values if needed */
    if (discrete_values) index = rint(index);
 
-   /* Search the table for the value */
-   start = 0;
-   length = nentries;
-   while (length > 1) {
-      mid = start + length / 2;
-      offset = mid*(vector_length+1);
-      if (index < lookup_table->table[offset]) {
-         length = mid - start;
-      }
-      else {
-         length = start + length - mid;
-         start = mid;
-      }
-   }
-
-   /* Add a special check for the end of the table */
-   if (nentries > 1) {
-      offset1 = vector_length+1;
-      offset2 = (nentries-2) * (vector_length+1);
-      if ((start == 0) && (index == lookup_table->table[offset1]))
-         start = 1;
-      else if ((start == nentries-1) && 
-               (index == lookup_table->table[offset2]))
-         start = nentries-2;
-   }
+   /* Find the table entry for the value */
+   start = find_table_entry(index, lookup_table);
 
    /* Save the value */
    offset = start*(vector_length+1);
@@ -997,3 +1134,102 @@ static void lookup_in_table(double index, Lookup_Table *lookup_table,
    }
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : find_table_entry
+@INPUT      : index - value to look up in table
+              lookup_table - the lookup table
+@OUTPUT     : (nothing)
+@RETURNS    : Index of the table entry for the value
+@DESCRIPTION: Routine to find the last table entry whose key is not 
+              greater than the value (or the first entry if there is 
+              none), with special handling of duplicated first or last
+              entries. The bins of the table index give the entry to try;
+              the table is only searched if the value does not lie between
+              that entry (or the next) and the one after.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int find_table_entry(double index, Lookup_Table *lookup_table)
+{
+   int nentries, stride, start, ibin;
+   double *table;
+
+   nentries = lookup_table->nentries;
+   stride = lookup_table->vector_length + 1;
+   table = lookup_table->table;
+
+   /* Try the bins first */
+   start = -1;
+   if (lookup_table->nbins > 0) {
+      if (index < table[0]) {
+         start = 0;
+      }
+      else if (index >= table[(nentries-1)*stride]) {
+         start = nentries-1;
+      }
+      else if (index >= table[0]) {
+         ibin = (int) ((index - lookup_table->bin_origin) * 
+                       lookup_table->bin_scale);
+         if (ibin >= lookup_table->nbins) ibin = lookup_table->nbins - 1;
+         start = lookup_table->bin_entry[ibin];
+         if ((start < nentries-1) && (index >= table[(start+1)*stride]))
+            start++;
+         if ((start >= nentries-1) || (index < table[start*stride]) ||
+             (index >= table[(start+1)*stride]))
+            start = -1;
+      }
+   }
+
+   /* Otherwise search the table for the value */
+   if (start < 0) {
+      start = search_table(index, lookup_table);
+   }
+
+   /* Add a special check for the end of the table */
+   if (nentries > 1) {
+      if ((start == 0) && (index == table[stride]))
+         start = 1;
+      else if ((start == nentries-1) && 
+               (index == table[(nentries-2)*stride]))
+         start = nentries-2;
+   }
+
+   return start;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : search_table
+@INPUT      : index - value to look up in table
+              lookup_table - the lookup table
+@OUTPUT     : (nothing)
+@RETURNS    : Index of the last table entry whose key is not greater than
+              the value (or 0 if there is none)
+@DESCRIPTION: Routine to do a binary search of the table keys.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int search_table(double index, Lookup_Table *lookup_table)
+{
+   int start, length, mid;
+
+   start = 0;
+   length = lookup_table->nentries;
+   while (length > 1) {
+      mid = start + length / 2;
+      if (index < lookup_table->table[mid*(lookup_table->vector_length+1)]) {
+         length = mid - start;
+      }
+      else {
+         length = start + length - mid;
+         start = mid;
+      }
+   }
+
+   return start;
+}
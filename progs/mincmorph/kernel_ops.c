@@ -1,9 +1,15 @@
 /* kernel_ops.c */
 
+#include <config.h>
 #include <float.h>
 #include <limits.h>
+#include <string.h>
 #include "kernel_ops.h"
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 extern int verbose;
 
 /* function prototypes */
@@ -11,14 +17,72 @@ void     split_kernel(Kernel * K, Kernel * k1, Kernel * k2);
 int      compare_ints(const void *a, const void *b);
 int      compare_groups(const void *a, const void *b);
 
+/* flat copy of a 3D volume for the fast kernel code, x varies fastest */
+typedef struct {
+   int      sizes[3];
+   float   *data;
+   } Flat_Volume;
+
+int      flat_kernel_ok(Kernel * K, VIO_Volume vol, int unit_weights);
+void     read_flat_volume(VIO_Volume vol, Flat_Volume * flat);
+void     write_flat_volume(Flat_Volume * flat, VIO_Volume vol);
+void     get_flat_range(Kernel * K, Flat_Volume * flat, int lo[3], int hi[3]);
+long    *get_flat_offsets(Kernel * K, Flat_Volume * flat);
+void     flat_dilation(Kernel * K, VIO_Volume vol, int erode,
+                       VIO_progress_struct * progress);
+void     flat_convolve(Kernel * K, VIO_Volume vol, VIO_progress_struct * progress);
+void     flat_morph_step(Kernel * K, Flat_Volume * flat, int erode, float *window,
+                         int nwindow, float *row);
+int      flat_morph_binary(Kernel * K, Flat_Volume * flat, int erode, int n);
+void     flat_distance(Kernel * K, Kernel * k1, Kernel * k2, VIO_Volume vol,
+                       double bg, VIO_progress_struct * progress);
+int      flat_lcorr(Kernel * K, VIO_Volume vol, VIO_Volume cmp,
+                    VIO_progress_struct * progress);
+
+/* lines of a flat buffer along one axis for the Euclidean distance */
+/* transform, lines [start, end) are done by one thread              */
+typedef struct {
+   double  *data;
+   int      sizes[3];
+   int      axis;
+   double   step;
+   long     start, end;
+   } EDT_Lines;
+
+void     edt_pass(double *data, int sizes[3], int axis, double step, int nthreads);
+void    *edt_lines(void *arg);
+void     edt_line(double *f, double *d, int n, double step, int *v, double *z);
+
 /* structure for group information */
 typedef struct {
    unsigned int orig_label;
    unsigned int count;
+   int      min[3], max[3];            /* bounding box (z, y, x)       */
+   double   sum[3];                    /* for the centroid (z, y, x)   */
    } group_info_struct;
 
 typedef group_info_struct *Group_info;
 
+/* slab of a flat label buffer for the union-find group labelling */
+typedef struct {
+   unsigned int *parent;
+   unsigned char *rank;
+   int      sizes[3];
+   int      lo[3], hi[3];
+   Kernel  *K;
+   long    *offsets;
+   int      z0, z1;
+   int      boundary;
+   } Group_Slab;
+
+int      compare_group_info(const void *a, const void *b);
+unsigned int find_root(unsigned int *parent, unsigned int i);
+void     union_roots(unsigned int *parent, unsigned char *rank,
+                     unsigned int a, unsigned int b);
+void    *group_slab(void *arg);
+int      flat_group(Kernel * k1, VIO_Volume vol, double bg, int nthreads,
+                    char *table_file);
+
 int compare_ints(const void *a, const void *b)
 {
    return (*(const int *)a - *(const int *)b);
@@ -29,6 +93,18 @@ int compare_groups(const void *a, const void *b)
    return (*(const Group_info *) b)->count - (*(const Group_info *) a)->count;
    }
 
+/* sort groups by size, largest first, then by their first voxel */
+int compare_group_info(const void *a, const void *b)
+{
+   const group_info_struct *ga = (const group_info_struct *) a;
+   const group_info_struct *gb = (const group_info_struct *) b;
+
+   if(ga->count != gb->count){
+      return (ga->count < gb->count) ? 1 : -1;
+      }
+   return (ga->orig_label < gb->orig_label) ? -1 : (ga->orig_label > gb->orig_label);
+   }
+
 void split_kernel(Kernel * K, Kernel * k1, Kernel * k2)
 {
    int      c, k1c, k2c;
@@ -52,6 +128,554 @@ void split_kernel(Kernel * K, Kernel * k1, Kernel * k2)
    k2->nelems = k2c;
    }
 
+/* check whether a kernel can be run on a flat copy of a volume: the  */
+/* volume must be 3D float data and the kernel offsets whole voxels   */
+int flat_kernel_ok(Kernel * K, VIO_Volume vol, int unit_weights)
+{
+   int      c, n;
+
+   if(get_volume_n_dimensions(vol) != 3 || get_volume_data_type(vol) != VIO_FLOAT){
+      return FALSE;
+      }
+   for(c = 0; c < K->nelems; c++){
+      for(n = 0; n < 3; n++){
+         if(K->K[c][n] != (int)K->K[c][n]){
+            return FALSE;
+            }
+         }
+      if(unit_weights && K->K[c][KERNEL_DIMS] != 1.0){
+         return FALSE;
+         }
+      }
+   return TRUE;
+   }
+
+/* copy a volume into a flat buffer, a slice at a time */
+void read_flat_volume(VIO_Volume vol, Flat_Volume * flat)
+{
+   int      z;
+   long     i, slice_size;
+   int      sizes[MAX_VAR_DIMS];
+   VIO_Real *slice;
+   float   *ptr;
+
+   get_volume_sizes(vol, sizes);
+   flat->sizes[0] = sizes[0];
+   flat->sizes[1] = sizes[1];
+   flat->sizes[2] = sizes[2];
+
+   slice_size = (long)sizes[1] * sizes[2];
+   ALLOC(flat->data, slice_size * sizes[0] + 1);
+   ALLOC(slice, slice_size + 1);
+
+   ptr = flat->data;
+   for(z = 0; z < sizes[0]; z++){
+      get_volume_value_hyperslab_3d(vol, z, 0, 0, 1, sizes[1], sizes[2], slice);
+      for(i = 0; i < slice_size; i++){
+         *ptr++ = (float)slice[i];
+         }
+      }
+
+   FREE(slice);
+   }
+
+/* copy a flat buffer back into its volume */
+void write_flat_volume(Flat_Volume * flat, VIO_Volume vol)
+{
+   int      z;
+   long     i, slice_size;
+   VIO_Real *slice;
+   float   *ptr;
+
+   slice_size = (long)flat->sizes[1] * flat->sizes[2];
+   ALLOC(slice, slice_size + 1);
+
+   ptr = flat->data;
+   for(z = 0; z < flat->sizes[0]; z++){
+      for(i = 0; i < slice_size; i++){
+         slice[i] = *ptr++;
+         }
+      set_volume_value_hyperslab_3d(vol, z, 0, 0, 1, flat->sizes[1], flat->sizes[2],
+                                    slice);
+      }
+
+   FREE(slice);
+   }
+
+/* get the range of voxels (z, y, x) that the whole kernel fits around */
+void get_flat_range(Kernel * K, Flat_Volume * flat, int lo[3], int hi[3])
+{
+   int      n;
+
+   for(n = 0; n < 3; n++){
+      lo[n] = -K->pre_pad[2 - n];
+      hi[n] = flat->sizes[n] - K->post_pad[2 - n];
+      if(lo[n] > flat->sizes[n]){
+         lo[n] = flat->sizes[n];
+         }
+      if(hi[n] < lo[n]){
+         hi[n] = lo[n];
+         }
+      }
+   }
+
+/* get the kernel elements as offsets into a flat buffer */
+long    *get_flat_offsets(Kernel * K, Flat_Volume * flat)
+{
+   int      c;
+   long    *offsets;
+
+   ALLOC(offsets, K->nelems + 1);
+   for(c = 0; c < K->nelems; c++){
+      offsets[c] = ((long)K->K[c][2] * flat->sizes[1] + (long)K->K[c][1]) * flat->sizes[2]
+         + (long)K->K[c][0];
+      }
+   return offsets;
+   }
+
+/* dilation or erosion of a flat copy with a kernel of unit weights.   */
+/* Each voxel gets the max (or min) of itself and of the voxels whose  */
+/* kernel reaches it. The general code scatters from every voxel that  */
+/* the whole kernel fits around, so only those voxels are gathered     */
+/* from; the x limits of each row are worked out once per element so   */
+/* the inner loops run over plain rows.                                */
+void flat_dilation(Kernel * K, VIO_Volume vol, int erode, VIO_progress_struct * progress)
+{
+   int      x, y, z, c;
+   int      dx, dy, dz, sy, sz, x0, x1;
+   int      lo[3], hi[3];
+   Flat_Volume flat;
+   VIO_Real *row;
+   float   *in_row, *src_row;
+
+   read_flat_volume(vol, &flat);
+   get_flat_range(K, &flat, lo, hi);
+   ALLOC(row, flat.sizes[2] + 1);
+
+   for(z = 0; z < flat.sizes[0]; z++){
+      for(y = 0; y < flat.sizes[1]; y++){
+         in_row = flat.data + ((long)z * flat.sizes[1] + y) * flat.sizes[2];
+         for(x = 0; x < flat.sizes[2]; x++){
+            row[x] = in_row[x];
+            }
+
+         for(c = 0; c < K->nelems; c++){
+            dx = (int)K->K[c][0];
+            dy = (int)K->K[c][1];
+            dz = (int)K->K[c][2];
+            sz = z - dz;
+            sy = y - dy;
+            if(sz < lo[0] || sz >= hi[0] || sy < lo[1] || sy >= hi[1]){
+               continue;
+               }
+
+            x0 = (lo[2] + dx > 0) ? lo[2] + dx : 0;
+            x1 = (hi[2] + dx < flat.sizes[2]) ? hi[2] + dx : flat.sizes[2];
+            src_row = flat.data + ((long)sz * flat.sizes[1] + sy) * flat.sizes[2] - dx;
+            if(erode){
+               for(x = x0; x < x1; x++){
+                  if(src_row[x] < row[x]){
+                     row[x] = src_row[x];
+                     }
+                  }
+               }
+            else {
+               for(x = x0; x < x1; x++){
+                  if(src_row[x] > row[x]){
+                     row[x] = src_row[x];
+                     }
+                  }
+               }
+            }
+
+         set_volume_value_hyperslab_3d(vol, z, y, 0, 1, 1, flat.sizes[2], row);
+         }
+      update_progress_report(progress, z + 1);
+      }
+
+   FREE(row);
+   FREE(flat.data);
+   }
+
+/* erosion or dilation of a flat buffer in place, as flat_dilation(). */
+/* The original values of the current slice and of the slices before */
+/* it that the kernel reaches back to are kept in a ring of nwindow   */
+/* slices, so no second copy of the volume is needed.                 */
+void flat_morph_step(Kernel * K, Flat_Volume * flat, int erode, float *window,
+                     int nwindow, float *row)
+{
+   int      x, y, z, c;
+   int      dx, dy, dz, sy, sz, x0, x1;
+   int      lo[3], hi[3];
+   long     slice_size;
+   float   *in_row, *src_row;
+
+   get_flat_range(K, flat, lo, hi);
+   slice_size = (long)flat->sizes[1] * flat->sizes[2];
+
+   for(z = 0; z < flat->sizes[0]; z++){
+      memcpy(window + (z % nwindow) * slice_size, flat->data + z * slice_size,
+             slice_size * sizeof(float));
+
+      for(y = 0; y < flat->sizes[1]; y++){
+         in_row = window + (z % nwindow) * slice_size + (long)y * flat->sizes[2];
+         for(x = 0; x < flat->sizes[2]; x++){
+            row[x] = in_row[x];
+            }
+
+         for(c = 0; c < K->nelems; c++){
+            dx = (int)K->K[c][0];
+            dy = (int)K->K[c][1];
+            dz = (int)K->K[c][2];
+            sz = z - dz;
+            sy = y - dy;
+            if(sz < lo[0] || sz >= hi[0] || sy < lo[1] || sy >= hi[1]){
+               continue;
+               }
+
+            /* slices up to this one have been overwritten already */
+            x0 = (lo[2] + dx > 0) ? lo[2] + dx : 0;
+            x1 = (hi[2] + dx < flat->sizes[2]) ? hi[2] + dx : flat->sizes[2];
+            src_row = ((dz >= 0) ? window + (sz % nwindow) * slice_size :
+                       flat->data + sz * slice_size) + (long)sy * flat->sizes[2] - dx;
+            if(erode){
+               for(x = x0; x < x1; x++){
+                  if(src_row[x] < row[x]){
+                     row[x] = src_row[x];
+                     }
+                  }
+               }
+            else {
+               for(x = x0; x < x1; x++){
+                  if(src_row[x] > row[x]){
+                     row[x] = src_row[x];
+                     }
+                  }
+               }
+            }
+
+         memcpy(flat->data + z * slice_size + (long)y * flat->sizes[2], row,
+                flat->sizes[2] * sizeof(float));
+         }
+      }
+   }
+
+/* n erosions or dilations of a binary flat buffer in one pass. Only  */
+/* voxels that changed in one step can change others in the next, so  */
+/* the changes are propagated out from a list of those voxels. The     */
+/* lists only grow as large as the number of voxels changed in a step. */
+/* Returns FALSE without doing anything if the buffer is not binary.   */
+int flat_morph_binary(Kernel * K, Flat_Volume * flat, int erode, int n)
+{
+   int      c, step, nvalues;
+   int      x, y, z;
+   int      lo[3], hi[3];
+   long     idx, t, i, nvoxels, slice_size;
+   long     ncurr, nnext, ncurr_alloc, nnext_alloc, ntmp;
+   float    values[2], value, other, mark;
+   unsigned int *curr, *next, *tmp;
+   long    *offsets;
+
+   nvoxels = (long)flat->sizes[0] * flat->sizes[1] * flat->sizes[2];
+   if(nvoxels >= UINT_MAX){
+      return FALSE;
+      }
+
+   /* check for two values at most (NaN is not binary) */
+   nvalues = 0;
+   for(idx = 0; idx < nvoxels; idx++){
+      value = flat->data[idx];
+      if(value != value){
+         return FALSE;
+         }
+      if(nvalues == 0 || (value != values[0] && (nvalues == 1 || value != values[1]))){
+         if(nvalues == 2){
+            return FALSE;
+            }
+         values[nvalues++] = value;
+         }
+      }
+   if(nvalues < 2){
+      return TRUE;
+      }
+
+   /* the value that spreads, the one it replaces and a marker for */
+   /* voxels that change in the current step                       */
+   if((values[0] < values[1]) == (erode != 0)){
+      value = values[0];
+      other = values[1];
+      }
+   else {
+      value = values[1];
+      other = values[0];
+      }
+   mark = 0.0;
+   while(mark == value || mark == other){
+      mark += 1.0;
+      }
+
+   get_flat_range(K, flat, lo, hi);
+   offsets = get_flat_offsets(K, flat);
+   slice_size = (long)flat->sizes[1] * flat->sizes[2];
+   ncurr_alloc = nnext_alloc = 1024;
+   ALLOC(curr, ncurr_alloc);
+   ALLOC(next, nnext_alloc);
+
+   /* the first step spreads from every voxel the kernel fits around */
+   nnext = 0;
+   for(z = lo[0]; z < hi[0]; z++){
+      for(y = lo[1]; y < hi[1]; y++){
+         idx = z * slice_size + (long)y * flat->sizes[2] + lo[2];
+         for(x = lo[2]; x < hi[2]; x++, idx++){
+            if(flat->data[idx] != value){
+               continue;
+               }
+            for(c = 0; c < K->nelems; c++){
+               t = idx + offsets[c];
+               if(flat->data[t] == other){
+                  flat->data[t] = mark;
+                  if(nnext == nnext_alloc){
+                     SET_ARRAY_SIZE(next, nnext_alloc, 2 * nnext_alloc, 1);
+                     nnext_alloc *= 2;
+                     }
+                  next[nnext++] = (unsigned int)t;
+                  }
+               }
+            }
+         }
+      }
+
+   for(step = 0; step < n && nnext > 0; step++){
+      for(i = 0; i < nnext; i++){
+         flat->data[next[i]] = value;
+         }
+      if(step == n - 1){
+         break;
+         }
+
+      tmp = curr;
+      curr = next;
+      next = tmp;
+      ncurr = nnext;
+      ntmp = ncurr_alloc;
+      ncurr_alloc = nnext_alloc;
+      nnext_alloc = ntmp;
+
+      nnext = 0;
+      for(i = 0; i < ncurr; i++){
+         idx = curr[i];
+         z = (int)(idx / slice_size);
+         y = (int)((idx / flat->sizes[2]) % flat->sizes[1]);
+         x = (int)(idx % flat->sizes[2]);
+         if(z < lo[0] || z >= hi[0] || y < lo[1] || y >= hi[1] ||
+            x < lo[2] || x >= hi[2]){
+            continue;
+            }
+
+         for(c = 0; c < K->nelems; c++){
+            t = idx + offsets[c];
+            if(flat->data[t] == other){
+               flat->data[t] = mark;
+               if(nnext == nnext_alloc){
+                  SET_ARRAY_SIZE(next, nnext_alloc, 2 * nnext_alloc, 1);
+                  nnext_alloc *= 2;
+                  }
+               next[nnext++] = (unsigned int)t;
+               }
+            }
+         }
+      }
+
+   FREE(curr);
+   FREE(next);
+   FREE(offsets);
+   return TRUE;
+   }
+
+/* convolution of a flat copy, a row at a time */
+void flat_convolve(Kernel * K, VIO_Volume vol, VIO_progress_struct * progress)
+{
+   int      x, y, z, c;
+   int      lo[3], hi[3];
+   Flat_Volume flat;
+   VIO_Real *row;
+   VIO_Real weight;
+   float   *src_row;
+   long    *offsets;
+
+   read_flat_volume(vol, &flat);
+   get_flat_range(K, &flat, lo, hi);
+   offsets = get_flat_offsets(K, &flat);
+   ALLOC(row, flat.sizes[2] + 1);
+
+   for(z = lo[0]; z < hi[0]; z++){
+      for(y = lo[1]; y < hi[1]; y++){
+         src_row = flat.data + ((long)z * flat.sizes[1] + y) * flat.sizes[2];
+         for(x = 0; x < flat.sizes[2]; x++){
+            row[x] = (x >= lo[2] && x < hi[2]) ? 0.0 : src_row[x];
+            }
+
+         for(c = 0; c < K->nelems; c++){
+            weight = K->K[c][KERNEL_DIMS];
+            for(x = lo[2]; x < hi[2]; x++){
+               row[x] += src_row[x + offsets[c]] * weight;
+               }
+            }
+
+         set_volume_value_hyperslab_3d(vol, z, y, 0, 1, 1, flat.sizes[2], row);
+         }
+      update_progress_report(progress, z + 1);
+      }
+
+   FREE(row);
+   FREE(offsets);
+   FREE(flat.data);
+   }
+
+/* the two chamfer passes of distance_kernel() on a flat copy */
+void flat_distance(Kernel * K, Kernel * k1, Kernel * k2, VIO_Volume vol,
+                   double bg, VIO_progress_struct * progress)
+{
+   int      x, y, z, c;
+   int      lo[3], hi[3];
+   long     idx;
+   double   value, min;
+   Flat_Volume flat;
+   float   *data;
+   long    *off1, *off2;
+
+   read_flat_volume(vol, &flat);
+   off1 = get_flat_offsets(k1, &flat);
+   off2 = get_flat_offsets(k2, &flat);
+   data = flat.data;
+
+   /* forward raster direction */
+   get_flat_range(K, &flat, lo, hi);
+   for(z = lo[0]; z < hi[0]; z++){
+      for(y = lo[1]; y < hi[1]; y++){
+         idx = ((long)z * flat.sizes[1] + y) * flat.sizes[2] + lo[2];
+         for(x = lo[2]; x < hi[2]; x++, idx++){
+            if(data[idx] != bg){
+               min = DBL_MAX;
+               for(c = 0; c < k1->nelems; c++){
+                  value = data[idx + off1[c]] + 1;
+                  if(value < min){
+                     min = value;
+                     }
+                  }
+               data[idx] = (float)min;
+               }
+            }
+         }
+      update_progress_report(progress, z + 1);
+      }
+
+   /* reverse raster direction */
+   get_flat_range(k2, &flat, lo, hi);
+   for(z = hi[0] - 1; z >= lo[0]; z--){
+      for(y = hi[1] - 1; y >= lo[1]; y--){
+         idx = ((long)z * flat.sizes[1] + y) * flat.sizes[2] + hi[2] - 1;
+         for(x = hi[2] - 1; x >= lo[2]; x--, idx--){
+            min = data[idx];
+            if(min != bg){
+               for(c = 0; c < k2->nelems; c++){
+                  value = data[idx + off2[c]] + 1;
+                  if(value < min){
+                     min = value;
+                     }
+                  }
+               data[idx] = (float)min;
+               }
+            }
+         }
+      update_progress_report(progress, flat.sizes[2] + z + 1);
+      }
+
+   write_flat_volume(&flat, vol);
+
+   FREE(off1);
+   FREE(off2);
+   FREE(flat.data);
+   }
+
+/* local correlation on flat copies, a row at a time; returns FALSE    */
+/* without doing anything if the volumes differ in size                */
+int flat_lcorr(Kernel * K, VIO_Volume vol, VIO_Volume cmp, VIO_progress_struct * progress)
+{
+   int      x, y, z, c;
+   int      lo[3], hi[3];
+   int      sizes[MAX_VAR_DIMS], cmp_sizes[MAX_VAR_DIMS];
+   double   v1, v2, denom;
+   Flat_Volume flat, flat_cmp;
+   VIO_Real *row, *ssum_v1, *ssum_v2, *sum_prd;
+   VIO_Real weight;
+   float   *row1, *row2;
+   long    *offsets;
+
+   get_volume_sizes(vol, sizes);
+   get_volume_sizes(cmp, cmp_sizes);
+   if(get_volume_n_dimensions(cmp) != 3 || get_volume_data_type(cmp) != VIO_FLOAT ||
+      cmp_sizes[0] != sizes[0] || cmp_sizes[1] != sizes[1] || cmp_sizes[2] != sizes[2]){
+      return FALSE;
+      }
+   read_flat_volume(vol, &flat);
+   read_flat_volume(cmp, &flat_cmp);
+
+   get_flat_range(K, &flat, lo, hi);
+   offsets = get_flat_offsets(K, &flat);
+   ALLOC(row, flat.sizes[2] + 1);
+   ALLOC(ssum_v1, flat.sizes[2] + 1);
+   ALLOC(ssum_v2, flat.sizes[2] + 1);
+   ALLOC(sum_prd, flat.sizes[2] + 1);
+
+   /* set output range */
+   set_volume_real_range(vol, 0.0, 1.0);
+
+   for(z = 0; z < flat.sizes[0]; z++){
+      for(y = 0; y < flat.sizes[1]; y++){
+         for(x = 0; x < flat.sizes[2]; x++){
+            row[x] = 0.0;
+            }
+
+         if(z >= lo[0] && z < hi[0] && y >= lo[1] && y < hi[1]){
+            row1 = flat.data + ((long)z * flat.sizes[1] + y) * flat.sizes[2];
+            row2 = flat_cmp.data + ((long)z * flat.sizes[1] + y) * flat.sizes[2];
+            for(x = lo[2]; x < hi[2]; x++){
+               ssum_v1[x] = ssum_v2[x] = sum_prd[x] = 0.0;
+               }
+
+            for(c = 0; c < K->nelems; c++){
+               weight = K->K[c][KERNEL_DIMS];
+               for(x = lo[2]; x < hi[2]; x++){
+                  v1 = row1[x + offsets[c]] * weight;
+                  v2 = row2[x + offsets[c]] * weight;
+                  ssum_v1[x] += v1 * v1;
+                  ssum_v2[x] += v2 * v2;
+                  sum_prd[x] += v1 * v2;
+                  }
+               }
+
+            for(x = lo[2]; x < hi[2]; x++){
+               denom = sqrt(ssum_v1[x] * ssum_v2[x]);
+               row[x] = (denom == 0.0) ? 0.0 : sum_prd[x] / denom;
+               }
+            }
+
+         set_volume_value_hyperslab_3d(vol, z, y, 0, 1, 1, flat.sizes[2], row);
+         }
+      update_progress_report(progress, z + 1);
+      }
+
+   FREE(row);
+   FREE(ssum_v1);
+   FREE(ssum_v2);
+   FREE(sum_prd);
+   FREE(offsets);
+   FREE(flat.data);
+   FREE(flat_cmp.data);
+   return TRUE;
+   }
+
 /* binarise a volume between a range */
 VIO_Volume  binarise(VIO_Volume vol, double floor, double ceil, double fg, double bg)
 {
@@ -180,6 +804,13 @@ VIO_Volume  dilation_kernel(Kernel * K, VIO_Volume vol)
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2], "Dilation");
 
+   /* use the flat copy if we can */
+   if(flat_kernel_ok(K, vol, TRUE)){
+      flat_dilation(K, vol, FALSE, &progress);
+      terminate_progress_report(&progress);
+      return (vol);
+      }
+
    /* copy the volume */
    tmp_vol = copy_volume(vol);
 
@@ -213,6 +844,63 @@ VIO_Volume  dilation_kernel(Kernel * K, VIO_Volume vol)
    return (vol);
    }
 
+/* run a chain of erosions (E) and dilations (D) with the same kernel.  */
+/* The volume is read into a flat buffer once and each step is done in  */
+/* place; runs of the same step on binary data are done in one pass.   */
+/* The flat buffer is a full float copy, the same size as the copy     */
+/* each single step makes, plus a ring of slices for the window.       */
+VIO_Volume  morph_chain(Kernel * K, VIO_Volume vol, char *steps)
+{
+   int      i, n, nwindow;
+   Flat_Volume flat;
+   float   *window, *row;
+   VIO_progress_struct progress;
+
+   if(verbose){
+      fprintf(stdout, "Erosion/Dilation chain: %s\n", steps);
+      }
+
+   /* otherwise run the steps one at a time */
+   if(!flat_kernel_ok(K, vol, TRUE)){
+      for(i = 0; steps[i] != '\0'; i++){
+         vol = (steps[i] == 'E') ? erosion_kernel(K, vol) : dilation_kernel(K, vol);
+         }
+      return (vol);
+      }
+
+   read_flat_volume(vol, &flat);
+   nwindow = K->post_pad[2] + 1;
+   ALLOC(window, (long)nwindow * flat.sizes[1] * flat.sizes[2] + 1);
+   ALLOC(row, flat.sizes[2] + 1);
+
+   initialize_progress_report(&progress, FALSE, (int)strlen(steps), "Erosion/Dilation");
+   for(i = 0; steps[i] != '\0'; i += n){
+      for(n = 1; steps[i + n] == steps[i]; n++){
+         }
+
+      if(n > 1 && flat_morph_binary(K, &flat, steps[i] == 'E', n)){
+         if(verbose){
+            fprintf(stdout, "%d %s of binary data in one pass\n", n,
+                    (steps[i] == 'E') ? "erosions" : "dilations");
+            }
+         }
+      else {
+         for(n = 0; steps[i + n] == steps[i]; n++){
+            flat_morph_step(K, &flat, steps[i] == 'E', window, nwindow, row);
+            }
+         }
+      update_progress_report(&progress, i + n);
+      }
+   terminate_progress_report(&progress);
+
+   write_flat_volume(&flat, vol);
+
+   FREE(row);
+   FREE(window);
+   FREE(flat.data);
+   return (vol);
+   }
+
 /* perform a median kernel operation on a volume */
 VIO_Volume  median_dilation_kernel(Kernel * K, VIO_Volume vol)
 {
@@ -299,6 +987,13 @@ VIO_Volume  erosion_kernel(Kernel * K, VIO_Volume vol)
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2], "Erosion");
 
+   /* use the flat copy if we can */
+   if(flat_kernel_ok(K, vol, TRUE)){
+      flat_dilation(K, vol, TRUE, &progress);
+      terminate_progress_report(&progress);
+      return (vol);
+      }
+
    /* copy the volume */
    tmp_vol = copy_volume(vol);
 
@@ -348,6 +1043,13 @@ VIO_Volume  convolve_kernel(Kernel * K, VIO_Volume vol)
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2], "Convolve");
 
+   /* use the flat copy if we can */
+   if(flat_kernel_ok(K, vol, FALSE)){
+      flat_convolve(K, vol, &progress);
+      terminate_progress_report(&progress);
+      return (vol);
+      }
+
    /* copy the volume */
    tmp_vol = copy_volume(vol);
 
@@ -404,6 +1106,15 @@ VIO_Volume  distance_kernel(Kernel * K, VIO_Volume vol, double bg)
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2] * 2, "Distance");
 
+   /* use the flat copy if we can */
+   if(flat_kernel_ok(K, vol, FALSE)){
+      flat_distance(K, k1, k2, vol, bg, &progress);
+      free(k1);
+      free(k2);
+      terminate_progress_report(&progress);
+      return (vol);
+      }
+
    /* forward raster direction */
    for(z = -K->pre_pad[2]; z < sizes[0] - K->post_pad[2]; z++){
       for(y = -K->pre_pad[1]; y < sizes[1] - K->post_pad[1]; y++){
@@ -464,9 +1175,543 @@ VIO_Volume  distance_kernel(Kernel * K, VIO_Volume vol, double bg)
    return (vol);
    }
 
+/* exact Euclidean distance transform after Felzenszwalb and          */
+/* Huttenlocher: squared distances are found with a 1D lower envelope  */
+/* pass along each axis in turn, using the voxel separations           */
+VIO_Volume  euclidean_distance(VIO_Volume vol, double bg, int signed_dist, int nthreads)
+{
+   int      n, pass;
+   long     i, nvoxels, nfeature;
+   VIO_Real separations[MAX_VAR_DIMS];
+   Flat_Volume flat;
+   double  *dist;
+   unsigned char *fg;
+
+   if(verbose){
+      fprintf(stdout, "Euclidean distance transform - background %g%s\n", bg,
+              signed_dist ? " (signed)" : "");
+      }
+
+   if(get_volume_n_dimensions(vol) != 3){
+      fprintf(stderr, "Euclidean distance transform needs a 3D volume\n\n");
+      exit(EXIT_FAILURE);
+      }
+   get_volume_separations(vol, separations);
+
+   read_flat_volume(vol, &flat);
+   nvoxels = (long)flat.sizes[0] * flat.sizes[1] * flat.sizes[2];
+   ALLOC(dist, nvoxels + 1);
+   ALLOC(fg, nvoxels + 1);
+
+   /* background voxels are at no distance from the background */
+   for(i = 0; i < nvoxels; i++){
+      fg[i] = (flat.data[i] != bg);
+      if(!fg[i]){
+         flat.data[i] = 0.0;
+         }
+      }
+
+   /* the first pass measures foreground voxels from the background, */
+   /* the second (signed only) background voxels from the foreground */
+   for(pass = 0; pass < (signed_dist ? 2 : 1); pass++){
+
+      nfeature = 0;
+      for(i = 0; i < nvoxels; i++){
+         if(fg[i] == pass){
+            dist[i] = 0.0;
+            nfeature++;
+            }
+         else {
+            dist[i] = DBL_MAX;
+            }
+         }
+
+      /* nothing to measure to, leave these voxels alone */
+      if(nfeature == 0){
+         fprintf(stderr, "Warning: no %s voxels to measure distances to\n",
+                 (pass == 0) ? "background" : "foreground");
+         continue;
+         }
+
+      for(n = 3; n--;){
+         edt_pass(dist, flat.sizes, n, fabs(separations[n]), nthreads);
+         }
+
+      for(i = 0; i < nvoxels; i++){
+         if(fg[i] != pass){
+            flat.data[i] = (float)((pass == 0) ? sqrt(dist[i]) : -sqrt(dist[i]));
+            }
+         }
+      }
+
+   write_flat_volume(&flat, vol);
+
+   FREE(fg);
+   FREE(dist);
+   FREE(flat.data);
+   return (vol);
+   }
+
+/* run the 1D transform along every line of an axis */
+void edt_pass(double *data, int sizes[3], int axis, double step, int nthreads)
+{
+   int      t, n;
+   long     nlines;
+   EDT_Lines *lines;
+
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+#else
+   nthreads = 1;
+#endif
+
+   nlines = 1;
+   for(n = 0; n < 3; n++){
+      if(n != axis){
+         nlines *= sizes[n];
+         }
+      }
+   if(nthreads > nlines){
+      nthreads = (nlines > 0) ? (int)nlines : 1;
+      }
+
+   ALLOC(lines, nthreads);
+   for(t = 0; t < nthreads; t++){
+      lines[t].data = data;
+      lines[t].sizes[0] = sizes[0];
+      lines[t].sizes[1] = sizes[1];
+      lines[t].sizes[2] = sizes[2];
+      lines[t].axis = axis;
+      lines[t].step = step;
+      lines[t].start = nlines * t / nthreads;
+      lines[t].end = nlines * (t + 1) / nthreads;
+      }
+
+#ifdef HAVE_PTHREAD
+   if(nthreads > 1){
+      ALLOC(threads, nthreads);
+      for(t = 0; t < nthreads; t++){
+         if(pthread_create(&threads[t], NULL, edt_lines, &lines[t]) != 0){
+            fprintf(stderr, "Unable to create worker thread.\n");
+            exit(EXIT_FAILURE);
+            }
+         }
+      for(t = 0; t < nthreads; t++){
+         pthread_join(threads[t], NULL);
+         }
+      FREE(threads);
+      }
+   else {
+      edt_lines(&lines[0]);
+      }
+#else
+   edt_lines(&lines[0]);
+#endif
+
+   FREE(lines);
+   }
+
+/* thread body: transform a range of lines along one axis */
+void    *edt_lines(void *arg)
+{
+   EDT_Lines *lines = (EDT_Lines *) arg;
+   int      n, i;
+   long     l, base, stride;
+   double  *f, *d, *z;
+   int     *v;
+
+   n = lines->sizes[lines->axis];
+   ALLOC(f, n + 1);
+   ALLOC(d, n + 1);
+   ALLOC(v, n + 1);
+   ALLOC(z, n + 2);
+
+   for(l = lines->start; l < lines->end; l++){
+      switch (lines->axis){
+      case 0:
+         base = l;
+         stride = (long)lines->sizes[1] * lines->sizes[2];
+         break;
+      case 1:
+         base = (l / lines->sizes[2]) * lines->sizes[1] * lines->sizes[2] +
+            l % lines->sizes[2];
+         stride = lines->sizes[2];
+         break;
+      default:
+         base = l * lines->sizes[2];
+         stride = 1;
+         break;
+         }
+
+      for(i = 0; i < n; i++){
+         f[i] = lines->data[base + i * stride];
+         }
+      edt_line(f, d, n, lines->step, v, z);
+      for(i = 0; i < n; i++){
+         lines->data[base + i * stride] = d[i];
+         }
+      }
+
+   FREE(f);
+   FREE(d);
+   FREE(v);
+   FREE(z);
+   return NULL;
+   }
+
+/* squared distance transform of one line, d[p] = min ((p-q)*step)^2 + f[q] */
+/* over q, found from the lower envelope of the parabolas rooted at the     */
+/* samples that can be reached. v holds the parabolas in the envelope and   */
+/* z the boundaries between them.                                           */
+void edt_line(double *f, double *d, int n, double step, int *v, double *z)
+{
+   int      p, q, k;
+   double   s, dp;
+
+   s = 0.0;
+   k = -1;
+   for(q = 0; q < n; q++){
+      if(f[q] == DBL_MAX){
+         continue;
+         }
+
+      /* drop the parabolas that the new one hides */
+      while(k >= 0){
+         s = ((f[q] + (q * step) * (q * step)) -
+              (f[v[k]] + (v[k] * step) * (v[k] * step))) / (2.0 * step * (q - v[k]));
+         if(s > z[k]){
+            break;
+            }
+         k--;
+         }
+
+      k++;
+      v[k] = q;
+      z[k] = (k == 0) ? -DBL_MAX : s;
+      }
+
+   /* nothing can be reached along this line */
+   if(k < 0){
+      for(p = 0; p < n; p++){
+         d[p] = DBL_MAX;
+         }
+      return;
+      }
+
+   z[k + 1] = DBL_MAX;
+   k = 0;
+   for(p = 0; p < n; p++){
+      while(z[k + 1] < p * step){
+         k++;
+         }
+      dp = (p - v[k]) * step;
+      d[p] = dp * dp + f[v[k]];
+      }
+   }
+
+/* find the root of a label, halving the path on the way */
+unsigned int find_root(unsigned int *parent, unsigned int i)
+{
+   while(parent[i] != i){
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+      }
+   return i;
+   }
+
+/* join the sets of two labels, by rank */
+void union_roots(unsigned int *parent, unsigned char *rank, unsigned int a, unsigned int b)
+{
+   a = find_root(parent, a);
+   b = find_root(parent, b);
+   if(a == b){
+      return;
+      }
+
+   if(rank[a] < rank[b]){
+      parent[a] = b;
+      }
+   else if(rank[a] > rank[b]){
+      parent[b] = a;
+      }
+   else {
+      parent[b] = a;
+      rank[a]++;
+      }
+   }
+
+/* join the labelled voxels of a slab with their labelled neighbours */
+/* in the same slab, or (boundary) with those in the slabs before it */
+void    *group_slab(void *arg)
+{
+   Group_Slab *slab = (Group_Slab *) arg;
+   int      x, y, z, c, nz, ny, nx;
+   long     idx, nidx;
+
+   for(z = slab->z0; z < slab->z1; z++){
+      for(y = slab->lo[1]; y < slab->hi[1]; y++){
+         idx = ((long)z * slab->sizes[1] + y) * slab->sizes[2] + slab->lo[2];
+         for(x = slab->lo[2]; x < slab->hi[2]; x++, idx++){
+            if(slab->parent[idx] == UINT_MAX){
+               continue;
+               }
+
+            for(c = 0; c < slab->K->nelems; c++){
+               nz = z + (int)slab->K->K[c][2];
+               if((nz < slab->z0) != slab->boundary){
+                  continue;
+                  }
+               ny = y + (int)slab->K->K[c][1];
+               nx = x + (int)slab->K->K[c][0];
+               if(nz < slab->lo[0] || ny < slab->lo[1] || ny >= slab->hi[1] ||
+                  nx < slab->lo[2] || nx >= slab->hi[2]){
+                  continue;
+                  }
+
+               nidx = idx + slab->offsets[c];
+               if(slab->parent[nidx] != UINT_MAX){
+                  union_roots(slab->parent, slab->rank, (unsigned int)idx,
+                              (unsigned int)nidx);
+                  }
+               }
+            }
+         }
+      }
+
+   return NULL;
+   }
+
+/* connected components labelling with union-find on a flat label    */
+/* buffer. Slabs of slices are labelled in parallel and then joined  */
+/* across the slab boundaries. Only voxels that the whole forward    */
+/* kernel fits around are labelled, as in group_kernel(). Returns     */
+/* FALSE without doing anything if the volume has too many voxels to  */
+/* label with unsigned int indices.                                   */
+int flat_group(Kernel * k1, VIO_Volume vol, double bg, int nthreads,
+               char *table_file)
+{
+   int      x, y, z, t, n;
+   int      sizes[MAX_VAR_DIMS];
+   int      lo[3], hi[3];
+   long     idx, nvoxels, slice_size;
+   unsigned int root, num_groups, g;
+   unsigned int *parent, *trans;
+   unsigned char *rank;
+   VIO_Real *slice;
+   VIO_Real voxel[MAX_VAR_DIMS], world[3];
+   Flat_Volume flat;
+   Group_Slab *slabs;
+   group_info_struct *groups;
+   long    *offsets;
+   FILE    *fp;
+
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+#else
+   nthreads = 1;
+#endif
+
+   get_volume_sizes(vol, sizes);
+   nvoxels = (long)sizes[0] * sizes[1] * sizes[2];
+   if(nvoxels >= UINT_MAX / 2){
+      return FALSE;
+      }
+
+   /* only the sizes are used from the flat volume */
+   flat.sizes[0] = sizes[0];
+   flat.sizes[1] = sizes[1];
+   flat.sizes[2] = sizes[2];
+   flat.data = NULL;
+   get_flat_range(k1, &flat, lo, hi);
+   offsets = get_flat_offsets(k1, &flat);
+
+   /* every labelled voxel starts out as a group of its own */
+   slice_size = (long)sizes[1] * sizes[2];
+   ALLOC(parent, nvoxels + 1);
+   ALLOC(rank, nvoxels + 1);
+   ALLOC(slice, slice_size + 1);
+   idx = 0;
+   for(z = 0; z < sizes[0]; z++){
+      get_volume_value_hyperslab_3d(vol, z, 0, 0, 1, sizes[1], sizes[2], slice);
+      for(y = 0; y < sizes[1]; y++){
+         for(x = 0; x < sizes[2]; x++, idx++){
+            rank[idx] = 0;
+            if(slice[(long)y * sizes[2] + x] != bg &&
+               z >= lo[0] && z < hi[0] && y >= lo[1] && y < hi[1] &&
+               x >= lo[2] && x < hi[2]){
+               parent[idx] = (unsigned int)idx;
+               }
+            else {
+               parent[idx] = UINT_MAX;
+               }
+            }
+         }
+      }
+
+   /* join within slabs, then across their boundaries */
+   if(nthreads > hi[0] - lo[0]){
+      nthreads = (hi[0] > lo[0]) ? hi[0] - lo[0] : 1;
+      }
+   ALLOC(slabs, nthreads);
+   for(t = 0; t < nthreads; t++){
+      slabs[t].parent = parent;
+      slabs[t].rank = rank;
+      for(n = 0; n < 3; n++){
+         slabs[t].sizes[n] = sizes[n];
+         slabs[t].lo[n] = lo[n];
+         slabs[t].hi[n] = hi[n];
+         }
+      slabs[t].K = k1;
+      slabs[t].offsets = offsets;
+      slabs[t].z0 = lo[0] + (int)((long)(hi[0] - lo[0]) * t / nthreads);
+      slabs[t].z1 = lo[0] + (int)((long)(hi[0] - lo[0]) * (t + 1) / nthreads);
+      slabs[t].boundary = FALSE;
+      }
+
+#ifdef HAVE_PTHREAD
+   if(nthreads > 1){
+      ALLOC(threads, nthreads);
+      for(t = 0; t < nthreads; t++){
+         if(pthread_create(&threads[t], NULL, group_slab, &slabs[t]) != 0){
+            fprintf(stderr, "Unable to create worker thread.\n");
+            exit(EXIT_FAILURE);
+            }
+         }
+      for(t = 0; t < nthreads; t++){
+         pthread_join(threads[t], NULL);
+         }
+      FREE(threads);
+      }
+   else {
+      group_slab(&slabs[0]);
+      }
+#else
+   group_slab(&slabs[0]);
+#endif
+
+   for(t = 1; t < nthreads; t++){
+      slabs[t].boundary = TRUE;
+      group_slab(&slabs[t]);
+      }
+
+   /* point every voxel straight at its root and count the groups */
+   num_groups = 0;
+   for(idx = 0; idx < nvoxels; idx++){
+      if(parent[idx] != UINT_MAX){
+         parent[idx] = find_root(parent, (unsigned int)idx);
+         if(parent[idx] == idx){
+            num_groups++;
+            }
+         }
+      }
+   FREE(rank);
+
+   /* number the groups in raster order of their first voxel and get  */
+   /* their statistics; group g is stored as nvoxels + g in the buffer */
+   ALLOC(groups, num_groups + 1);
+   num_groups = 0;
+   idx = 0;
+   for(z = 0; z < sizes[0]; z++){
+      for(y = 0; y < sizes[1]; y++){
+         for(x = 0; x < sizes[2]; x++, idx++){
+            if(parent[idx] == UINT_MAX){
+               continue;
+               }
+
+            root = parent[idx];
+            if(root < nvoxels && parent[root] < nvoxels){
+               g = num_groups++;
+               groups[g].orig_label = g;
+               groups[g].count = 0;
+               groups[g].min[0] = groups[g].max[0] = z;
+               groups[g].min[1] = groups[g].max[1] = y;
+               groups[g].min[2] = groups[g].max[2] = x;
+               groups[g].sum[0] = groups[g].sum[1] = groups[g].sum[2] = 0.0;
+               parent[root] = (unsigned int)(nvoxels + g);
+               }
+            else {
+               g = ((root < nvoxels) ? parent[root] : root) - (unsigned int)nvoxels;
+               }
+            parent[idx] = (unsigned int)(nvoxels + g);
+
+            groups[g].count++;
+            if(y < groups[g].min[1]){
+               groups[g].min[1] = y;
+               }
+            if(y > groups[g].max[1]){
+               groups[g].max[1] = y;
+               }
+            if(x < groups[g].min[2]){
+               groups[g].min[2] = x;
+               }
+            if(x > groups[g].max[2]){
+               groups[g].max[2] = x;
+               }
+            groups[g].max[0] = z;
+            groups[g].sum[0] += z;
+            groups[g].sum[1] += y;
+            groups[g].sum[2] += x;
+            }
+         }
+      }
+
+   if(verbose){
+      fprintf(stdout, "Found %d unique groups, sorting...\n", num_groups);
+      }
+   qsort(groups, num_groups, sizeof(group_info_struct), &compare_group_info);
+
+   ALLOC(trans, num_groups + 1);
+   for(g = 0; g < num_groups; g++){
+      trans[groups[g].orig_label] = g + 1;      /* +1 to bump past 0 */
+      }
+
+   /* write out the labels */
+   idx = 0;
+   for(z = 0; z < sizes[0]; z++){
+      for(y = 0; y < slice_size; y++, idx++){
+         slice[y] = (parent[idx] == UINT_MAX) ? 0.0 : trans[parent[idx] - nvoxels];
+         }
+      set_volume_value_hyperslab_3d(vol, z, 0, 0, 1, sizes[1], sizes[2], slice);
+      }
+
+   /* and the table of groups */
+   if(table_file != NULL){
+      if((fp = fopen(table_file, "w")) == NULL){
+         fprintf(stderr, "Couldn't open %s for writing\n\n", table_file);
+         exit(EXIT_FAILURE);
+         }
+
+      for(n = 0; n < MAX_VAR_DIMS; n++){
+         voxel[n] = 0.0;
+         }
+      fprintf(fp, "label count x_min y_min z_min x_max y_max z_max "
+              "centroid_x centroid_y centroid_z\n");
+      for(g = 0; g < num_groups; g++){
+         for(n = 0; n < 3; n++){
+            voxel[n] = groups[g].sum[n] / groups[g].count;
+            }
+         convert_voxel_to_world(vol, voxel, &world[0], &world[1], &world[2]);
+         fprintf(fp, "%u %u %d %d %d %d %d %d %g %g %g\n", g + 1, groups[g].count,
+                 groups[g].min[2], groups[g].min[1], groups[g].min[0],
+                 groups[g].max[2], groups[g].max[1], groups[g].max[0],
+                 world[0], world[1], world[2]);
+         }
+      fclose(fp);
+      }
+
+   FREE(trans);
+   FREE(groups);
+   FREE(slabs);
+   FREE(slice);
+   FREE(parent);
+   FREE(offsets);
+   return TRUE;
+   }
+
 /* do connected components labelling on a volume */
 /* resulting groups are sorted WRT size          */
-VIO_Volume  group_kernel(Kernel * K, VIO_Volume vol, double bg)
+VIO_Volume  group_kernel(Kernel * K, VIO_Volume vol, double bg, int nthreads,
+                         char *table_file)
 {
    int      x, y, z;
    int      sizes[MAX_VAR_DIMS];
@@ -509,6 +1754,17 @@ VIO_Volume  group_kernel(Kernel * K, VIO_Volume vol, double bg)
       print_kernel(k2);
       }
 
+   /* use the flat label buffer if we can */
+   if(flat_kernel_ok(K, vol, FALSE) && flat_group(k1, vol, bg, nthreads, table_file)){
+      free(k1);
+      free(k2);
+      return (vol);
+      }
+   if(table_file != NULL){
+      fprintf(stderr, "Warning: group table needs a 3D float volume of less than %u voxels, not written\n",
+              UINT_MAX / 2);
+      }
+
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2], "Groups");
 
@@ -741,6 +1997,12 @@ VIO_Volume lcorr_kernel(Kernel * K, VIO_Volume vol, VIO_Volume cmp)
    get_volume_sizes(vol, sizes);
    initialize_progress_report(&progress, FALSE, sizes[2], "Local Correlation");
 
+   /* use the flat copies if we can */
+   if(flat_kernel_ok(K, vol, FALSE) && flat_lcorr(K, vol, cmp, &progress)){
+      terminate_progress_report(&progress);
+      return (vol);
+      }
+
    /* copy the volume */
    tmp_vol = copy_volume(vol);
    
@@ -13,10 +13,13 @@ VIO_Volume  pad(Kernel * K, VIO_Volume vol, double bg);
 VIO_Volume  erosion_kernel(Kernel * K, VIO_Volume vol);
 VIO_Volume  dilation_kernel(Kernel * K, VIO_Volume vol);
 VIO_Volume  median_dilation_kernel(Kernel * K, VIO_Volume vol);
+VIO_Volume  morph_chain(Kernel * K, VIO_Volume vol, char *steps);
 VIO_Volume  zero_dilation_kernel(Kernel * K, VIO_Volume vol);
 VIO_Volume  convolve_kernel(Kernel * K, VIO_Volume vol);
 VIO_Volume  distance_kernel(Kernel * K, VIO_Volume vol, double bg);
-VIO_Volume  group_kernel(Kernel * K, VIO_Volume vol, double bg);
+VIO_Volume  euclidean_distance(VIO_Volume vol, double bg, int signed_dist, int nthreads);
+VIO_Volume  group_kernel(Kernel * K, VIO_Volume vol, double bg, int nthreads,
+                         char *table_file);
 VIO_Volume  lcorr_kernel(Kernel * K, VIO_Volume vol, VIO_Volume cmp);
 
 #endif
@@ -48,7 +48,7 @@ typedef enum {
    UNDEF = 0,
    BINARISE, CLAMP, PAD, ERODE, DILATE, MDILATE,
    OPEN, CLOSE, LPASS, HPASS, CONVOLVE, DISTANCE,
-   GROUP, READ_KERNEL, WRITE, LCORR
+   GROUP, READ_KERNEL, WRITE, LCORR, EUCLID
    } op_types;
 
 typedef struct {
@@ -63,6 +63,8 @@ typedef struct {
    double   background;
    } Operation;
 
+char    *get_morph_steps(op_types type);
+
 /* Argument variables */
 int      verbose = FALSE;
 int      clobber = FALSE;
@@ -74,6 +76,9 @@ double   background = 0.0;
 kern_types kernel_id = K_NULL;
 char    *kernel_fn = NULL;
 char    *succ_txt = "B";
+int      signed_dist = FALSE;
+int      nthreads = 1;
+char    *group_table = NULL;
 
 char     successive_help[] = "Successive operations (Maximum: 100) \
 \n\tB[floor:ceil:fg:bg] - binarise in the range, using foreground and background \
@@ -88,6 +93,7 @@ char     successive_help[] = "Successive operations (Maximum: 100) \
 \n\tH - highpass filter \
 \n\tX - convolve \
 \n\tF - distance transform (binary input only - not checked) \
+\n\tT - exact Euclidean distance transform (binary input only - not checked) \
 \n\tG - Label the groups in the volume in ascending order \
 \n\tR[TYPE|file.kern] - (2D04|2D08|3D06|3D26) or read in a kernel file \
 \n\tW[file.mnc] - write out current results \
@@ -102,6 +108,8 @@ ArgvInfo argTable[] = {
     "be verbose"},
    {"-clobber", ARGV_CONSTANT, (char *)TRUE, (char *)&clobber,
     "clobber existing files"},
+   {"-threads", ARGV_INT, (char *)1, (char *)&nthreads,
+    "Number of threads used by the Euclidean distance transform and group\n\t\tlabelling (default 1)"},
 
    {NULL, ARGV_HELP, NULL, NULL,
     "\nOutfile Options"},
@@ -145,6 +153,8 @@ ArgvInfo argTable[] = {
     "foreground value"},
    {"-background", ARGV_FLOAT, (char *)1, (char *)&background,
     "background value"},
+   {"-signed_distance", ARGV_CONSTANT, (char *)TRUE, (char *)&signed_dist,
+    "Euclidean distance transform: give background voxels the negative\n\t\tdistance to the foreground"},
 
    {NULL, ARGV_HELP, (char *)NULL, (char *)NULL, "\nSingle morphological operations:"},
    {"-binarise", ARGV_CONSTANT, (char *)"B", (char *)&succ_txt,
@@ -171,8 +181,12 @@ ArgvInfo argTable[] = {
     "convolve file with kernel"},
    {"-distance", ARGV_CONSTANT, (char *)"F", (char *)&succ_txt,
     "distance transform"},
+   {"-edt", ARGV_CONSTANT, (char *)"T", (char *)&succ_txt,
+    "exact Euclidean distance transform (in world units)"},
    {"-group", ARGV_CONSTANT, (char *)"G", (char *)&succ_txt,
     "label groups in ascending order"},
+   {"-group_table", ARGV_STRING, (char *)1, (char *)&group_table,
+    "<file.txt> write the count, bounding box and centroid of each group"},
 
    {NULL, ARGV_HELP, (char *)NULL, (char *)NULL,
     "\nSuccessive morphological operations:"},
@@ -197,6 +211,7 @@ int main(int argc, char *argv[])
    Operation *op;
    char    *tmp_str;
    char     ext_txt[256];
+   char     steps[401];
    char     tmp_filename[MAXPATHLEN];
    double   tmp_double[4];
    double   min, max;
@@ -235,6 +250,25 @@ int main(int argc, char *argv[])
       exit(EXIT_FAILURE);
       }
 
+   /* check for the group table */
+   if(group_table != NULL && access(group_table, F_OK) == 0 && !clobber){
+      fprintf(stderr, "%s: %s exists! (use -clobber to overwrite)\n\n", argv[0],
+              group_table);
+      exit(EXIT_FAILURE);
+      }
+
+   /* check the number of threads */
+   if(nthreads < 1){
+      fprintf(stderr, "Number of threads must be at least 1.\n");
+      exit(EXIT_FAILURE);
+      }
+#ifndef HAVE_PTHREAD
+   if(nthreads > 1){
+      fprintf(stderr, "Warning: no thread support, ignoring -threads.\n");
+      nthreads = 1;
+      }
+#endif
+
    /* set the default kernel */
    if(kernel_fn == NULL && kernel_id == K_NULL){
       kernel_id = K_3D06;
@@ -343,6 +377,10 @@ int main(int argc, char *argv[])
          op->type = DISTANCE;
          break;
 
+      case 'T':
+         op->type = EUCLID;
+         break;
+
       case 'G':
          op->type = GROUP;
          break;
@@ -478,32 +516,22 @@ int main(int argc, char *argv[])
          break;
 
       case ERODE:
-         volume = erosion_kernel(kernel, volume);
-         break;
-
       case DILATE:
-         volume = dilation_kernel(kernel, volume);
-         break;
-
-      case MDILATE:
-         volume = median_dilation_kernel(kernel, volume);
-         break;
-
       case OPEN:
-         volume = erosion_kernel(kernel, volume);
-         volume = dilation_kernel(kernel, volume);
-         break;
-
       case CLOSE:
-         volume = dilation_kernel(kernel, volume);
-         volume = erosion_kernel(kernel, volume);
+      case LPASS:
+         /* run this and any following erosions and dilations together */
+         strcpy(steps, "");
+         while(c < num_ops && get_morph_steps(operation[c].type) != NULL){
+            strcat(steps, get_morph_steps(operation[c].type));
+            c++;
+            }
+         c--;
+         volume = morph_chain(kernel, volume, steps);
          break;
 
-      case LPASS:
-         volume = erosion_kernel(kernel, volume);
-         volume = dilation_kernel(kernel, volume);
-         volume = dilation_kernel(kernel, volume);
-         volume = erosion_kernel(kernel, volume);
+      case MDILATE:
+         volume = median_dilation_kernel(kernel, volume);
          break;
 
       case HPASS:
@@ -518,8 +546,12 @@ int main(int argc, char *argv[])
          volume = distance_kernel(kernel, volume, background);
          break;
 
+      case EUCLID:
+         volume = euclidean_distance(volume, background, signed_dist, nthreads);
+         break;
+
       case GROUP:
-         volume = group_kernel(kernel, volume, background);
+         volume = group_kernel(kernel, volume, background, nthreads, group_table);
          break;
 
       case READ_KERNEL:
@@ -743,3 +775,22 @@ void calc_volume_range(VIO_Volume vol, double *min, double *max)
       fprintf(stdout, "Found range of [%g:%g]\n", *min, *max);
       }
    }
+
+/* erosions (E) and dilations (D) that make up an operation */
+char    *get_morph_steps(op_types type)
+{
+   switch (type){
+   case ERODE:
+      return "E";
+   case DILATE:
+      return "D";
+   case OPEN:
+      return "ED";
+   case CLOSE:
+      return "DE";
+   case LPASS:
+      return "EDDE";
+   default:
+      return NULL;
+      }
+   }
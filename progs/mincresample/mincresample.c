@@ -330,7 +330,8 @@ static void get_arginfo(int argc, char *argv[],
       {-DBL_MAX, -DBL_MAX},   /* Flag that range not set */
       FILL_DEFAULT,           /* Flag indicating that fillvalue not set */
       {NO_VALUE, NO_VALUE, NO_VALUE}, /* Flag indicating that origin not set */
-      {TRUE},                 /* Verbose */
+      {TRUE, 1, 0.0},         /* Verbose, number of threads, 
+                                 exact non-linear transforms */
       TRILINEAR,              /* use trilinear interpolation by default */
       {FALSE, NULL, NULL, 0, NULL}, /* Transformation info is empty at start.
                                  Transformation must be set before invoking
@@ -368,9 +369,15 @@ static void get_arginfo(int argc, char *argv[],
       {"-quiet", ARGV_CONSTANT, (char *) FALSE,
           (char *) &args.flags.verbose,
           "Do not print out any log messages.\n"},
+      {"-threads", ARGV_INT, (char *) 1,
+          (char *) &args.flags.nthreads,
+          "Number of threads used to compute output slices (default 1).\n"},
       {"-transformation", ARGV_FUNC, (char *) get_transformation, 
           (char *) &args.transform_info,
           "File giving world transformation. (Default = identity)."},
+      {"-transform_tolerance", ARGV_FLOAT, (char *) 1,
+          (char *) &args.flags.transform_tolerance,
+          "Error (in input voxels) allowed for non-linear transforms (default 0).\n"},
       {"-invert_transformation", ARGV_CONSTANT, (char *) TRUE,
           (char *) &args.transform_info.invert_transform,
           "Invert the transformation before using it.\n"},
@@ -665,6 +672,7 @@ static void get_arginfo(int argc, char *argv[],
                  sinc_half_width);
          exit(EXIT_FAILURE);
      }
+     init_windowed_sinc();
      break;
    default:
      (void) fprintf(stderr, "Error determining interpolation type\n");
@@ -686,6 +694,7 @@ static void get_arginfo(int argc, char *argv[],
       size = input_volume_def.nelements[idim];
       total_size *= size;
       in_vol->volume->size[index] = size;
+      in_vol->volume->start[index] = 0;
    }
    in_vol->volume->data = malloc((size_t) total_size * 
                                  nctypelen(in_vol->volume->datatype));
@@ -696,6 +705,25 @@ static void get_arginfo(int argc, char *argv[],
    in_vol->volume->offset = 
       malloc(sizeof(double) * in_vol->volume->size[SLC_AXIS]);
 
+   /* Check the transformation tolerance */
+   if (args.flags.transform_tolerance < 0.0) {
+      (void) fprintf(stderr, "Transformation tolerance must not be negative.\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Check the number of threads */
+   if (args.flags.nthreads < 1) {
+      (void) fprintf(stderr, "Number of threads must be at least 1.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if (args.flags.nthreads > 1) {
+      (void) fprintf(stderr, 
+                     "Warning: no thread support, ignoring -threads.\n");
+      args.flags.nthreads = 1;
+   }
+#endif
+
    /* Save the program flags */
    *program_flags = args.flags;
 
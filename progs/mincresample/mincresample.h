@@ -149,6 +149,9 @@
 #define TRANSFORM_BUFFER_INCREMENT 256
 #define PROCESSING_VAR "processing"
 #define TEMP_IMAGE_VAR "mincresample-temporary-image"
+#define SLICE_BUFFERS_PER_THREAD 2   /* Depth of the slice reorder buffer */
+#define TRANSFORM_LATTICE_SPACING 8  /* Voxels between lattice nodes used
+                                        to approximate non-linear transforms */
 #ifndef TRUE
 #  define TRUE 1
 #  define FALSE 0
@@ -206,6 +209,8 @@ struct Volume_Data_Struct {
    double vrange[2];         /* [0]=min, [1]=max */
    double real_range[2];     /* Real min and max for current volume */
    int size[VOL_NDIMS];      /* Size of each dimension */
+   long start[VOL_NDIMS];    /* File index of first voxel in data (only
+                                part of the input volume may be loaded) */
    void *data;               /* Pointer to volume data */
    double *scale;            /* Pointer to array of scales for slices */
    double *offset;           /* Pointer to array of offsets for slices */
@@ -234,6 +239,9 @@ typedef struct {
 
 typedef struct {
    int verbose;
+   int nthreads;             /* Number of threads computing output slices */
+   double transform_tolerance; /* Allowed error (input voxels) when 
+                                  approximating non-linear transforms */
 } Program_Flags;
 
 typedef struct {
@@ -368,6 +376,7 @@ extern int nearest_neighbour_interpolant(Volume_Data *volume,
                                          Coord_Vector coord, double *result);
 extern int windowed_sinc_interpolant(Volume_Data *volume,
                                      Coord_Vector coord, double *result);
+extern void init_windowed_sinc(void);
 
 #define SINC_HALF_WIDTH_MAX 10
 #define SINC_HALF_WIDTH_MIN 1
@@ -126,13 +126,90 @@
 #include <math.h>
 #include <minc.h>
 #include <volume_io.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include "mincresample.h"
 
+/* Everything about the output voxel to input voxel mapping that does not
+   change from slice to slice. Built once per run by create_transform_plan. */
+typedef struct {
+   VIO_General_transform total_transf; /* Output voxel to input voxel */
+   int all_linear;           /* TRUE if total_transf is linear */
+   Coord_Vector zero;        /* Transformed origin (linear only) */
+   Coord_Vector row;         /* Transformed row step (linear only) */
+   Coord_Vector column;      /* Transformed column step (linear only) */
+   VIO_Real separations[WORLD_NDIMS]; /* Input step sizes */
+   double tolerance;         /* Lattice approximation error bound in input
+                                voxels (0 means transform every voxel) */
+} Transform_Plan;
+
+#ifdef HAVE_PTHREAD
+typedef struct Slice_Pool Slice_Pool;
+
+/* Each worker thread gets its own copy of the transform plan */
+typedef struct {
+   Slice_Pool *pool;
+   Transform_Plan plan;
+} Slice_Worker;
+
+/* Reorder buffer shared by the slice workers and the (single) writer. 
+   Slice islice is computed into slot islice % nbuffers, so a worker may
+   only claim a slice once the slice nbuffers before it has been written. */
+struct Slice_Pool {
+   VVolume *in_vol;
+   VVolume *out_vol;
+   long nslice;              /* Number of slices in current volume */
+   long next_slice;          /* Next slice to be claimed by a worker */
+   long next_write;          /* Next slice to be released by the writer */
+   int nbuffers;             /* Number of slots in the reorder buffer */
+   double **data;            /* Slice data for each slot */
+   double *minimum;          /* Slice minimum for each slot */
+   double *maximum;          /* Slice maximum for each slot */
+   int *ready;               /* TRUE if slot holds a computed slice */
+   int nthreads;
+   pthread_t *threads;
+   Slice_Worker *workers;
+   pthread_mutex_t lock;
+   pthread_cond_t slot_free;
+   pthread_cond_t slot_ready;
+};
+
+static Slice_Pool *create_slice_pool(int nthreads, long slice_size);
+static void start_slice_pool(Slice_Pool *pool, long nslice,
+                             VVolume *in_vol, VVolume *out_vol,
+                             Transform_Plan *plan);
+static void *slice_worker(void *arg);
+static double *wait_for_slice(Slice_Pool *pool, long islice,
+                              double *minimum, double *maximum);
+static void release_slice(Slice_Pool *pool, long islice);
+static void stop_slice_pool(Slice_Pool *pool);
+static void delete_slice_pool(Slice_Pool *pool);
+#endif
+
 static void load_volume(File_Info *file, long start[], long count[],
                         Volume_Data *volume);
+static void get_input_separations(File_Info *file, VIO_Real separations[]);
+static int get_input_region(Transform_Plan *plan, 
+                            VVolume *in_vol, VVolume *out_vol,
+                            long region_start[], long region_count[]);
+static int get_interpolant_margin(Volume_Data *volume);
+static void create_transform_plan(Program_Flags *program_flags,
+                                  VVolume *in_vol, VVolume *out_vol,
+                                  VIO_General_transform *transformation,
+                                  Transform_Plan *plan);
+static void copy_transform_plan(Transform_Plan *plan, Transform_Plan *copy);
+static void delete_transform_plan(Transform_Plan *plan);
 static void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
-                      VIO_General_transform *transformation,
+                      Transform_Plan *plan, double *slice_data,
                       double *minimum, double *maximum);
+static void transform_slice_point(Transform_Plan *plan, long slice_num,
+                                  long irow, long icol, 
+                                  Coord_Vector transf_coord);
+static void get_slice_lattice(Transform_Plan *plan, long slice_num,
+                              long nrows, long ncols,
+                              long nlat_rows, long nlat_cols,
+                              Coord_Vector *lattice, char *exact_cell);
 static void renormalize_slices(Program_Flags *program_flags, VVolume *out_vol,
                                double slice_min[], double slice_max[]);
 static int do_Ncubic_interpolation(Volume_Data *volume, 
@@ -162,18 +239,38 @@ void resample_volumes(Program_Flags *program_flags,
                       VIO_General_transform *transformation)
 {
    long in_start[MAX_VAR_DIMS], in_count[MAX_VAR_DIMS], in_end[MAX_VAR_DIMS];
+   long in_first[MAX_VAR_DIMS];
+   long region_start[VOL_NDIMS], region_count[VOL_NDIMS];
    long out_start[MAX_VAR_DIMS], out_count[MAX_VAR_DIMS];
    long mm_start[MAX_VAR_DIMS];   /* VIO_Vector for min/max variables */
    long nslice, islice, slice_count;
    int idim, index, slice_index;
    double maximum, minimum, valid_range[2];
    double *slice_max, *slice_min;
+   double *slice_data;
+   Transform_Plan plan;
    File_Info *ifp,*ofp;
+#ifdef HAVE_PTHREAD
+   Slice_Pool *pool = NULL;
+#endif
 
    /* Set pointers to file information */
    ifp = in_vol->file;
    ofp = out_vol->file;
 
+   /* Work out the voxel to voxel transformation once for all slices */
+   create_transform_plan(program_flags, in_vol, out_vol, transformation,
+                         &plan);
+
+#ifdef HAVE_PTHREAD
+   /* Set up the workers that compute slices ahead of the writer */
+   if (program_flags->nthreads > 1) {
+      pool = create_slice_pool(program_flags->nthreads,
+                               out_vol->slice->size[SLICE_ROW] *
+                               out_vol->slice->size[SLICE_COL]);
+   }
+#endif
+
    /* Allocate slice min/max arrays if needed */
    if (ofp->do_slice_renormalization) {
       slice_min = malloc(ofp->images_per_file * ofp->slices_per_image *
@@ -194,6 +291,41 @@ void resample_volumes(Program_Flags *program_flags,
       in_count[index] = ifp->nelements[index];
    }
 
+   /* Only read the part of the input volume that the output grid can
+      reach, and shrink the volume buffer to match. With -keep_real_range
+      the whole volume is read, since the range written to every output
+      slice must be that of the whole input volume. */
+   if (!ofp->keep_real_range &&
+       get_input_region(&plan, in_vol, out_vol, 
+                        region_start, region_count)) {
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         index = ifp->indices[idim];
+         in_start[index] = region_start[idim];
+         in_count[index] = region_count[idim];
+         in_end[index] = region_start[idim] + region_count[idim];
+         in_vol->volume->start[idim] = region_start[idim];
+         in_vol->volume->size[idim] = region_count[idim];
+      }
+      free(in_vol->volume->data);
+      in_vol->volume->data = malloc((size_t) region_count[SLC_AXIS] * 
+                                    region_count[ROW_AXIS] *
+                                    region_count[COL_AXIS] * 
+                                    nctypelen(in_vol->volume->datatype));
+      if (program_flags->verbose) {
+         (void) fprintf(stderr, 
+                        "Reading input voxels [%ld:%ld, %ld:%ld, %ld:%ld]\n",
+                        region_start[0], 
+                        region_start[0] + region_count[0] - 1,
+                        region_start[1], 
+                        region_start[1] + region_count[1] - 1,
+                        region_start[2], 
+                        region_start[2] + region_count[2] - 1);
+      }
+   }
+   for (idim=0; idim < ifp->ndims; idim++) {
+      in_first[idim] = in_start[idim];
+   }
+
    /* Set output file count for writing a slice and get the number of 
       output slices */
    (void) miset_coords(ifp->ndims, (long) 1, out_count);
@@ -225,13 +357,22 @@ void resample_volumes(Program_Flags *program_flags,
 
    while (in_start[0] < in_end[0]) {
 
-      /* Copy the start vector */
+      /* Copy the start vector (spatial dimensions always start at zero
+         in the output) */
       for (idim=0; idim < ifp->ndims; idim++)
          out_start[idim] = in_start[idim];
+      for (idim=0; idim < VOL_NDIMS; idim++)
+         out_start[ofp->indices[idim]] = 0;
 
       /* Read in the volume */
       load_volume(ifp, in_start, in_count, in_vol->volume);
 
+#ifdef HAVE_PTHREAD
+      if (pool != NULL) {
+         start_slice_pool(pool, nslice, in_vol, out_vol, &plan);
+      }
+#endif
+
       /* Loop over slices */
       for (islice=0; islice < nslice; islice++) {
 
@@ -244,9 +385,18 @@ void resample_volumes(Program_Flags *program_flags,
          /* Set slice number in out_start */
          out_start[slice_index] = islice;
 
-         /* Get the slice */
-         get_slice(islice, in_vol, out_vol, transformation, 
-                   &minimum, &maximum);
+         /* Get the slice, either from the workers or by computing it */
+#ifdef HAVE_PTHREAD
+         if (pool != NULL) {
+            slice_data = wait_for_slice(pool, islice, &minimum, &maximum);
+         }
+         else
+#endif
+         {
+            slice_data = out_vol->slice->data;
+            get_slice(islice, in_vol, out_vol, &plan,
+                      slice_data, &minimum, &maximum);
+         }
 
          /* Check whether we are keep the input range */
          if (ofp->keep_real_range) {
@@ -269,8 +419,14 @@ void resample_volumes(Program_Flags *program_flags,
                                              ofp->imgid, out_start,
                                              ofp->minid, mm_start),
                           NC_DOUBLE, NULL, &minimum);
-         (void) miicv_put(ofp->icvid, out_start, out_count,
-                          out_vol->slice->data);
+         (void) miicv_put(ofp->icvid, out_start, out_count, slice_data);
+
+#ifdef HAVE_PTHREAD
+         /* Hand the slot back to the workers */
+         if (pool != NULL) {
+            release_slice(pool, islice);
+         }
+#endif
 
          /* Save the max, min if needed */
          if (ofp->do_slice_renormalization) {
@@ -283,17 +439,32 @@ void resample_volumes(Program_Flags *program_flags,
 
       }    /* End loop over slices */
 
+#ifdef HAVE_PTHREAD
+      /* Wait for the workers before the volume data is replaced */
+      if (pool != NULL) {
+         stop_slice_pool(pool);
+      }
+#endif
+
       /* Increment in_start counter */
       idim = ofp->ndims-1;
       in_start[idim] += in_count[idim];
       while ( (idim>0) && (in_start[idim] >= in_end[idim])) {
-         in_start[idim] = 0;
+         in_start[idim] = in_first[idim];
          idim--;
          in_start[idim] += in_count[idim];
       }
 
    }       /* End loop over volumes */
 
+#ifdef HAVE_PTHREAD
+   if (pool != NULL) {
+      delete_slice_pool(pool);
+   }
+#endif
+
+   delete_transform_plan(&plan);
+
    /* Print end of log message */
    if (program_flags->verbose) {
       (void) fprintf(stderr, "Done\n");
@@ -453,126 +624,398 @@ void load_volume(File_Info *file, long start[], long count[],
    }        /* End of loop through slices */
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_separations
+@INPUT      : file - description of input file
+@OUTPUT     : separations - step sizes of the input volume, subscripted
+                 by world axis
+@RETURNS    : (none)
+@DESCRIPTION: Gets the step sizes (separations) of the input volume in 
+              order to get an appropriate error margin (ftol) for the 
+              function grid_inverse_transform_point.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : February 8, 1993 (Peter Neelin)
+@MODIFIED   : Moved out of get_slice so that it is only done once and
+              so that get_slice makes no netcdf calls.
+---------------------------------------------------------------------------- */
+static void get_input_separations(File_Info *file, VIO_Real separations[])
+{
+   int  idim_in, axis;
+   char dimname[MAX_NC_NAME];
+   int  dim[MAX_VAR_DIMS], dimid;
+   int  imgid;
+   int  ndims;
+
+   for (axis=0; axis < WORLD_NDIMS; axis++)
+      separations[axis] = 1.0;
+
+   imgid = ncvarid(file->mincid, MIimage);
+   ncvarinq(file->mincid, imgid, NULL, NULL, &ndims, dim, NULL);
+
+   for (idim_in=0; idim_in < file->ndims; idim_in++) {
+
+      /* Only spatial dimensions have a separation */
+      axis = file->world_axes[idim_in];
+      if (axis == NO_AXIS) continue;
+      
+      /* Get size of dimension */
+      (void) ncdiminq(file->mincid, dim[idim_in], dimname, 
+               &file->nelements[idim_in]);
+      
+      /* Check for existence of variable */
+      dimid = ncvarid(file->mincid, dimname);
+      if (dimid == MI_ERROR) continue;
+
+      /* Get attributes from variable */
+      (void) miattget1(file->mincid, dimid, MIstep, 
+                       NC_DOUBLE, &separations[axis]);
+
+      if (separations[axis] == 0.0)
+          separations[axis] = 1.0;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_region
+@INPUT      : plan - output voxel to input voxel mapping
+              in_vol - description of input volume
+              out_vol - description of output volume
+@OUTPUT     : region_start - first input voxel needed along each volume axis
+              region_count - number of input voxels needed along each axis
+@RETURNS    : TRUE if only part of the input volume is needed, FALSE if 
+              the whole volume must be read.
+@DESCRIPTION: Works out the box of input voxels that can contribute to 
+              the output volume, so that a small output sampled from a 
+              large input does not require the whole input in memory.
+@METHOD     : The corners of the output voxel grid are mapped into the 
+              input and the bounding box is padded by the support of the
+              interpolant, so interpolated values (including the choice 
+              of edge handling) are the same as for the whole volume. 
+              Only linear transformations are handled; for anything else,
+              or for files read through an icv (which normalizes over the
+              region read), the whole volume is used.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int get_input_region(Transform_Plan *plan, 
+                            VVolume *in_vol, VVolume *out_vol,
+                            long region_start[], long region_count[])
+{
+   File_Info *ifp, *ofp;
+   Coord_Vector corner, transf_corner;
+   double lower[VOL_NDIMS], upper[VOL_NDIMS];
+   long nvoxels[VOL_NDIMS], first, last;
+   int icorner, idim, margin, is_partial;
+
+   ifp = in_vol->file;
+   ofp = out_vol->file;
+   if (!plan->all_linear || ifp->using_icv) return FALSE;
+
+   /* Map the corners of the output grid */
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      lower[idim] =  DBL_MAX;
+      upper[idim] = -DBL_MAX;
+      nvoxels[idim] = ofp->nelements[ofp->indices[idim]];
+   }
+   for (icorner=0; icorner < (1 << VOL_NDIMS); icorner++) {
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         corner[idim] = ((icorner >> idim) & 1) ? nvoxels[idim] - 1 : 0;
+      }
+      DO_TRANSFORM(transf_corner, &plan->total_transf, corner);
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         if (transf_corner[idim] < lower[idim]) 
+            lower[idim] = transf_corner[idim];
+         if (transf_corner[idim] > upper[idim]) 
+            upper[idim] = transf_corner[idim];
+      }
+   }
+
+   /* Pad by the interpolant support and clip to the input volume. The
+      box is clamped before padding so that an output lying partly or 
+      wholly outside the input still gets a box of at least margin+1 
+      voxels (interpolants treat single-voxel dimensions specially). */
+   margin = get_interpolant_margin(in_vol->volume);
+   is_partial = FALSE;
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      nvoxels[idim] = ifp->nelements[ifp->indices[idim]];
+      if ((lower[idim] != lower[idim]) || (upper[idim] != upper[idim])) {
+         first = 0;
+         last = nvoxels[idim] - 1;
+      }
+      else {
+         lower[idim] = MAX(0.0, MIN(lower[idim], nvoxels[idim] - 1));
+         upper[idim] = MAX(0.0, MIN(upper[idim], nvoxels[idim] - 1));
+         first = MAX(0, (long) floor(lower[idim]) - margin);
+         last = MIN(nvoxels[idim] - 1, (long) ceil(upper[idim]) + margin);
+      }
+      region_start[idim] = first;
+      region_count[idim] = last - first + 1;
+      if (region_count[idim] < nvoxels[idim]) is_partial = TRUE;
+   }
+
+   return is_partial;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_interpolant_margin
+@INPUT      : volume - description of input volume
+@OUTPUT     : (none)
+@RETURNS    : Number of voxels beyond the sampled point that the
+              interpolant may read, plus one for rounding.
+@DESCRIPTION: Gives the padding used by get_input_region.
+@METHOD     : 
+@GLOBALS    : sinc_half_width
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int get_interpolant_margin(Volume_Data *volume)
+{
+   if (volume->interpolant == windowed_sinc_interpolant)
+      return sinc_half_width + 2;
+   else if (volume->interpolant == tricubic_interpolant)
+      return 3;
+   else
+      return 2;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_transform_plan
+@INPUT      : program_flags - data for program execution
+              in_vol - description of input volume
+              out_vol - description of output volume
+              transformation - description of world transformation
+@OUTPUT     : plan - output voxel to input voxel mapping
+@RETURNS    : (none)
+@DESCRIPTION: Concatenates the output voxel-to-world, world and input 
+              world-to-voxel transformations and gets everything else 
+              needed by get_slice that is the same for every slice.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void create_transform_plan(Program_Flags *program_flags,
+                                  VVolume *in_vol, VVolume *out_vol,
+                                  VIO_General_transform *transformation,
+                                  Transform_Plan *plan)
+{
+   VIO_General_transform temp_transf;
+   int idim;
+
+   /* Concatenate transforms */
+   concat_general_transforms(out_vol->voxel_to_world, 
+                             transformation, &temp_transf);
+   concat_general_transforms(&temp_transf, in_vol->world_to_voxel,
+                             &plan->total_transf);
+   delete_general_transform(&temp_transf);
+
+   /* Check for complete linear transformation */
+   plan->all_linear = (get_transform_type(&plan->total_transf) == LINEAR);
+
+   /* Get the row and column vectors (the start of each slice is still
+      transformed separately so that results do not depend on the 
+      slice number through accumulated rounding) */
+   for (idim=0; idim < WORLD_NDIMS; idim++) {
+      plan->zero[idim] = 0.0;
+      plan->row[idim] = 0.0;
+      plan->column[idim] = 0.0;
+   }
+   plan->row[ROW] = 1.0;
+   plan->column[COLUMN] = 1.0;
+   if (plan->all_linear) {
+      DO_TRANSFORM(plan->zero, &plan->total_transf, plan->zero);
+      DO_TRANSFORM(plan->row, &plan->total_transf, plan->row);
+      DO_TRANSFORM(plan->column, &plan->total_transf, plan->column);
+   }
+
+   /* Make sure that row and column are vectors and not points */
+   VECTOR_DIFF(plan->row, plan->row, plan->zero);
+   VECTOR_DIFF(plan->column, plan->column, plan->zero);
+
+   /* Get the input step sizes */
+   get_input_separations(in_vol->file, plan->separations);
+
+   plan->tolerance = program_flags->transform_tolerance;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : copy_transform_plan
+@INPUT      : plan - plan to copy
+@OUTPUT     : copy - new plan with its own copy of the transformation
+@RETURNS    : (none)
+@DESCRIPTION: Copies a transform plan. Non-linear transformations may keep
+              state between calls (see irregular_inverse_transform_function)
+              so each thread needs its own copy.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void copy_transform_plan(Transform_Plan *plan, Transform_Plan *copy)
+{
+   *copy = *plan;
+   copy_general_transform(&plan->total_transf, &copy->total_transf);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_transform_plan
+@INPUT      : plan - plan to delete
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Frees the transformation held by a plan.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void delete_transform_plan(Transform_Plan *plan)
+{
+   delete_general_transform(&plan->total_transf);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : get_slice
 @INPUT      : in_vol - description of input volume
               out_vol - description of output volume
-              transformation - description of world transformation
-@OUTPUT     : out_vol - slice field contains new slice
+              plan - output voxel to input voxel mapping
+@OUTPUT     : slice_data - new slice
               minimum - slice minimum (excluding data from outside volume)
               maximum - slice maximum (excluding data from outside volume)
 @RETURNS    : (none)
-@DESCRIPTION: Resamples current volume of in_vol into slice in out_vol 
-              using given world transformation.
-@METHOD     : 
+@DESCRIPTION: Resamples current volume of in_vol into slice_data (with the
+              dimensions of the slice in out_vol) using the given plan. 
+              Does not modify any shared state, so it can be called 
+              concurrently for different slices as long as non-linear 
+              plans are not shared between threads.
+@METHOD     : Linear transformations are stepped incrementally along rows.
+              Non-linear transformations are either applied to every voxel
+              or, if plan->tolerance > 0, evaluated on a coarse lattice 
+              and interpolated (see get_slice_lattice).
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 8, 1993 (Peter Neelin)
 @MODIFIED   : 
 ---------------------------------------------------------------------------- */
-void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol, 
-               VIO_General_transform *transformation, 
-               double *minimum, double *maximum)
+static void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol, 
+                      Transform_Plan *plan, double *slice_data,
+                      double *minimum, double *maximum)
 {
    Slice_Data *slice;
    Volume_Data *volume;
    double *dptr;
-   long irow, icol;
-   int all_linear;
+   long irow, icol, nrows, ncols;
+   long nlat_rows, nlat_cols, lrow, lcol, cell;
+   double rfrac, cfrac;
    int idim;
+   Coord_Vector *lattice, *node;
+   char *exact_cell;
    
-   VIO_Real separations[WORLD_NDIMS];
-   int  idim_in;
-   char dimname[MAX_NC_NAME];
-   int  dim[MAX_VAR_DIMS], dimid;
-   int  imgid;
-   int  ndims;
    /* Coordinate vectors for stepping through slice */
-   Coord_Vector zero = {0, 0, 0};
-   Coord_Vector column = {0, 0, 1};
-   Coord_Vector row = {0, 1, 0};
    Coord_Vector start = {0, 0, 0};    /* start[SLICE] set later to slice_num */
    Coord_Vector coord, transf_coord;
 
-   /* Transformation stuff */
-   VIO_General_transform total_transf, temp_transf;
-
    /* Get slice and volume pointers */
    volume = in_vol->volume;
    slice = out_vol->slice;
+   nrows = slice->size[SLICE_ROW];
+   ncols = slice->size[SLICE_COL];
 
-   /* Concatenate transforms */
-   concat_general_transforms(out_vol->voxel_to_world, 
-                             transformation, &temp_transf);
-   concat_general_transforms(&temp_transf, in_vol->world_to_voxel,
-                             &total_transf);
-   delete_general_transform(&temp_transf);
-
-   /* Check for complete linear transformation */
-   all_linear = (get_transform_type(&total_transf) == LINEAR);
-
-   /* VIO_Transform vectors for linear transformation */
+   /* VIO_Transform start vector for linear transformation */
    start[SLICE] = slice_num;
-   if (all_linear) {
-      DO_TRANSFORM(zero, &total_transf, zero);
-      DO_TRANSFORM(column, &total_transf, column);
-      DO_TRANSFORM(row, &total_transf, row);
-      DO_TRANSFORM(start, &total_transf, start);
+   if (plan->all_linear) {
+      DO_TRANSFORM(start, &plan->total_transf, start);
    }
 
-   /* Make sure that row and column are vectors and not points */
-   VECTOR_DIFF(row, row, zero);
-   VECTOR_DIFF(column, column, zero);
+   /* Evaluate a non-linear transformation on a coarse lattice if we are
+      allowed to approximate it */
+   lattice = NULL;
+   exact_cell = NULL;
+   lrow = 0;
+   rfrac = 0.0;
+   nlat_rows = (nrows + TRANSFORM_LATTICE_SPACING - 2) / 
+      TRANSFORM_LATTICE_SPACING + 1;
+   nlat_cols = (ncols + TRANSFORM_LATTICE_SPACING - 2) / 
+      TRANSFORM_LATTICE_SPACING + 1;
+   if (!plan->all_linear && (plan->tolerance > 0.0) &&
+       (nlat_rows > 1) && (nlat_cols > 1)) {
+      lattice = malloc(sizeof(Coord_Vector) * nlat_rows * nlat_cols);
+      exact_cell = malloc((nlat_rows-1) * (nlat_cols-1));
+      get_slice_lattice(plan, slice_num, nrows, ncols, nlat_rows, nlat_cols,
+                        lattice, exact_cell);
+   }
 
    /* Initialize maximum and minimum */
    *maximum = -DBL_MAX;
    *minimum =  DBL_MAX;
-   
-   imgid = ncvarid(in_vol->file->mincid, MIimage);
-   ncvarinq(in_vol->file->mincid, imgid, NULL, NULL, &ndims, dim, NULL);
-
-   /* Get the steps sizes (separations) of the input volume in order
-      to get an appropriate error margin (ftol) for the function
-      grid_inverse_transform_point */
-   for (idim_in=0; idim_in < in_vol->file->ndims; idim_in++) {
-      
-      /* Get size of dimension */
-      (void) ncdiminq(in_vol->file->mincid, dim[idim_in], dimname, 
-               &in_vol->file->nelements[idim_in]);
-      
-      /* Check for existence of variable */
-      dimid = ncvarid(in_vol->file->mincid, dimname);
-      if (dimid == MI_ERROR) continue;
-
-      /* Get attributes from variget_file_infoable */
-      (void) miattget1(in_vol->file->mincid, dimid, MIstep, 
-                       NC_DOUBLE, &separations[in_vol->file->world_axes[idim_in]]);
-
-      if (separations[in_vol->file->world_axes[idim_in]] == 0.0)
-          separations[in_vol->file->world_axes[idim_in]] = 1.0;
-   }
 
    /* Loop over rows of slice */
 
-   for (irow=0; irow < slice->size[SLICE_ROW]; irow++) {
+   for (irow=0; irow < nrows; irow++) {
 
       /* Set starting coordinate of row */
-      VECTOR_SCALAR_MULT(coord, row, irow);
+      VECTOR_SCALAR_MULT(coord, plan->row, irow);
       VECTOR_ADD(coord, coord, start);
 
+      /* Get the lattice row and fraction for this row */
+      if (lattice != NULL) {
+         lrow = irow / TRANSFORM_LATTICE_SPACING;
+         if (lrow > nlat_rows-2) lrow = nlat_rows-2;
+         rfrac = (double) (irow - lrow * TRANSFORM_LATTICE_SPACING) / 
+            (MIN((lrow+1) * TRANSFORM_LATTICE_SPACING, nrows-1) - 
+             lrow * TRANSFORM_LATTICE_SPACING);
+      }
+
       /* Loop over columns */
 
-      dptr = slice->data + irow*slice->size[SLICE_COL];
-      for (icol=0; icol < slice->size[SLICE_COL]; icol++) {
+      dptr = slice_data + irow*ncols;
+      for (icol=0; icol < ncols; icol++) {
 
          /* If transformation is not completely linear, then transform 
-            voxel to world, world to world and world to voxel, as needed */
-         for (idim=0; idim<WORLD_NDIMS; idim++) 
-            transf_coord[idim]=coord[idim];
-         if (!all_linear) {
-            DO_TRANSFORM_WITH_INPUT_STEPS(transf_coord, &total_transf, transf_coord, separations);
+            voxel to world, world to world and world to voxel, as needed,
+            or interpolate from the lattice */
+         if (plan->all_linear) {
+            for (idim=0; idim<WORLD_NDIMS; idim++) 
+               transf_coord[idim]=coord[idim];
+         }
+         else if (lattice == NULL) {
+            transform_slice_point(plan, slice_num, irow, icol, transf_coord);
+         }
+         else {
+            lcol = icol / TRANSFORM_LATTICE_SPACING;
+            if (lcol > nlat_cols-2) lcol = nlat_cols-2;
+            cell = lrow * (nlat_cols-1) + lcol;
+            if (exact_cell[cell]) {
+               transform_slice_point(plan, slice_num, irow, icol, 
+                                     transf_coord);
+            }
+            else {
+               cfrac = (double) (icol - lcol * TRANSFORM_LATTICE_SPACING) / 
+                  (MIN((lcol+1) * TRANSFORM_LATTICE_SPACING, ncols-1) - 
+                   lcol * TRANSFORM_LATTICE_SPACING);
+               node = &lattice[lrow * nlat_cols + lcol];
+               for (idim=0; idim<WORLD_NDIMS; idim++) {
+                  transf_coord[idim] = 
+                     (1.0-rfrac) * ((1.0-cfrac) * node[0][idim] + 
+                                    cfrac * node[1][idim]) +
+                     rfrac * ((1.0-cfrac) * node[nlat_cols][idim] + 
+                              cfrac * node[nlat_cols+1][idim]);
+               }
+            }
          }
 
+         /* Make the coordinate relative to the loaded part of the volume
+            (subtracting a whole number of voxels here is exact) */
+         for (idim=0; idim<WORLD_NDIMS; idim++)
+            transf_coord[idim] -= volume->start[idim];
+
          /* Do interpolation */
          if (INTERPOLATE(volume, transf_coord, dptr) || volume->use_fill) {
             if (*dptr > *maximum) *maximum = *dptr;
@@ -580,7 +1023,7 @@ void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
          }
 
          /* Increment coordinate */
-         VECTOR_ADD(coord, coord, column);
+         VECTOR_ADD(coord, coord, plan->column);
 
          /* Increment slice pointer */
          dptr++;
@@ -601,9 +1044,108 @@ void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
          *maximum = 2.0 * (*minimum);
    }
 
-   /* Delete the transformation */
-   delete_general_transform(&total_transf);
+   /* Free the lattice */
+   if (lattice != NULL) {
+      free(lattice);
+      free(exact_cell);
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : transform_slice_point
+@INPUT      : plan - output voxel to input voxel mapping (non-linear)
+              slice_num, irow, icol - output voxel
+@OUTPUT     : transf_coord - input voxel coordinate
+@RETURNS    : (none)
+@DESCRIPTION: Applies a non-linear plan to a single output voxel.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void transform_slice_point(Transform_Plan *plan, long slice_num,
+                                  long irow, long icol, 
+                                  Coord_Vector transf_coord)
+{
+   transf_coord[SLICE] = slice_num;
+   transf_coord[ROW] = irow;
+   transf_coord[COLUMN] = icol;
+   DO_TRANSFORM_WITH_INPUT_STEPS(transf_coord, &plan->total_transf, 
+                                 transf_coord, plan->separations);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_slice_lattice
+@INPUT      : plan - output voxel to input voxel mapping (non-linear)
+              slice_num - output slice
+              nrows, ncols - size of output slice
+              nlat_rows, nlat_cols - size of lattice
+@OUTPUT     : lattice - input voxel coordinates of the lattice nodes
+              exact_cell - TRUE for each lattice cell that cannot be 
+                 interpolated to within plan->tolerance
+@RETURNS    : (none)
+@DESCRIPTION: Evaluates a non-linear transformation on a lattice of output
+              voxels spaced TRANSFORM_LATTICE_SPACING apart (the last row
+              and column of nodes lie on the slice edge). Each lattice cell
+              is checked by transforming its centre voxel exactly and 
+              comparing with the bilinear estimate from its corners; cells
+              that are off by more than the tolerance along any axis are
+              flagged so that get_slice transforms their voxels exactly.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_slice_lattice(Transform_Plan *plan, long slice_num,
+                              long nrows, long ncols,
+                              long nlat_rows, long nlat_cols,
+                              Coord_Vector *lattice, char *exact_cell)
+{
+   long lrow, lcol, row0, row1, col0, col1, irow, icol;
+   double rfrac, cfrac, estimate;
+   int idim;
+   Coord_Vector exact, *node;
+
+   /* Transform the lattice nodes */
+   for (lrow=0; lrow < nlat_rows; lrow++) {
+      irow = MIN(lrow * TRANSFORM_LATTICE_SPACING, nrows-1);
+      for (lcol=0; lcol < nlat_cols; lcol++) {
+         icol = MIN(lcol * TRANSFORM_LATTICE_SPACING, ncols-1);
+         transform_slice_point(plan, slice_num, irow, icol,
+                               lattice[lrow * nlat_cols + lcol]);
+      }
+   }
 
+   /* Check the centre of each cell */
+   for (lrow=0; lrow < nlat_rows-1; lrow++) {
+      row0 = lrow * TRANSFORM_LATTICE_SPACING;
+      row1 = MIN(row0 + TRANSFORM_LATTICE_SPACING, nrows-1);
+      irow = (row0 + row1) / 2;
+      rfrac = (double) (irow - row0) / (row1 - row0);
+      for (lcol=0; lcol < nlat_cols-1; lcol++) {
+         col0 = lcol * TRANSFORM_LATTICE_SPACING;
+         col1 = MIN(col0 + TRANSFORM_LATTICE_SPACING, ncols-1);
+         icol = (col0 + col1) / 2;
+         cfrac = (double) (icol - col0) / (col1 - col0);
+
+         transform_slice_point(plan, slice_num, irow, icol, exact);
+         node = &lattice[lrow * nlat_cols + lcol];
+         exact_cell[lrow * (nlat_cols-1) + lcol] = FALSE;
+         for (idim=0; idim < WORLD_NDIMS; idim++) {
+            estimate =
+               (1.0-rfrac) * ((1.0-cfrac) * node[0][idim] + 
+                              cfrac * node[1][idim]) +
+               rfrac * ((1.0-cfrac) * node[nlat_cols][idim] + 
+                        cfrac * node[nlat_cols+1][idim]);
+            if (fabs(estimate - exact[idim]) > plan->tolerance) {
+               exact_cell[lrow * (nlat_cols-1) + lcol] = TRUE;
+            }
+         }
+      }
+   }
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -626,8 +1168,8 @@ int trilinear_interpolant(Volume_Data *volume,
 {
    long slcind, rowind, colind, slcmax, rowmax, colmax;
    long slcnext, rownext, colnext;
-   static double f0, f1, f2, r0, r1, r2, r1r2, r1f2, f1r2, f1f2;
-   static double v000, v001, v010, v011, v100, v101, v110, v111;
+   double f0, f1, f2, r0, r1, r2, r1r2, r1f2, f1r2, f1f2;
+   double v000, v001, v010, v011, v100, v101, v110, v111;
 
    /* Check that the coordinate is inside the volume */
    slcmax = volume->size[SLC_AXIS] - 1;
@@ -814,106 +1356,158 @@ int tricubic_interpolant(Volume_Data *volume,
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_volume_values
+@INPUT      : volume - pointer to volume data
+              offset - offset of first voxel in volume
+              nvalues - number of consecutive voxels to get
+@OUTPUT     : values - voxel values (not scaled)
+@RETURNS    : (nothing)
+@DESCRIPTION: Gets a run of voxels along a row of the volume, with a single
+              test of the volume data type.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+#define GET_VALUES(type) { \
+   const type *vptr = (const type *) volume->data + offset; \
+   for (ival=0; ival < nvalues; ival++) values[ival] = vptr[ival]; \
+}
+
+static void get_volume_values(Volume_Data *volume, long offset, 
+                              int nvalues, double values[])
+{
+   int ival;
+
+   switch (volume->datatype) {
+   case NC_BYTE:
+      if (volume->is_signed)
+         GET_VALUES(signed char)
+      else
+         GET_VALUES(unsigned char)
+      break;
+   case NC_SHORT:
+      if (volume->is_signed)
+         GET_VALUES(signed short)
+      else
+         GET_VALUES(unsigned short)
+      break;
+   case NC_INT:
+      if (volume->is_signed)
+         GET_VALUES(signed int)
+      else
+         GET_VALUES(unsigned int)
+      break;
+   case NC_FLOAT:
+      GET_VALUES(float)
+      break;
+   case NC_DOUBLE:
+      GET_VALUES(double)
+      break;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_cubic_weights
+@INPUT      : u - fractional position between the second and third samples
+@OUTPUT     : weights - weights of the four samples
+@RETURNS    : (nothing)
+@DESCRIPTION: Gets the weights of the cubic interpolant (code from Dave 
+              MacDonald) written as a linear combination of the samples.
+              Gives v1 and v2 at u = 0 and 1 and gives continuity of 
+              intensity and first derivative.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_cubic_weights(double u, double weights[])
+{
+   weights[0] = u * (-0.5 + u * (1.0 - 0.5 * u));
+   weights[1] = 1.0 + u * u * (-2.5 + 1.5 * u);
+   weights[2] = u * (0.5 + u * (2.0 - 1.5 * u));
+   weights[3] = u * u * (-0.5 + 0.5 * u);
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : do_Ncubic_interpolation
 @INPUT      : volume - pointer to volume data
               index - indices to start point in volume
                  (bottom of 4x4x4 cube for interpolation)
-              cur_dim - dimension to be interpolated (0 = volume, 1 = slice,
-                 2 = line)
+              cur_dim - first dimension to be interpolated (0 = volume, 
+                 1 = slice, 2 = line)
 @OUTPUT     : result - interpolated value.
 @RETURNS    : TRUE if coord is within the volume, FALSE otherwise.
 @DESCRIPTION: Routine to interpolate a volume, slice or line (specified by
               cur_dim).
-@METHOD     : 
+@METHOD     : The cubic weights are computed once for each dimension and
+              applied separably: first along each row of 4 voxels, then 
+              across rows, then across slices (where the slice scaling is
+              applied).
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 12, 1993 (Peter Neelin)
 @MODIFIED   : 
 ---------------------------------------------------------------------------- */
-int do_Ncubic_interpolation(Volume_Data *volume, 
-                            long index[], int cur_dim, 
-                            double frac[], double *result)
+static int do_Ncubic_interpolation(Volume_Data *volume, 
+                                   long index[], int cur_dim, 
+                                   double frac[], double *result)
 {
-   long base_index;
-   double v0, v1, v2, v3, u;
-   int found_fillvalue;
-
-   /* Save index that we will change */
-   base_index = index[cur_dim];
-
-   /* If last dimension, then just get the values */
-   found_fillvalue = FALSE;
-   if (cur_dim == VOL_NDIMS-1) {
-      VOLUME_VALUE(volume, index[0] ,index[1], index[2], v0);
-      index[cur_dim]++;
-      VOLUME_VALUE(volume, index[0] ,index[1], index[2], v1);
-      index[cur_dim]++;
-      VOLUME_VALUE(volume, index[0] ,index[1], index[2], v2);
-      index[cur_dim]++;
-      VOLUME_VALUE(volume, index[0] ,index[1], index[2], v3);
-
-      /* Check for fillvalues */
-      if ((v0 < volume->vrange[0]) || (v0 > volume->vrange[1]) ||
-          (v1 < volume->vrange[0]) || (v1 > volume->vrange[1]) ||
-          (v2 < volume->vrange[0]) || (v2 > volume->vrange[1]) ||
-          (v3 < volume->vrange[0]) || (v3 > volume->vrange[1])) {
-         found_fillvalue = TRUE;
-      }
-
-   }
-
-   /* Otherwise, recurse */
-   else {
-      if (!do_Ncubic_interpolation(volume, index, cur_dim+1, frac, &v0)) {
-         found_fillvalue = TRUE;
-      }
-      index[cur_dim]++;
-      if (!do_Ncubic_interpolation(volume, index, cur_dim+1, frac, &v1)) {
-         found_fillvalue = TRUE;
-      }
-      index[cur_dim]++;
-      if (!do_Ncubic_interpolation(volume, index, cur_dim+1, frac, &v2)) {
-         found_fillvalue = TRUE;
+   double weights[VOL_NDIMS][4];
+   double values[4];
+   double row_sum, slice_sum, total;
+   int nvalues[VOL_NDIMS];
+   long slcind, offset;
+   int idim, islc, irow, ival;
+
+   /* Get the weights, using a single sample along dimensions that are
+      not interpolated */
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      if (idim < cur_dim) {
+         nvalues[idim] = 1;
+         weights[idim][0] = 1.0;
       }
-      index[cur_dim]++;
-      if (!do_Ncubic_interpolation(volume, index, cur_dim+1, frac, &v3)) {
-         found_fillvalue = TRUE;
+      else {
+         nvalues[idim] = 4;
+         get_cubic_weights(frac[idim], weights[idim]);
       }
    }
 
-   /* Restore index */
-   index[cur_dim] = base_index;
+   total = 0.0;
+   for (islc=0; islc < nvalues[0]; islc++) {
+      slcind = index[0] + islc;
+      slice_sum = 0.0;
+      for (irow=0; irow < nvalues[1]; irow++) {
+         offset = (slcind * volume->size[ROW_AXIS] + index[1] + irow) * 
+            volume->size[COL_AXIS] + index[2];
+         get_volume_values(volume, offset, nvalues[2], values);
+
+         /* Check for fillvalues and interpolate along the row */
+         row_sum = 0.0;
+         for (ival=0; ival < nvalues[2]; ival++) {
+            if ((values[ival] < volume->vrange[0]) || 
+                (values[ival] > volume->vrange[1])) {
+               *result = volume->fillvalue;
+               return FALSE;
+            }
+            row_sum += weights[2][ival] * values[ival];
+         }
+         slice_sum += weights[1][irow] * row_sum;
+      }
 
-   /* Check for fill value found */
-   if (found_fillvalue) {
-      *result = volume->fillvalue;
-      return FALSE;
-   }
+      /* Scale values for slices */
+      if (cur_dim == 0) {
+         slice_sum = slice_sum * volume->scale[slcind] + 
+            volume->offset[slcind];
+      }
 
-   /* Scale values for slices */
-   if (cur_dim==0) {
-      v0 = v0 * volume->scale[base_index  ] + volume->offset[base_index  ];
-      v1 = v1 * volume->scale[base_index+1] + volume->offset[base_index+1];
-      v2 = v2 * volume->scale[base_index+2] + volume->offset[base_index+2];
-      v3 = v3 * volume->scale[base_index+3] + volume->offset[base_index+3];
+      total += weights[0][islc] * slice_sum;
    }
 
-   /* Get fraction */
-   u = frac[cur_dim];
-
-   /* Do tricubic interpolation (code from Dave MacDonald).
-      Gives v1 and v2 at u = 0 and 1 and gives continuity of intensity
-      and first derivative. */
-   *result =
-     ( (v1) + (u) * (
-       0.5 * ((v2)-(v0)) + (u) * (
-       (v0) - 2.5 * (v1) + 2.0 * (v2) - 0.5 * (v3) + (u) * (
-       -0.5 * (v0) + 1.5 * (v1) - 1.5 * (v2) + 0.5 * (v3)  )
-                                 )
-                    )
-     );
-
+   *result = total;
    return TRUE;
 }
 
@@ -934,224 +1528,177 @@ int sinc_half_width = SINC_HALF_WIDTH_MAX / 2;
 
 enum sinc_interpolant_window_t sinc_window_type = SINC_WINDOW_HANNING;
 
-/* basic windowed sinc function */
+/* cos(i*b) and sin(i*b) for i = -sinc_half_width..sinc_half_width and
+   b = PI / (1 + sinc_half_width), set by init_windowed_sinc */
+static double sinc_window_cos[SINC_HALF_WIDTH_MAX * 2 + 1];
+static double sinc_window_sin[SINC_HALF_WIDTH_MAX * 2 + 1];
 
-static double 
-windowed_sinc(double delta)
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : init_windowed_sinc
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Sets up the tables used by windowed_sinc_weights. Must be 
+              called after sinc_half_width is set and before any 
+              interpolation is done.
+@METHOD     : 
+@GLOBALS    : sinc_half_width
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void init_windowed_sinc(void)
 {
-    double phase;
-    double sinc;
-    double window;
-
-    /* Calculate the sinc function. 
-     */
-    phase = delta * M_PI;
+    int i;
+    double angle;
 
-    if (phase == 0.0) {
-        sinc = 1.0;
-    }
-    else {
-        sinc = sin(phase) / phase;
+    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
+        angle = i * M_PI / (1.0 + sinc_half_width);
+        sinc_window_cos[i + sinc_half_width] = cos(angle);
+        sinc_window_sin[i + sinc_half_width] = sin(angle);
     }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : windowed_sinc_weights
+@INPUT      : frac - fractional part of the coordinate (0 <= frac < 1)
+@OUTPUT     : weights - windowed sinc function at frac - i for 
+                 i = -sinc_half_width..sinc_half_width
+@RETURNS    : sum of the weights
+@DESCRIPTION: Gets the weights of the windowed sinc kernel along one axis.
+@METHOD     : Since sin(PI * (frac - i)) = (-1)^i * sin(PI * frac), and 
+              the window phase (frac - i) * PI / (1 + width) can be split 
+              with the angle-sum formula, only two sines and one cosine
+              are needed for the whole kernel.
+@GLOBALS    : sinc_half_width, sinc_window_type
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static double windowed_sinc_weights(double frac, double weights[])
+{
+    double sin_phase, cos_angle, sin_angle;
+    double phase, sinc, window, cos_window;
+    double total;
+    int i;
 
-    switch (sinc_window_type) {
-    case SINC_WINDOW_HANNING:
-        /* Calculate the Hanning window.
+    sin_phase = sin(frac * M_PI);
+    cos_angle = cos(frac * M_PI / (1.0 + sinc_half_width));
+    sin_angle = sin(frac * M_PI / (1.0 + sinc_half_width));
+
+    total = 0.0;
+    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
+
+        /* Calculate the sinc function. 
          */
-        window = 0.50 + 0.50 * cos(phase / (1.0 + sinc_half_width));
-        break;
+        phase = (frac - i) * M_PI;
+        if (phase == 0.0) {
+            sinc = 1.0;
+        }
+        else if (i % 2 != 0) {
+            sinc = -sin_phase / phase;
+        }
+        else {
+            sinc = sin_phase / phase;
+        }
 
-    case SINC_WINDOW_HAMMING:
-        /* Calculate the Hamming window.
+        /* cos(phase / (1.0 + sinc_half_width))
          */
-        window = 0.54 + 0.46 * cos(phase / (1.0 + sinc_half_width));
-        break;
+        cos_window = cos_angle * sinc_window_cos[i + sinc_half_width] +
+            sin_angle * sinc_window_sin[i + sinc_half_width];
+
+        switch (sinc_window_type) {
+        case SINC_WINDOW_HANNING:
+            /* Calculate the Hanning window.
+             */
+            window = 0.50 + 0.50 * cos_window;
+            break;
+
+        case SINC_WINDOW_HAMMING:
+            /* Calculate the Hamming window.
+             */
+            window = 0.54 + 0.46 * cos_window;
+            break;
+
+        default:
+            window = 1.0;           /* No window */
+            break;
+        }
 
-    default:
-        window = 1.0;           /* No window */
-        break;
+        weights[i + sinc_half_width] = sinc * window;
+        total += sinc * window;
     }
-    return (sinc * window);
+    return (total);
 }
 
-/* Floating-point (unscaled) multiply/accumulate operations */
-#define SINC_FRND result += *pix_ptr++ * *win_ptr++
-
-/* Unroll those loops!! */     
-#define SINC_FMAC \
-    result = 0.0; \
-    switch (sinc_half_width) { \
-    case 10: SINC_FRND; SINC_FRND; \
-    case 9:  SINC_FRND; SINC_FRND; \
-    case 8:  SINC_FRND; SINC_FRND; \
-    case 7:  SINC_FRND; SINC_FRND; \
-    case 6:  SINC_FRND; SINC_FRND; \
-    case 5:  SINC_FRND; SINC_FRND; \
-    case 4:  SINC_FRND; SINC_FRND; \
-    case 3:  SINC_FRND; SINC_FRND; \
-    case 2:  SINC_FRND; SINC_FRND; \
-    case 1:  SINC_FRND; SINC_FRND; \
-    SINC_FRND; /* Do the leftover */ \
-    }
-
-/* Integer (scaled) multiply/accumulate operations */
-#define SINC_IRND result += ((slope * *pix_ptr++) + intercept) * *win_ptr++
-
-/* Unroll the loops!! */
-#define SINC_IMAC \
-    result = 0.0; \
-    switch (sinc_half_width) { \
-    case 10: SINC_IRND; SINC_IRND; \
-    case 9:  SINC_IRND; SINC_IRND; \
-    case 8:  SINC_IRND; SINC_IRND; \
-    case 7:  SINC_IRND; SINC_IRND; \
-    case 6:  SINC_IRND; SINC_IRND; \
-    case 5:  SINC_IRND; SINC_IRND; \
-    case 4:  SINC_IRND; SINC_IRND; \
-    case 3:  SINC_IRND; SINC_IRND; \
-    case 2:  SINC_IRND; SINC_IRND; \
-    case 1:  SINC_IRND; SINC_IRND; \
-    SINC_IRND; /* Do the leftover */ \
-    }
+/* Unscaled multiply/accumulate along a row of the volume. Four independent
+   sums keep the additions out of a single dependency chain so that the 
+   compiler can use vector lanes without reassociating a reduction. */
+typedef double (*Sinc_Mac_Function)(Volume_Data *volume, long offset,
+                                    const double *win_ptr, int width);
+
+#define SINC_MAC(type) \
+    const type *pix_ptr = (const type *) volume->data + offset; \
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0; \
+    int k; \
+ \
+    for (k = 0; k + 3 < width; k += 4) { \
+        acc0 += pix_ptr[k] * win_ptr[k]; \
+        acc1 += pix_ptr[k + 1] * win_ptr[k + 1]; \
+        acc2 += pix_ptr[k + 2] * win_ptr[k + 2]; \
+        acc3 += pix_ptr[k + 3] * win_ptr[k + 3]; \
+    } \
+    for (; k < width; k++) { \
+        acc0 += pix_ptr[k] * win_ptr[k]; \
+    } \
+    return ((acc0 + acc1) + (acc2 + acc3));
 
 static double 
-sinc_mac_d(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_d(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    long offset;
-    double *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (double *) volume->data + offset;
-
-    SINC_FMAC;
-
-    return (result);
+    SINC_MAC(double)
 }
 
 static double 
-sinc_mac_f(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_f(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    long offset;
-    float *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (float *) volume->data + offset;
-
-    SINC_FMAC;
-
-    return (result);
+    SINC_MAC(float)
 }
 
 static double 
-sinc_mac_uc(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_uc(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    unsigned char *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (unsigned char *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(unsigned char)
 }
 
 static double 
-sinc_mac_sc(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_sc(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    char *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (char *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(signed char)
 }
 
 static double 
-sinc_mac_us(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_us(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    unsigned short *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (unsigned short *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(unsigned short)
 }
 
 static double 
-sinc_mac_ss(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_ss(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    short *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (short *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(short)
 }
 
 static double 
-sinc_mac_ui(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_ui(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    unsigned int *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (unsigned int *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(unsigned int)
 }
 
 static double 
-sinc_mac_si(Volume_Data *volume, int z, int y, int x, double *win_ptr)
+sinc_mac_si(Volume_Data *volume, long offset, const double *win_ptr, int width)
 {
-    double result;
-    double slope = volume->scale[z];
-    double intercept = volume->offset[z];
-    long offset;
-    int *pix_ptr;
-
-    offset = (z * volume->size[ROW_AXIS] + y) * volume->size[COL_AXIS] + x;
-
-    pix_ptr = (int *) volume->data + offset;
-
-    SINC_IMAC;
-
-    return (result);
+    SINC_MAC(int)
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -1163,7 +1710,11 @@ sinc_mac_si(Volume_Data *volume, int z, int y, int x, double *win_ptr)
 @RETURNS    : TRUE if coord is within the volume, FALSE otherwise.
 @DESCRIPTION: Routine to interpolate a volume at a point with windowed
               sinc interpolation.
-@METHOD     : 
+@METHOD     : The kernel is separable: each row of the window is reduced
+              with the x weights on the raw voxel values, rows are combined
+              with the y weights and the slice scaling (for integer data)
+              is applied once per slice before combining slices with the
+              z weights.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : July 11 2005 (Robert Vincent)
@@ -1177,12 +1728,15 @@ windowed_sinc_interpolant(Volume_Data *volume, Coord_Vector coord,
     double zf, yf, xf;
     int zi, yi, xi;
     int i, j;
+    int width, is_scaled;
+    long offset;
     double new;
-    double tmp;
+    double plane;
     long slcmax, rowmax, colmax;
     double zw[SINC_HALF_WIDTH_MAX * 2 + 1];
     double yw[SINC_HALF_WIDTH_MAX * 2 + 1];
     double xw[SINC_HALF_WIDTH_MAX * 2 + 1];
+    Sinc_Mac_Function sinc_mac;
 
     slcmax = volume->size[SLC_AXIS] - 1;
     rowmax = volume->size[ROW_AXIS] - 1;
@@ -1206,109 +1760,62 @@ windowed_sinc_interpolant(Volume_Data *volume, Coord_Vector coord,
         return trilinear_interpolant(volume, coord, result);
     }
 
+    /* Pick the multiply/accumulate function for the data type.
+     */
+    switch (volume->datatype) {
+    case NC_BYTE:
+        sinc_mac = (volume->is_signed) ? sinc_mac_sc : sinc_mac_uc;
+        break;
+    case NC_SHORT:
+        sinc_mac = (volume->is_signed) ? sinc_mac_ss : sinc_mac_us;
+        break;
+    case NC_INT:
+        sinc_mac = (volume->is_signed) ? sinc_mac_si : sinc_mac_ui;
+        break;
+    case NC_FLOAT:
+        sinc_mac = sinc_mac_f;
+        break;
+    case NC_DOUBLE:
+        sinc_mac = sinc_mac_d;
+        break;
+    default:
+        fprintf(stderr, "UNHANDLED TYPE!!!\n");
+        *result = volume->fillvalue;
+        return FALSE;
+    }
+
     /* Calculate fractional part of the coordinate.
      */
     zf = coord[SLICE] - zi;
     yf = coord[ROW] - yi;
     xf = coord[COLUMN] - xi;
-    
-    /* Initialize the totals.
-     */
-    zt = 0.0;
-    yt = 0.0;
-    xt = 0.0;
 
-    /* Generate the three windowed sinc functions.
+    /* Generate the three windowed sinc functions and their totals.
      */
-    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
-        tmp = windowed_sinc(zf - i);
-        zw[i + sinc_half_width] = tmp;
-        zt += tmp;
-        
-        tmp = windowed_sinc(yf - i);
-        yw[i + sinc_half_width] = tmp;
-        yt += tmp;
-        
-        tmp = windowed_sinc(xf - i);
-        xw[i + sinc_half_width] = tmp;
-        xt += tmp;
-    }
+    zt = windowed_sinc_weights(zf, zw);
+    yt = windowed_sinc_weights(yf, yw);
+    xt = windowed_sinc_weights(xf, xw);
 
-    /* Now calculate the new value.
+    /* Now calculate the new value. Integer data is scaled once per slice.
      */
+    is_scaled = (volume->datatype != NC_FLOAT && 
+                 volume->datatype != NC_DOUBLE);
+    width = sinc_half_width * 2 + 1;
     new = 0.0;
-    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
-        for (j = -sinc_half_width; j <= sinc_half_width; j++) {
-            switch (volume->datatype) {
-            case NC_BYTE:
-                if (volume->is_signed) {
-                    tmp = sinc_mac_sc(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                else {
-                    tmp = sinc_mac_uc(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                break;
-            case NC_SHORT:
-                if (volume->is_signed) {
-                    tmp = sinc_mac_ss(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                else {
-                    tmp = sinc_mac_us(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                break;
-            case NC_INT:
-                if (volume->is_signed) {
-                    tmp = sinc_mac_si(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                else {
-                    tmp = sinc_mac_ui(volume, 
-                                      zi + i, 
-                                      yi + j, 
-                                      xi - sinc_half_width, 
-                                      xw);
-                }
-                break;
-            case NC_FLOAT:
-                tmp = sinc_mac_f(volume, 
-                                 zi + i, 
-                                 yi + j, 
-                                 xi - sinc_half_width,
-                                 xw);
-                break;
-            case NC_DOUBLE:
-                tmp = sinc_mac_d(volume,
-                                 zi + i,
-                                 yi + j,
-                                 xi - sinc_half_width,
-                                 xw);
-                break;
-
-            default:
-                fprintf(stderr, "UNHANDLED TYPE!!!\n");
-                break;
-            }
-            new += zw[i + sinc_half_width] * yw[j + sinc_half_width] * tmp;
+    for (i = 0; i < width; i++) {
+        offset = ((long) (zi + i - sinc_half_width) * volume->size[ROW_AXIS] +
+                  (yi - sinc_half_width)) * volume->size[COL_AXIS] + 
+            (xi - sinc_half_width);
+        plane = 0.0;
+        for (j = 0; j < width; j++) {
+            plane += yw[j] * (*sinc_mac)(volume, offset, xw, width);
+            offset += volume->size[COL_AXIS];
         }
+        if (is_scaled) {
+            plane = volume->scale[zi + i - sinc_half_width] * plane + 
+                volume->offset[zi + i - sinc_half_width] * yt * xt;
+        }
+        new += zw[i] * plane;
     }
     *result = (new / (zt * yt * xt));
     return TRUE;
@@ -1516,3 +2023,262 @@ static void renormalize_slices(Program_Flags *program_flags, VVolume *out_vol,
    return;
 }
 
+#ifdef HAVE_PTHREAD
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_slice_pool
+@INPUT      : nthreads - number of worker threads
+              slice_size - number of voxels in an output slice
+@OUTPUT     : (none)
+@RETURNS    : pointer to new slice pool
+@DESCRIPTION: Allocates the reorder buffer used to compute output slices
+              concurrently. The workers themselves are started for each
+              input volume by start_slice_pool.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static Slice_Pool *create_slice_pool(int nthreads, long slice_size)
+{
+   Slice_Pool *pool;
+   int islot;
+
+   pool = malloc(sizeof(*pool));
+   pool->nthreads = nthreads;
+   pool->nbuffers = nthreads * SLICE_BUFFERS_PER_THREAD;
+   pool->threads = malloc(sizeof(pthread_t) * nthreads);
+   pool->workers = malloc(sizeof(Slice_Worker) * nthreads);
+   pool->data = malloc(sizeof(double *) * pool->nbuffers);
+   pool->minimum = malloc(sizeof(double) * pool->nbuffers);
+   pool->maximum = malloc(sizeof(double) * pool->nbuffers);
+   pool->ready = malloc(sizeof(int) * pool->nbuffers);
+   for (islot=0; islot < pool->nbuffers; islot++) {
+      pool->data[islot] = malloc(sizeof(double) * slice_size);
+      if (pool->data[islot] == NULL) {
+         (void) fprintf(stderr, "Unable to allocate slice buffers.\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   (void) pthread_mutex_init(&pool->lock, NULL);
+   (void) pthread_cond_init(&pool->slot_free, NULL);
+   (void) pthread_cond_init(&pool->slot_ready, NULL);
+
+   return pool;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_slice_pool
+@INPUT      : pool - slice pool
+              nslice - number of slices in the output volume
+              in_vol - description of input volume (already loaded)
+              out_vol - description of output volume
+              plan - output voxel to input voxel mapping
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Starts the worker threads that resample the current input 
+              volume. Workers claim slices in increasing order, so the 
+              writer never waits on a slice that nobody is computing.
+              Each worker's copy of the plan is made here, before any
+              thread is started, since copying a transformation is not
+              safe while other threads evaluate it.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_slice_pool(Slice_Pool *pool, long nslice,
+                             VVolume *in_vol, VVolume *out_vol,
+                             Transform_Plan *plan)
+{
+   int ithread, islot;
+
+   pool->in_vol = in_vol;
+   pool->out_vol = out_vol;
+   pool->nslice = nslice;
+   pool->next_slice = 0;
+   pool->next_write = 0;
+   for (islot=0; islot < pool->nbuffers; islot++) {
+      pool->ready[islot] = FALSE;
+   }
+
+   for (ithread=0; ithread < pool->nthreads; ithread++) {
+      pool->workers[ithread].pool = pool;
+      copy_transform_plan(plan, &pool->workers[ithread].plan);
+   }
+
+   for (ithread=0; ithread < pool->nthreads; ithread++) {
+      if (pthread_create(&pool->threads[ithread], NULL, 
+                         slice_worker, &pool->workers[ithread]) != 0) {
+         (void) fprintf(stderr, "Unable to create worker thread.\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slice_worker
+@INPUT      : arg - pointer to the worker's Slice_Worker
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Thread body: repeatedly claims the next unclaimed slice, 
+              waits for its slot in the reorder buffer to be free and
+              computes it with get_slice, using the worker's private copy
+              of the transform plan.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *slice_worker(void *arg)
+{
+   Slice_Worker *worker;
+   Slice_Pool *pool;
+   long islice;
+   int slot;
+   double minimum, maximum;
+
+   worker = (Slice_Worker *) arg;
+   pool = worker->pool;
+
+   (void) pthread_mutex_lock(&pool->lock);
+   while (pool->next_slice < pool->nslice) {
+
+      /* Claim a slice, waiting until the writer has freed its slot */
+      islice = pool->next_slice++;
+      slot = islice % pool->nbuffers;
+      while (islice >= pool->next_write + pool->nbuffers) {
+         (void) pthread_cond_wait(&pool->slot_free, &pool->lock);
+      }
+      (void) pthread_mutex_unlock(&pool->lock);
+
+      get_slice(islice, pool->in_vol, pool->out_vol, &worker->plan,
+                pool->data[slot], &minimum, &maximum);
+
+      /* Publish the slice */
+      (void) pthread_mutex_lock(&pool->lock);
+      pool->minimum[slot] = minimum;
+      pool->maximum[slot] = maximum;
+      pool->ready[slot] = TRUE;
+      (void) pthread_cond_broadcast(&pool->slot_ready);
+   }
+   (void) pthread_mutex_unlock(&pool->lock);
+
+   return NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : wait_for_slice
+@INPUT      : pool - slice pool
+              islice - slice to get (must be the next one to be written)
+@OUTPUT     : minimum - slice minimum
+              maximum - slice maximum
+@RETURNS    : pointer to slice data
+@DESCRIPTION: Waits until a worker has finished computing slice islice.
+              The data remains valid until release_slice is called.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static double *wait_for_slice(Slice_Pool *pool, long islice,
+                              double *minimum, double *maximum)
+{
+   int slot;
+
+   slot = islice % pool->nbuffers;
+
+   (void) pthread_mutex_lock(&pool->lock);
+   while (!pool->ready[slot]) {
+      (void) pthread_cond_wait(&pool->slot_ready, &pool->lock);
+   }
+   *minimum = pool->minimum[slot];
+   *maximum = pool->maximum[slot];
+   (void) pthread_mutex_unlock(&pool->lock);
+
+   return pool->data[slot];
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : release_slice
+@INPUT      : pool - slice pool
+              islice - slice that has been written
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Returns the slot of a written slice to the workers.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void release_slice(Slice_Pool *pool, long islice)
+{
+   (void) pthread_mutex_lock(&pool->lock);
+   pool->ready[islice % pool->nbuffers] = FALSE;
+   pool->next_write = islice + 1;
+   (void) pthread_cond_broadcast(&pool->slot_free);
+   (void) pthread_mutex_unlock(&pool->lock);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stop_slice_pool
+@INPUT      : pool - slice pool
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Waits for the worker threads to finish the current volume
+              and frees their copies of the transform plan.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void stop_slice_pool(Slice_Pool *pool)
+{
+   int ithread;
+
+   for (ithread=0; ithread < pool->nthreads; ithread++) {
+      (void) pthread_join(pool->threads[ithread], NULL);
+      delete_transform_plan(&pool->workers[ithread].plan);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_slice_pool
+@INPUT      : pool - slice pool
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Frees the reorder buffer.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void delete_slice_pool(Slice_Pool *pool)
+{
+   int islot;
+
+   (void) pthread_mutex_destroy(&pool->lock);
+   (void) pthread_cond_destroy(&pool->slot_free);
+   (void) pthread_cond_destroy(&pool->slot_ready);
+
+   for (islot=0; islot < pool->nbuffers; islot++) {
+      free(pool->data[islot]);
+   }
+   free(pool->data);
+   free(pool->minimum);
+   free(pool->maximum);
+   free(pool->ready);
+   free(pool->threads);
+   free(pool->workers);
+   free(pool);
+}
+
+#endif /* HAVE_PTHREAD */
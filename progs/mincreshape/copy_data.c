@@ -91,6 +91,7 @@
 #include <float.h>
 #include <limits.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 #include <minc.h>
 #include <nd_loop.h>
@@ -98,18 +99,45 @@
 
 #define VIO_ROUND( x ) ((long) ((x) + ( ((x) >= 0) ? 0.5 : (-0.5) ) ))
 
-static void get_num_minmax_values(Reshape_info *reshape_info,
-                                  long *block_start, long *block_count,
-                                  long *num_min_values, long *num_max_values);
+/* Size of the square tiles (in values) used when transposing chunks */
+#define TRANSPOSE_TILE 32
+
+/* An image-min or image-max variable of the input file */
+typedef struct {
+   int exists;
+   int ndims;
+   int img_dim[MAX_VAR_DIMS];     /* Input image dimension for each dim 
+                                     (-1 if none) */
+   long size[MAX_VAR_DIMS];
+   double *values;
+} Minmax_var;
+
+/* Image-min and image-max values for the whole input file and for every 
+   output block, so that they are read and written only once */
+typedef struct {
+   Minmax_var input[2];           /* image-min and image-max */
+   int outvarid[2];
+   int output_ndims;
+   long output_count[MAX_VAR_DIMS];
+   long nblocks, iblock;
+   double *output[2];
+   int icv_is_set;                /* TRUE if icv is set up for ... */
+   double icv_minimum, icv_maximum;  /* ... this min and max */
+} Minmax_cache;
+
+static void read_minmax_cache(Reshape_info *reshape_info,
+                              Minmax_cache *minmax_cache);
+static void write_minmax_cache(Reshape_info *reshape_info,
+                               Minmax_cache *minmax_cache);
 static void handle_normalization(Reshape_info *reshape_info,
                                  long *block_start,
                                  long *block_count,
-                                 double *minmax_buffer,
+                                 Minmax_cache *minmax_cache,
                                  double *fillvalue);
 static void get_block_min_and_max(Reshape_info *reshape_info,
                                   long *block_start,
                                   long *block_count,
-                                  double *minmax_buffer,
+                                  Minmax_cache *minmax_cache,
                                   double *minimum,
                                   double *maximum);
 static void truncate_input_vectors(Reshape_info *reshape_info,
@@ -128,8 +156,15 @@ static void translate_input_to_output(Reshape_info *reshape_info,
 static void copy_the_chunk(Reshape_info *reshape_info,
                            long chunk_start[],
                            long chunk_count[],
+                           void *input_data,
                            void *chunk_data,
                            double fillvalue);
+static void transpose_chunk(int ndims, long count[],
+                            long src_stride[], long dst_stride[],
+                            int datatype_size, void *src, void *dst);
+static void transpose_plane(int datatype_size, char *src, char *dst,
+                            long count_a, long src_stride_a, long dst_stride_a,
+                            long count_b, long src_stride_b, long dst_stride_b);
 static void convert_value_from_double(double dvalue,
                                       nc_type datatype, int is_signed,
                                       void *ptr);
@@ -159,9 +194,9 @@ void copy_data(Reshape_info *reshape_info)
    long chunk_count[MAX_VAR_DIMS];
    long chunk_cur_start[MAX_VAR_DIMS], chunk_cur_count[MAX_VAR_DIMS];
    long total_size;
-   long num_min_values, num_max_values, num_values;
-   double fillvalue, *minmax_buffer;
-   void *chunk_data;
+   double fillvalue;
+   Minmax_cache minmax_cache;
+   void *input_data, *chunk_data;
 
    /* Get number of dimensions */
    out_ndims = reshape_info->output_ndims;
@@ -182,17 +217,11 @@ void copy_data(Reshape_info *reshape_info)
    for (odim=0; odim < out_ndims; odim++) {
       total_size *= reshape_info->chunk_count[odim];
    }
+   input_data = malloc(total_size);
    chunk_data = malloc(total_size);
 
-   /* Get enough space for image-min and max values for a block */
-   get_num_minmax_values(reshape_info, NULL, block_count, 
-                         &num_min_values, &num_max_values);
-   num_values = ((num_min_values > num_max_values) ?
-                 num_min_values : num_max_values);
-   if (num_values > 0)
-      minmax_buffer = malloc(num_values * sizeof(double));
-   else
-      minmax_buffer = NULL;
+   /* Read in all of the image-min and max values */
+   read_minmax_cache(reshape_info, &minmax_cache);
 
    /* Print log message */
    if (reshape_info->verbose) {
@@ -219,7 +248,7 @@ void copy_data(Reshape_info *reshape_info)
       /* Set up icv for normalization, set output image-max/min and 
          calculate pixel fill value to use for current block */
       handle_normalization(reshape_info, block_cur_start, block_cur_count,
-                           minmax_buffer, &fillvalue);
+                           &minmax_cache, &fillvalue);
 
       /* Loop through chunks */
 
@@ -238,8 +267,8 @@ void copy_data(Reshape_info *reshape_info)
 
          /* Copy the chunk */
          copy_the_chunk(reshape_info, 
-                        chunk_cur_start, chunk_cur_count, chunk_data,
-                        fillvalue);
+                        chunk_cur_start, chunk_cur_count, 
+                        input_data, chunk_data, fillvalue);
 
          /* Increment chunk loop count */
          nd_increment_loop(chunk_cur_start, chunk_begin, chunk_count,
@@ -254,12 +283,11 @@ void copy_data(Reshape_info *reshape_info)
    }
 
    /* Free the chunk space */
+   free(input_data);
    free(chunk_data);
 
-   /* Free minmax buffer */
-   if (minmax_buffer != NULL) {
-      free(minmax_buffer);
-   }
+   /* Write out the image-min and max values and free them */
+   write_minmax_cache(reshape_info, &minmax_cache);
 
    /* Print ending log message */
    if (reshape_info->verbose) {
@@ -271,88 +299,131 @@ void copy_data(Reshape_info *reshape_info)
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : get_num_minmax_values
+@NAME       : read_minmax_cache
 @INPUT      : reshape_info - information for reshaping volume
-              block_start - start for a block (or NULL)
-              block_count - count for a block
-@OUTPUT     : num_min_values - number of image-min values to be read
-              num_max_values - number of image-max values to be read
+@OUTPUT     : minmax_cache - image-min and max values for the input file
+                 and space for those of the output file
 @RETURNS    : (nothing)
-@DESCRIPTION: Gets the number of image-min and image-max values that
-              correspond to a block. If block_start is NULL, then
-              it is assumed to translate to an input start of [0,0,...]. 
-              Note that only the true number of values for the specified 
-              block is computed (specifying a hyperslab that goes beyond 
-              file extents does not give a bigger number of values).
+@DESCRIPTION: Reads all of the input image-min and image-max values 
+              (unless the icv is doing the normalization) and gets space
+              for one output min and max per block.
 @METHOD     :
 @GLOBALS    :
 @CALLS      :
-@CREATED    : October 25, 1994 (Peter Neelin)
+@CREATED    : October 17, 2026
 @MODIFIED   :
 ---------------------------------------------------------------------------- */
-static void get_num_minmax_values(Reshape_info *reshape_info,
-                                  long *block_start, long *block_count,
-                                  long *num_min_values, long *num_max_values)
+static void read_minmax_cache(Reshape_info *reshape_info,
+                              Minmax_cache *minmax_cache)
 {
-   int iloop, idim, ndims;
-   int varid, inimgid;
-   long size;
-   long minmax_count[MAX_VAR_DIMS];
-   long input_block_start[MAX_VAR_DIMS];
-   long input_block_count[MAX_VAR_DIMS];
-   long *num_values;
-
-   /* Check for icv normalization */
-   if (reshape_info->do_icv_normalization) {
-      *num_min_values = 0;
-      *num_max_values = 0;
-      return;
-   }
+   int iloop, idim, jdim, odim, varid, inimgid, img_ndims;
+   int img_dim[MAX_VAR_DIMS], var_dim[MAX_VAR_DIMS];
+   long start[MAX_VAR_DIMS], num_values;
+   Minmax_var *var;
 
-   /* Translate output block count to input count */
-   translate_output_to_input(reshape_info, block_start, block_count, 
-                             input_block_start, input_block_count);
-   if (block_start != NULL) {
-      truncate_input_vectors(reshape_info, input_block_start, 
-                             input_block_count);
-   }
    inimgid = ncvarid(reshape_info->inmincid, MIimage);
-
-   /* Loop over image-min and image-max */
+   (void) ncvarinq(reshape_info->inmincid, inimgid, NULL, NULL, 
+                   &img_ndims, img_dim, NULL);
 
    for (iloop=0; iloop < 2; iloop++) {
+      var = &minmax_cache->input[iloop];
+      var->exists = FALSE;
+      var->values = NULL;
+
+      /* Check for icv normalization */
+      if (reshape_info->do_icv_normalization) continue;
 
-      /* Get varid and pointer to return value */
       ncopts = 0;
-      switch (iloop) {
-      case 0: 
-         varid = ncvarid(reshape_info->inmincid, MIimagemin); 
-         num_values = num_min_values;        /* Pointer to long */
-         break;
-      case 1: 
-         varid = ncvarid(reshape_info->inmincid, MIimagemax);
-         num_values = num_max_values;        /* Pointer to long */
-         break;
-      }
+      varid = ncvarid(reshape_info->inmincid,
+                      ((iloop == 0) ? MIimagemin : MIimagemax));
       ncopts = NCOPTS_DEFAULT;
-
-      /* Translate block count to min or max count and work out the
-         total number of values. */
-      size = 0;
-      if (varid != MI_ERROR) {
-         (void) ncvarinq(reshape_info->inmincid, varid, NULL, NULL, 
-                         &ndims, NULL, NULL);
-         (void) mitranslate_coords(reshape_info->inmincid,
-                                   inimgid, input_block_count,
-                                   varid, minmax_count);
-         size = 1;
-         for (idim=0; idim < ndims; idim++) {
-            size *= minmax_count[idim];
+      if (varid == MI_ERROR) continue;
+
+      /* Match the variable dimensions to image dimensions */
+      (void) ncvarinq(reshape_info->inmincid, varid, NULL, NULL, 
+                      &var->ndims, var_dim, NULL);
+      num_values = 1;
+      for (idim=0; idim < var->ndims; idim++) {
+         (void) ncdiminq(reshape_info->inmincid, var_dim[idim], NULL, 
+                         &var->size[idim]);
+         var->img_dim[idim] = -1;
+         for (jdim=0; jdim < img_ndims; jdim++) {
+            if (img_dim[jdim] == var_dim[idim])
+               var->img_dim[idim] = jdim;
          }
+         start[idim] = 0;
+         num_values *= var->size[idim];
+      }
+
+      /* Read in the values */
+      var->values = malloc((num_values + 1) * sizeof(double));
+      (void) mivarget(reshape_info->inmincid, varid, start, var->size,
+                      NC_DOUBLE, NULL, var->values);
+      var->exists = TRUE;
+   }
+
+   /* Get space for the output values - blocks are visited in the same
+      order as the values of the output variables */
+   minmax_cache->output_ndims = 0;
+   minmax_cache->nblocks = 1;
+   for (odim=0; odim < reshape_info->output_ndims; odim++) {
+      if (!reshape_info->dim_used_in_block[odim]) {
+         idim = reshape_info->map_out_to_in[odim];
+         minmax_cache->output_count[minmax_cache->output_ndims++] = 
+            ABS(reshape_info->input_count[idim]);
+         minmax_cache->nblocks *= ABS(reshape_info->input_count[idim]);
       }
-      *num_values = size;
+   }
+   minmax_cache->iblock = 0;
+   for (iloop=0; iloop < 2; iloop++) {
+      ncopts = 0;
+      minmax_cache->outvarid[iloop] = 
+         ncvarid(reshape_info->outmincid, 
+                 ((iloop == 0) ? MIimagemin : MIimagemax));
+      ncopts = NCOPTS_DEFAULT;
+      minmax_cache->output[iloop] = 
+         malloc((minmax_cache->nblocks + 1) * sizeof(double));
    }
 
+   minmax_cache->icv_is_set = FALSE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : write_minmax_cache
+@INPUT      : reshape_info - information for reshaping volume
+              minmax_cache - image-min and max values
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Writes out the image-min and image-max values of all of
+              the blocks and frees the cache.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void write_minmax_cache(Reshape_info *reshape_info,
+                               Minmax_cache *minmax_cache)
+{
+   int iloop, idim;
+   long start[MAX_VAR_DIMS];
+
+   for (idim=0; idim < minmax_cache->output_ndims; idim++) {
+      start[idim] = 0;
+   }
+
+   for (iloop=0; iloop < 2; iloop++) {
+      if ((minmax_cache->outvarid[iloop] != MI_ERROR) &&
+          (minmax_cache->iblock == minmax_cache->nblocks)) {
+         (void) mivarput(reshape_info->outmincid, 
+                         minmax_cache->outvarid[iloop], 
+                         start, minmax_cache->output_count, 
+                         NC_DOUBLE, NULL, minmax_cache->output[iloop]);
+      }
+      free(minmax_cache->output[iloop]);
+      if (minmax_cache->input[iloop].values != NULL)
+         free(minmax_cache->input[iloop].values);
+   }
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -360,8 +431,7 @@ static void get_num_minmax_values(Reshape_info *reshape_info,
 @INPUT      : reshape_info - information for reshaping volume
               block_start - start of current block
               block_count - count for current block
-              minmax_buffer - buffer space for getting min and max
-                 values
+              minmax_cache - image-min and max values
 @OUTPUT     : fillvalue - pixel fill value to use for this block
 @RETURNS    : (none)
 @DESCRIPTION: Sets up icv for normalization to ensure that block is
@@ -372,19 +442,16 @@ static void get_num_minmax_values(Reshape_info *reshape_info,
 @GLOBALS    :
 @CALLS      :
 @CREATED    : October 25, 1994 (Peter Neelin)
-@MODIFIED   :
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void handle_normalization(Reshape_info *reshape_info,
                                  long *block_start,
                                  long *block_count,
-                                 double *minmax_buffer,
+                                 Minmax_cache *minmax_cache,
                                  double *fillvalue)
 {
-   int iloop;
-   int inmincid, inimgid, varid, icvid;
-   long minmax_start[MAX_VAR_DIMS];
-   double minimum, maximum, *extreme, valid_min, valid_max, denom;
-   char *varname;
+   int inmincid, inimgid, icvid;
+   double minimum, maximum, valid_min, valid_max, denom;
 
    /* Get input minc id, image id and icv id*/
    inmincid = reshape_info->inmincid;
@@ -393,7 +460,7 @@ static void handle_normalization(Reshape_info *reshape_info,
 
    /* Get input min and max for block */
    get_block_min_and_max(reshape_info, block_start, block_count,
-                         minmax_buffer, &minimum, &maximum);
+                         minmax_cache, &minimum, &maximum);
 
    /* Calculate the pixel fill value */
    *fillvalue = ((reshape_info->fillvalue == NOFILL) ? 0.0 :
@@ -412,42 +479,29 @@ static void handle_normalization(Reshape_info *reshape_info,
      reshape_info->do_block_normalization = TRUE;
    }
 
-   /* Modify the icv if necessary */
-   if (reshape_info->do_block_normalization) {
+   /* Modify the icv if necessary (unless it is already set up for this
+      min and max) */
+   if (reshape_info->do_block_normalization &&
+       (!minmax_cache->icv_is_set || 
+        (minimum != minmax_cache->icv_minimum) ||
+        (maximum != minmax_cache->icv_maximum))) {
       (void) miicv_detach(icvid);
       (void) miicv_setdbl(icvid, MI_ICV_IMAGE_MIN, minimum);
       (void) miicv_setdbl(icvid, MI_ICV_IMAGE_MAX, maximum);
       (void) miicv_setint(icvid, MI_ICV_USER_NORM, TRUE);
       (void) miicv_setint(icvid, MI_ICV_DO_NORM, TRUE);
       (void) miicv_attach(icvid, inmincid, inimgid);
+      minmax_cache->icv_is_set = TRUE;
+      minmax_cache->icv_minimum = minimum;
+      minmax_cache->icv_maximum = maximum;
    }
 
-   /* Save the image max and min for the block */
-   for (iloop=0; iloop < 2; iloop++) {
-
-      /* Get varid and pointer to min or max value */
-      switch (iloop) {
-      case 0: 
-         varname = MIimagemin;
-         extreme = &minimum;
-         break;
-      case 1: 
-         varname = MIimagemax;
-         extreme = &maximum;
-         break;
-      }
-
-      /* Save the value */
-      ncopts = 0;
-      varid = ncvarid(reshape_info->outmincid, varname);
-      ncopts = NCOPTS_DEFAULT;
-      if (varid != MI_ERROR) {
-         (void) mitranslate_coords(reshape_info->outmincid, 
-                                   reshape_info->outimgid, block_start,
-                                   varid, minmax_start);
-         (void) mivarput1(reshape_info->outmincid, varid, 
-                          minmax_start, NC_DOUBLE, NULL, extreme);
-      }
+   /* Save the image max and min for the block (they are written out
+      at the end) */
+   if (minmax_cache->iblock < minmax_cache->nblocks) {
+      minmax_cache->output[0][minmax_cache->iblock] = minimum;
+      minmax_cache->output[1][minmax_cache->iblock] = maximum;
+      minmax_cache->iblock++;
    }
 
    if ((reshape_info->output_datatype != NC_FLOAT) &&
@@ -473,8 +527,7 @@ static void handle_normalization(Reshape_info *reshape_info,
 @INPUT      : reshape_info - information for reshaping volume
               block_start - start of current block
               block_count - count for current block
-              minmax_buffer - buffer space for getting min and max
-                 values
+              minmax_cache - image-min and max values
 @OUTPUT     : minimum - input minimum for block
               maximum - input maximum for block
 @RETURNS    : (none)
@@ -484,28 +537,26 @@ static void handle_normalization(Reshape_info *reshape_info,
 @GLOBALS    :
 @CALLS      :
 @CREATED    : October 25, 1994 (Peter Neelin)
-@MODIFIED   :
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void get_block_min_and_max(Reshape_info *reshape_info,
                                   long *block_start,
                                   long *block_count,
-                                  double *minmax_buffer,
+                                  Minmax_cache *minmax_cache,
                                   double *minimum,
                                   double *maximum)
 {
-   int iloop;
-   long num_min_values, num_max_values, ivalue;
-   int inmincid, inimgid, varid, icvid;
+   int iloop, idim, jdim, ndims;
+   int icvid;
    long minmax_start[MAX_VAR_DIMS], minmax_count[MAX_VAR_DIMS];
+   long minmax_index[MAX_VAR_DIMS];
    long input_block_start[MAX_VAR_DIMS], input_block_count[MAX_VAR_DIMS];
-   double *extreme;
-   long num_values;
-   char *varname;
+   double *extreme, value;
+   long num_values, ivalue, offset;
    double sign, default_extreme;
+   Minmax_var *var;
 
-   /* Get input minc id, image id and icv id*/
-   inmincid = reshape_info->inmincid;
-   inimgid = ncvarid(inmincid, MIimage);
+   /* Get icv id*/
    icvid = reshape_info->icvid;
 
    /* Is the icv doing the normalization? */
@@ -520,48 +571,57 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
                              input_block_start, input_block_count);
    truncate_input_vectors(reshape_info, input_block_start, input_block_count);
 
-   /* Get number of min and max values */
-   get_num_minmax_values(reshape_info, block_start, block_count, 
-                         &num_min_values, &num_max_values);
-
    /* Loop over image-min and image-max getting block min and max */
 
    for (iloop=0; iloop < 2; iloop++) {
 
-      /* Get varid and pointer to min or max value */
+      /* Get variable and pointer to min or max value */
+      var = &minmax_cache->input[iloop];
       switch (iloop) {
       case 0: 
-         num_values = num_min_values;
-         varname = MIimagemin;
          extreme = minimum;
          sign = -1.0;
          default_extreme = 0.0;
          break;
       case 1: 
-         num_values = num_max_values;
-         varname = MIimagemax;
          extreme = maximum;
          sign = +1.0;
          default_extreme = 1.0;
          break;
       }
 
-      /* Get values from file */
+      /* Get the part of the variable that covers the block */
+      num_values = 0;
+      ndims = 0;
+      if (var->exists) {
+         ndims = var->ndims;
+         num_values = 1;
+         for (idim=0; idim < ndims; idim++) {
+            jdim = var->img_dim[idim];
+            minmax_start[idim] = ((jdim >= 0) ? input_block_start[jdim] : 0);
+            minmax_count[idim] = ((jdim >= 0) ? input_block_count[jdim] : 1);
+            minmax_index[idim] = 0;
+            num_values *= minmax_count[idim];
+         }
+      }
+
+      /* Look through the values */
       if (num_values > 0) {
-         varid = ncvarid(inmincid, varname);
-         (void) mitranslate_coords(inmincid,
-                                   inimgid, input_block_start,
-                                   varid, minmax_start);
-         (void) mitranslate_coords(inmincid,
-                                   inimgid, input_block_count,
-                                   varid, minmax_count);
-         (void) mivarget(reshape_info->inmincid, varid, 
-                         minmax_start, minmax_count, 
-                         NC_DOUBLE, NULL, minmax_buffer);
-         *extreme = minmax_buffer[0];
-         for (ivalue=1; ivalue < num_values; ivalue++) {
-            if ((minmax_buffer[ivalue] * sign) > (*extreme * sign))
-               *extreme = minmax_buffer[ivalue];
+         for (ivalue=0; ivalue < num_values; ivalue++) {
+            offset = 0;
+            for (idim=0; idim < ndims; idim++) {
+               offset = offset * var->size[idim] + 
+                  minmax_start[idim] + minmax_index[idim];
+            }
+            value = var->values[offset];
+            if ((ivalue == 0) || ((value * sign) > (*extreme * sign)))
+               *extreme = value;
+
+            for (idim=ndims-1; idim >= 0; idim--) {
+               minmax_index[idim]++;
+               if (minmax_index[idim] < minmax_count[idim]) break;
+               minmax_index[idim] = 0;
+            }
          }
       }
       else {
@@ -716,28 +776,35 @@ static void translate_input_to_output(Reshape_info *reshape_info,
 @INPUT      : reshape_info - information for reshaping volume
               chunk_start - start of current block
               chunk_count - count for current block
+              input_data - pointer to enough space for chunk (input order)
               chunk_data - pointer to enough space for chunk
               fillvalue - pixel value to zero volume, if necessary.
 @OUTPUT     : (none)
 @RETURNS    : (nothing)
 @DESCRIPTION: Copies the chunk from the input file to the output file.
+              The input data is reordered and flipped in memory so that
+              the chunk can be written contiguously. A chunk that lies
+              partly outside of the input is filled in memory first, so
+              it is still written only once.
 @METHOD     :
 @GLOBALS    :
 @CALLS      :
 @CREATED    : October 25, 1994 (Peter Neelin)
-@MODIFIED   :
+@MODIFIED   : October 17, 2026
 ---------------------------------------------------------------------------- */
 static void copy_the_chunk(Reshape_info *reshape_info,
                            long chunk_start[],
                            long chunk_count[],
+                           void *input_data,
                            void *chunk_data,
                            double fillvalue)
 {
    int idim, odim, in_ndims, out_ndims;
    long input_start[MAX_VAR_DIMS], input_count[MAX_VAR_DIMS];
    long output_start[MAX_VAR_DIMS], output_count[MAX_VAR_DIMS];
-   long input_imap[MAX_VAR_DIMS], output_imap[MAX_VAR_DIMS];
-   void *output_origin;
+   long input_stride[MAX_VAR_DIMS], src_stride[MAX_VAR_DIMS];
+   long dst_stride[MAX_VAR_DIMS];
+   long src_offset, dst_offset;
    int datatype_size;
    long total_size, ipix, first, last;
    int zero_data, really_copy_the_data;
@@ -777,7 +844,7 @@ static void copy_the_chunk(Reshape_info *reshape_info,
    translate_input_to_output(reshape_info, input_start, input_count,
                              output_start, output_count);
 
-   /* Write out zero data if needed */
+   /* Fill the chunk if needed */
    if (zero_data) {
       convert_value_from_double(fillvalue, 
                                 reshape_info->output_datatype,
@@ -787,46 +854,218 @@ static void copy_the_chunk(Reshape_info *reshape_info,
          (void) memcpy((char *)chunk_data + ipix*datatype_size,
                        &value_buffer, datatype_size);
       }
-      (void) ncvarput(reshape_info->outmincid, reshape_info->outimgid,
-                      chunk_start, chunk_count, chunk_data);
    }
 
-   /* Set up hypothetical imap variable for input */
-   for (idim=in_ndims-1; idim >= 0; idim--) {
-      input_imap[idim] = ((idim == in_ndims-1) ? 
-                          datatype_size :
-                          input_imap[idim+1] * input_count[idim+1]);
+   /* Should we really copy the data? */
+   if (really_copy_the_data) {
+
+      /* Read in the data */
+      (void) miicv_get(reshape_info->icvid, input_start, input_count, 
+                       input_data);
+
+      /* Get the strides (in values) of the input data */
+      for (idim=in_ndims-1; idim >= 0; idim--) {
+         input_stride[idim] = ((idim == in_ndims-1) ? 
+                               1 : input_stride[idim+1] * input_count[idim+1]);
+      }
+
+      /* Work out the input stride for each output dimension (re-ordering
+         dimensions and flipping), the offset of the input value for 
+         output [0,0,0...] and where that goes in the chunk */
+      src_offset = 0;
+      dst_offset = 0;
+      for (odim=out_ndims-1; odim >= 0; odim--) {
+         idim = reshape_info->map_out_to_in[odim];
+         dst_stride[odim] = ((odim == out_ndims-1) ? 
+                             1 : dst_stride[odim+1] * chunk_count[odim+1]);
+         if (reshape_info->input_count[idim] > 0) {
+            src_stride[odim] = input_stride[idim];
+         }
+         else {
+            src_stride[odim] = -input_stride[idim];
+            src_offset += (output_count[odim] - 1) * input_stride[idim];
+         }
+         dst_offset += (output_start[odim] - chunk_start[odim]) *
+            dst_stride[odim];
+      }
+
+      transpose_chunk(out_ndims, output_count, src_stride, dst_stride,
+                      datatype_size, 
+                      (char *) input_data + src_offset * datatype_size,
+                      (char *) chunk_data + dst_offset * datatype_size);
    }
 
-   /* Create output imap variable from input one (re-ordering dimensions and
-      flipping). Also work out the chunk origin (point to byte for output
-      [0,0,0...]). */
-   output_origin = chunk_data;
-   for (odim=0; odim < out_ndims; odim++) {
-      idim = reshape_info->map_out_to_in[odim];
-      if (reshape_info->input_count[idim] > 0) {
-         output_imap[odim] = input_imap[idim];
+   /* Write it out */
+   (void) ncvarput(reshape_info->outmincid, reshape_info->outimgid,
+                   chunk_start, chunk_count, chunk_data);
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : transpose_chunk
+@INPUT      : ndims - number of dimensions
+              count - number of values along each dimension
+              src_stride - step (in values) between values in src along
+                 each dimension (negative for flipped dimensions)
+              dst_stride - step (in values) between values in dst
+              datatype_size - size of a value in bytes
+              src - pointer to the first value to copy
+@OUTPUT     : dst - pointer to where the first value goes
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies an n-dimensional array of values between two
+              layouts. The dimensions that are fastest varying in the
+              source and in the destination are copied together in square 
+              tiles so that both the reads and the writes stay in cache.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void transpose_chunk(int ndims, long count[],
+                            long src_stride[], long dst_stride[],
+                            int datatype_size, void *src, void *dst)
+{
+   int idim, nkept, nouter, adim, bdim;
+   int dims[MAX_VAR_DIMS], outer[MAX_VAR_DIMS];
+   long index[MAX_VAR_DIMS];
+   long src_offset, dst_offset;
+
+   /* Ignore dimensions of length one */
+   nkept = 0;
+   for (idim=0; idim < ndims; idim++) {
+      if (count[idim] > 1) dims[nkept++] = idim;
+   }
+   if (nkept == 0) {
+      (void) memcpy(dst, src, datatype_size);
+      return;
+   }
+
+   /* Find the dimensions with the smallest destination and source 
+      strides */
+   adim = bdim = dims[0];
+   for (idim=1; idim < nkept; idim++) {
+      if (ABS(dst_stride[dims[idim]]) < ABS(dst_stride[adim]))
+         adim = dims[idim];
+      if (ABS(src_stride[dims[idim]]) < ABS(src_stride[bdim]))
+         bdim = dims[idim];
+   }
+
+   /* Loop over all of the other dimensions */
+   nouter = 0;
+   for (idim=0; idim < nkept; idim++) {
+      if ((dims[idim] != adim) && (dims[idim] != bdim)) {
+         outer[nouter] = dims[idim];
+         index[nouter] = 0;
+         nouter++;
+      }
+   }
+
+   while (TRUE) {
+      src_offset = 0;
+      dst_offset = 0;
+      for (idim=0; idim < nouter; idim++) {
+         src_offset += index[idim] * src_stride[outer[idim]];
+         dst_offset += index[idim] * dst_stride[outer[idim]];
+      }
+
+      if (adim == bdim) {
+         transpose_plane(datatype_size, 
+                         (char *) src + src_offset * datatype_size,
+                         (char *) dst + dst_offset * datatype_size,
+                         count[adim], src_stride[adim], dst_stride[adim],
+                         1, 0, 0);
       }
       else {
-         output_imap[odim] = -input_imap[idim];
-         output_origin = 
-            (void *) ((char *)output_origin - 
-                      (output_count[odim] - 1) * output_imap[odim]);
+         transpose_plane(datatype_size, 
+                         (char *) src + src_offset * datatype_size,
+                         (char *) dst + dst_offset * datatype_size,
+                         count[adim], src_stride[adim], dst_stride[adim],
+                         count[bdim], src_stride[bdim], dst_stride[bdim]);
+      }
+
+      /* Increment the outer loop */
+      for (idim=nouter-1; idim >= 0; idim--) {
+         index[idim]++;
+         if (index[idim] < count[outer[idim]]) break;
+         index[idim] = 0;
       }
+      if (idim < 0) break;
    }
 
-   /* Should we really copy the data? */
-   if (really_copy_the_data) {
+}
 
-      /* Read in the data */
-      (void) miicv_get(reshape_info->icvid, input_start, input_count, 
-                       chunk_data);
-   
-      /* Write it out */
-      (void) ncvarputg(reshape_info->outmincid, reshape_info->outimgid,
-                       output_start, output_count, NULL, output_imap, 
-                       output_origin);
+/* Copy a tile of values of a given type, with the inner loop along a */
+#define TRANSPOSE_TILE_LOOP(type) \
+   for (ib=b0; ib < b1; ib++) { \
+      type *sp = (type *) src + ib * src_stride_b; \
+      type *dp = (type *) dst + ib * dst_stride_b; \
+      for (ia=a0; ia < a1; ia++) { \
+         dp[ia * dst_stride_a] = sp[ia * src_stride_a]; \
+      } \
+   }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : transpose_plane
+@INPUT      : datatype_size - size of a value in bytes
+              src - pointer to the first value to copy
+              count_a, src_stride_a, dst_stride_a - number of values and 
+                 strides along the fastest varying destination dimension
+              count_b, src_stride_b, dst_stride_b - number of values and
+                 strides along the fastest varying source dimension
+@OUTPUT     : dst - pointer to where the first value goes
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies a plane of values in square tiles. Values are copied
+              as integer or floating point types of their size so that
+              the inner loop can be vectorized by the compiler.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 17, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void transpose_plane(int datatype_size, char *src, char *dst,
+                            long count_a, long src_stride_a, long dst_stride_a,
+                            long count_b, long src_stride_b, long dst_stride_b)
+{
+   long a0, a1, b0, b1, ia, ib, tile;
+
+   /* Rows can be copied in one go */
+   if ((count_b == 1) && (src_stride_a == 1) && (dst_stride_a == 1)) {
+      (void) memcpy(dst, src, count_a * datatype_size);
+      return;
+   }
+
+   tile = ((count_b == 1) ? count_a : TRANSPOSE_TILE);
+   for (b0=0; b0 < count_b; b0 += tile) {
+      b1 = MIN(b0 + tile, count_b);
+      for (a0=0; a0 < count_a; a0 += tile) {
+         a1 = MIN(a0 + tile, count_a);
+         switch (datatype_size) {
+         case 1:
+            TRANSPOSE_TILE_LOOP(unsigned char);
+            break;
+         case 2:
+            TRANSPOSE_TILE_LOOP(unsigned short);
+            break;
+         case 4:
+            TRANSPOSE_TILE_LOOP(unsigned int);
+            break;
+         case 8:
+            TRANSPOSE_TILE_LOOP(uint64_t);
+            break;
+         default:
+            for (ib=b0; ib < b1; ib++) {
+               for (ia=a0; ia < a1; ia++) {
+                  (void) memcpy(dst + (ia * dst_stride_a + ib * dst_stride_b) *
+                                datatype_size,
+                                src + (ia * src_stride_a + ib * src_stride_b) *
+                                datatype_size, datatype_size);
+               }
+            }
+            break;
+         }
+      }
    }
 
 }
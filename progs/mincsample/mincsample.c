@@ -20,6 +20,7 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <math.h>
+#include <limits.h>
 #include <string.h>
 #include <ParseArgv.h>
 #include <time_stamp.h>
@@ -37,9 +38,35 @@
 #define WORLD_NDIMS 3
 #define DEFAULT_INT -1
 
+/* size of the output file buffer and of the column buffer (in bytes) */
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+/* magic string at the start of a binary column output header */
+#define COLUMNS_MAGIC "MNCSMPL1"
+
 /* typedefs */
 typedef enum { SAMPLE_ALL, SAMPLE_RND } Sample_enum;
-typedef enum { OUTPUT_ASCII, OUTPUT_DOUBLE } Output_enum;
+typedef enum { OUTPUT_ASCII, OUTPUT_DOUBLE,
+   OUTPUT_COLUMNS_FLOAT, OUTPUT_COLUMNS_DOUBLE } Output_enum;
+
+/* a set of samples, either all points or a reservoir of random points
+   (one set for each label when stratifying) */
+typedef struct {
+   double   label;
+   long     n_seen;                    /* number of points offered */
+   long     n_samples;                 /* number of points kept */
+   long     n_alloc;
+   long     next;                      /* next point to go in reservoir */
+   double   weight;                    /* for choosing the next point */
+   long    *voxel;                     /* voxel number of each sample */
+   double  *values;                    /* values of each sample */
+   } Sample_Set;
+
+/* a pointer to a sample, for sorting them */
+typedef struct {
+   long     voxel;
+   double  *values;
+   } Sample_Ptr;
 
 typedef struct {
    Sample_enum sample_type;
@@ -51,7 +78,14 @@ typedef struct {
 
    /* sampling */
    int      rand_samples;
-   int      max_samples;
+   long     max_samples;
+   int      stratify;
+   int      n_values;                  /* number of values per sample */
+   int      n_sets;
+   int      last_set;
+   Sample_Set *sets;
+   long     n_sorted;                  /* all samples in voxel order */
+   Sample_Ptr *sorted;
 
    /* output parameters */
    int      sample_mask;
@@ -63,18 +97,28 @@ typedef struct {
    } Loop_Data;
 
 /* function prototypes */
-void     count_points(void *caller_data, long num_voxels, int input_num_buffers,
-                      int input_vector_length, double *input_data[],
-                      int output_num_buffers, int output_vector_length,
-                      double *output_data[], Loop_Info * loop_info);
 void     get_points(void *caller_data, long num_voxels, int input_num_buffers,
                     int input_vector_length, double *input_data[], int output_num_buffers,
                     int output_vector_length, double *output_data[],
                     Loop_Info * loop_info);
+void     mark_points(void *caller_data, long num_voxels, int input_num_buffers,
+                     int input_vector_length, double *input_data[],
+                     int output_num_buffers, int output_vector_length,
+                     double *output_data[], Loop_Info * loop_info);
+Sample_Set *get_sample_set(Loop_Data * md, double label);
+long     get_sample_slot(Loop_Data * md, Sample_Set * set);
+void     get_reservoir_next(Loop_Data * md, Sample_Set * set);
+void     sort_samples(Loop_Data * md);
+int      compare_samples(const void *a, const void *b);
+void     write_row(Loop_Data * md, long voxel, double values[]);
+void     write_columns(Loop_Data * md);
+long     get_voxel_number(Loop_Info * loop_info, long ivox);
+void     get_world_coord(long voxel, double world_coord[]);
 void     write_data(FILE * fp, double value, Output_enum ot);
 void     get_minc_attribute(int mincid, char *varname, char *attname,
                             int maxvals, double vals[]);
 int      get_minc_ndims(int mincid);
+void     get_minc_sizes(int mincid, long sizes[]);
 void     find_minc_spatial_dims(int mincid, int space_to_dim[], int dim_to_space[]);
 void     get_minc_voxel_to_world(int mincid,
                                  double voxel_to_world[WORLD_NDIMS][WORLD_NDIMS + 1]);
@@ -87,6 +131,7 @@ void     transform_coord(double out_coord[],
 int      space_to_dim[WORLD_NDIMS] = { -1, -1, -1 };
 int      dim_to_space[MAX_VAR_DIMS];
 int      file_ndims = 0;
+long     file_sizes[MAX_VAR_DIMS];
 double   voxel_to_world[WORLD_NDIMS][WORLD_NDIMS + 1];
 
 /* Argument variables and table */
@@ -102,7 +147,7 @@ static int rand_seed = DEFAULT_INT;
 static Loop_Data md = {
    SAMPLE_ALL,
    FALSE, 1.0, 0,
-   0, 0,
+   0, 0, FALSE, 0, 0, 0, NULL, 0, NULL,
    FALSE, 0,
    OUTPUT_ASCII, FALSE,
    NULL
@@ -132,6 +177,8 @@ static ArgvInfo argTable[] = {
     "Random seed to use (use to get reproducible runs) Default: use tv_usec"},
    {"-random_samples", ARGV_INT, (char *)1, (char *)&md.rand_samples,
     "take # random samples from the input data"},
+   {"-stratify", ARGV_CONSTANT, (char *)TRUE, (char *)&md.stratify,
+    "take # random samples from each non-zero label of the mask"},
 
    {NULL, ARGV_HELP, (char *)NULL, (char *)NULL,
     "\nOutput Options:"},
@@ -145,6 +192,12 @@ static ArgvInfo argTable[] = {
     "Write out data as ascii strings (default)"},
    {"-double", ARGV_CONSTANT, (char *)OUTPUT_DOUBLE, (char *)&md.output_type,
     "Write out data as double precision floating-point values"},
+   {"-float_columns", ARGV_CONSTANT, (char *)OUTPUT_COLUMNS_FLOAT,
+    (char *)&md.output_type,
+    "Write out a header and single precision floating-point columns"},
+   {"-double_columns", ARGV_CONSTANT, (char *)OUTPUT_COLUMNS_DOUBLE,
+    (char *)&md.output_type,
+    "Write out a header and double precision floating-point columns"},
    {"-coords", ARGV_CONSTANT, (char *)TRUE, (char *)&md.output_coords,
     "Write out world co-ordinates as well as values"},
 
@@ -162,6 +215,8 @@ int main(int argc, char *argv[])
    int      mincid;
    struct timeval timer;
    int      i;
+   int      keep_samples;
+   long     isample;
 
    /* Save time stamp and args */
    arg_string = time_stamp(argc, argv);
@@ -182,6 +237,10 @@ int main(int argc, char *argv[])
          exit(EXIT_FAILURE);
          }
       }
+   if(md.stratify && (md.sample_type != SAMPLE_RND || mask_fname == NULL)){
+      fprintf(stderr, "%s: -stratify needs -random_samples and -mask\n\n", argv[0]);
+      exit(EXIT_FAILURE);
+      }
 
    /* check arguments */
    if(rand_seed != DEFAULT_INT && rand_seed < 0){
@@ -191,6 +250,7 @@ int main(int argc, char *argv[])
 
    /* get infile names */
    n_infiles = argc - 1;
+   md.n_values = n_infiles;
    infiles = (char **)malloc(sizeof(char *) * (n_infiles + 1));   /* + 1 for mask */
    for(i = 0; i < n_infiles; i++){
       infiles[i] = argv[i + 1];
@@ -210,20 +270,27 @@ int main(int argc, char *argv[])
          }
       }
 
-   /* set up and check for voxel_loop outfiles */
+   /* Samples are kept until the end for random sampling (they are only
+      known once all the data has been seen) and for column output */
+   keep_samples = (md.sample_type == SAMPLE_RND ||
+                   md.output_type == OUTPUT_COLUMNS_FLOAT ||
+                   md.output_type == OUTPUT_COLUMNS_DOUBLE);
+
+   /* set up and check for voxel_loop outfiles, the mask of random
+      samples is written in a second pass */
+   n_outfiles = 0;
    if(sample_fname != NULL){
       if(access(sample_fname, F_OK) == 0 && !clobber){
          fprintf(stderr, "%s: %s exists, use -clobber to overwrite\n\n", argv[0],
                  sample_fname);
          exit(EXIT_FAILURE);
          }
-      md.sample_mask = TRUE;
+      md.sample_mask = (md.sample_type == SAMPLE_ALL);
       md.sample_mask_idx = 0;
-      n_outfiles = 1;
       outfiles[0] = sample_fname;
-      }
-   else {
-      n_outfiles = 0;
+      if(md.sample_mask){
+         n_outfiles = 1;
+         }
       }
 
    /* set up data outfile */
@@ -242,10 +309,12 @@ int main(int argc, char *argv[])
          exit(EXIT_FAILURE);
          }
       }
+   setvbuf(md.outFP, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
 
    /* Get some information from the first file for printing co-ordinates */
    mincid = miopen(infiles[0], NC_NOWRITE | 0x8000);
    file_ndims = get_minc_ndims(mincid);
+   get_minc_sizes(mincid, file_sizes);
    find_minc_spatial_dims(mincid, space_to_dim, dim_to_space);
    get_minc_voxel_to_world(mincid, voxel_to_world);
 
@@ -259,19 +328,6 @@ int main(int argc, char *argv[])
    if(md.sample_type == SAMPLE_RND){
       void    *tmp = NULL;             /* for gettimeofday */
 
-      /* get max number of samples */
-      voxel_loop(1, (md.masking) ? &mask_fname : infiles, 0, NULL, NULL,
-                 loop_opts, count_points, (void *)&md);
-      if(verbose){
-         fprintf(stderr, " | Got max # of points: %d\n", md.max_samples);
-         }
-
-      if(md.rand_samples > md.max_samples){
-         fprintf(stderr, "%s: -rand_samples (%d) must be less than max samples (%d)\n\n",
-                 argv[0], md.rand_samples, md.max_samples);
-         exit(EXIT_FAILURE);
-         }
-
       /* initialise random number generator */
       if(rand_seed == DEFAULT_INT){
          gettimeofday(&timer, tmp);
@@ -289,6 +345,46 @@ int main(int argc, char *argv[])
    voxel_loop(n_infiles, infiles, n_outfiles, outfiles, arg_string,
               loop_opts, get_points, (void *)&md);
 
+   if(verbose){
+      fprintf(stderr, " | Got max # of points: %ld\n", md.max_samples);
+      }
+
+   /* write out the samples that were kept */
+   if(keep_samples){
+      if(md.sample_type == SAMPLE_RND && !md.stratify &&
+         md.rand_samples > md.max_samples){
+         fprintf(stderr, "%s: -rand_samples (%d) must be less than max samples (%ld)\n\n",
+                 argv[0], md.rand_samples, md.max_samples);
+         exit(EXIT_FAILURE);
+         }
+      if(md.stratify){
+         for(i = 0; i < md.n_sets; i++){
+            if(md.rand_samples > md.sets[i].n_seen){
+               fprintf(stderr, "%s: -rand_samples (%d) must be less than max samples (%ld) of label %g\n\n",
+                       argv[0], md.rand_samples, md.sets[i].n_seen, md.sets[i].label);
+               exit(EXIT_FAILURE);
+               }
+            }
+         }
+
+      sort_samples(&md);
+      if(md.output_type == OUTPUT_COLUMNS_FLOAT ||
+         md.output_type == OUTPUT_COLUMNS_DOUBLE){
+         write_columns(&md);
+         }
+      else {
+         for(isample = 0; isample < md.n_sorted; isample++){
+            write_row(&md, md.sorted[isample].voxel, md.sorted[isample].values);
+            }
+         }
+
+      /* write out the mask of random samples */
+      if(sample_fname != NULL && md.sample_type == SAMPLE_RND){
+         voxel_loop(1, infiles, 1, outfiles, arg_string,
+                    loop_opts, mark_points, (void *)&md);
+         }
+      }
+
    /* tidy up */
    fclose(md.outFP);
    free_loop_options(loop_opts);
@@ -296,108 +392,63 @@ int main(int argc, char *argv[])
    return (EXIT_SUCCESS);
    }
 
-/* get points from file(s), write out to an input FP */
+/* get points from file(s), write them out or keep them for later */
 void get_points(void *caller_data, long num_voxels, int input_num_buffers,
                 int input_vector_length, double *input_data[], int output_num_buffers,
                 int output_vector_length, double *output_data[], Loop_Info * loop_info)
 {
    Loop_Data *md = (Loop_Data *) caller_data;
-   int      i, idim, ivox;
-   int      n_infiles;
-   int      do_sample;
-   double   mask_value;
-   int      dim_index;
-   long     index[MAX_VAR_DIMS];
-   double   voxel_coord[WORLD_NDIMS];
-   double   world_coord[WORLD_NDIMS];
+   int      i;
+   long     ivox, slot;
+   int      in_mask;
+   double   mask_value, label;
+   Sample_Set *set;
 
    /* shut the compiler up */
+   (void)input_num_buffers;
    (void)output_num_buffers;
    (void)output_vector_length;
 
-   n_infiles = (md->masking) ? input_num_buffers - 1 : input_num_buffers;
-
    /* for each voxel */
    for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++){
 
-      /* nasty way that works for masking or not */
-      mask_value = 0;
-      if(!md->masking ||
-         (md->masking && fabs(input_data[md->mask_idx][ivox] - md->mask_val) < 0.5)){
-
-         /* flag to sample */
-         do_sample = FALSE;
-
-         switch (md->sample_type){
-         case SAMPLE_ALL:
-            do_sample = TRUE;
-            mask_value = 1.0;
-            break;
-
-         case SAMPLE_RND:
-            /* if this voxel 'qualifies', write out data */
-            if(genrand_res53() < ((double)md->rand_samples / md->max_samples)){
-               md->rand_samples--;
-               do_sample = TRUE;
-               mask_value = 1.0;
-               }
-
-            md->max_samples--;
-            break;
-
-         default:
-            fprintf(stderr, "ERROR - Sample type is undefined (%d)\n", md->sample_type);
-            exit(EXIT_FAILURE);
+      /* check the mask (or the label when stratifying) */
+      in_mask = TRUE;
+      label = 0.0;
+      if(md->masking){
+         if(md->stratify){
+            label = rint(input_data[md->mask_idx][ivox]);
+            in_mask = (label != 0.0);
             }
+         else {
+            in_mask = (fabs(input_data[md->mask_idx][ivox] - md->mask_val) < 0.5);
+            }
+         }
 
-         /* now write out the data */
-         if(do_sample){
-
-            /* get and convert voxel to world coordinates */
-            if(md->output_coords){
-               get_info_voxel_index(loop_info, ivox, file_ndims, index);
-               for(idim = 0; idim < WORLD_NDIMS; idim++){
-                  dim_index = space_to_dim[idim];
-                  if(dim_index >= 0){
-                     voxel_coord[idim] = index[dim_index];
-                     }
-                  }
-               transform_coord(world_coord, voxel_to_world, voxel_coord);
-               }
-
-            switch (md->output_type){
-            case OUTPUT_ASCII:
-               if(md->output_coords){
-                  fprintf(md->outFP, "%.20g\t%.20g\t%.20g\t", world_coord[0],
-                          world_coord[1], world_coord[2]);
-                  }
+      mask_value = 0.0;
+      if(in_mask){
+         md->max_samples++;
 
-               for(i = 0; i < n_infiles; i++){
-                  fprintf(md->outFP, "%.20g\t", input_data[i][ivox]);
-                  }
-               fprintf(md->outFP, "\n");
-               break;
-
-            case OUTPUT_DOUBLE:
-               if(md->output_coords){
-                  fwrite(&(world_coord[0]), sizeof(double), 1, md->outFP);
-                  fwrite(&(world_coord[1]), sizeof(double), 1, md->outFP);
-                  fwrite(&(world_coord[2]), sizeof(double), 1, md->outFP);
-                  }
+         /* find where the sample goes, if anywhere */
+         set = get_sample_set(md, label);
+         slot = get_sample_slot(md, set);
+         if(slot >= 0){
+            set->voxel[slot] = (md->output_coords || md->sample_type == SAMPLE_RND) ?
+               get_voxel_number(loop_info, ivox) : 0;
+            for(i = 0; i < md->n_values; i++){
+               set->values[slot * md->n_values + i] = input_data[i][ivox];
+               }
 
-               for(i = 0; i < n_infiles; i++){
-                  fwrite(&(input_data[i][ivox]), sizeof(double), 1, md->outFP);
+            /* write out all points straight away unless they are kept */
+            if(md->sample_type == SAMPLE_ALL){
+               mask_value = 1.0;
+               if(md->output_type == OUTPUT_ASCII ||
+                  md->output_type == OUTPUT_DOUBLE){
+                  write_row(md, set->voxel[slot], &set->values[slot * md->n_values]);
+                  set->n_samples = 0;
                   }
-
-               break;
-
-            default:
-               fprintf(stderr, "ERROR - Output type is undefined (%d)\n",
-                       md->output_type);
-               exit(EXIT_FAILURE);
                }
             }
-
          }
 
       /* output sampling mask */
@@ -408,32 +459,313 @@ void get_points(void *caller_data, long num_voxels, int input_num_buffers,
 
    }
 
-/* count points that are within a mask */
-void count_points(void *caller_data, long num_voxels, int input_num_buffers,
-                  int input_vector_length, double *input_data[],
-                  int output_num_buffers, int output_vector_length,
-                  double *output_data[], Loop_Info * loop_info)
+/* write out a mask of the chosen points, given the sorted samples */
+void mark_points(void *caller_data, long num_voxels, int input_num_buffers,
+                 int input_vector_length, double *input_data[],
+                 int output_num_buffers, int output_vector_length,
+                 double *output_data[], Loop_Info * loop_info)
 {
    Loop_Data *md = (Loop_Data *) caller_data;
-   int      ivox;
+   Sample_Ptr key;
+   long     ivox;
 
    /* shut the compiler up */
    (void)input_num_buffers;
+   (void)input_data;
    (void)output_num_buffers;
    (void)output_vector_length;
-   (void)output_data;
-   (void)loop_info;
 
    for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++){
-      if(md->masking){
-         if(fabs(input_data[0][ivox] - md->mask_val) < 0.5){
-            md->max_samples++;
+      key.voxel = get_voxel_number(loop_info, ivox);
+      output_data[0][ivox] =
+         (bsearch(&key, md->sorted, md->n_sorted, sizeof(Sample_Ptr),
+                  compare_samples) != NULL) ? 1.0 : 0.0;
+      }
+   }
+
+/* get the set of samples for a label, adding a new one if needed */
+Sample_Set *get_sample_set(Loop_Data * md, double label)
+{
+   int      iset;
+   Sample_Set *set;
+
+   /* check the last set used first, labels tend to come in runs */
+   if(md->n_sets > 0 && md->sets[md->last_set].label == label){
+      return &md->sets[md->last_set];
+      }
+   for(iset = 0; iset < md->n_sets; iset++){
+      if(md->sets[iset].label == label){
+         md->last_set = iset;
+         return &md->sets[iset];
+         }
+      }
+
+   md->sets = (Sample_Set *) realloc(md->sets, sizeof(Sample_Set) * (md->n_sets + 1));
+   if(md->sets == NULL){
+      fprintf(stderr, "ERROR - Couldn't allocate memory for label %g\n", label);
+      exit(EXIT_FAILURE);
+      }
+   set = &md->sets[md->n_sets];
+   set->label = label;
+   set->n_seen = 0;
+   set->n_samples = 0;
+   set->n_alloc = 0;
+   set->next = 0;
+   set->weight = 0.0;
+   set->voxel = NULL;
+   set->values = NULL;
+   md->last_set = md->n_sets;
+   md->n_sets++;
+
+   return set;
+   }
+
+/* Offer a point to a set of samples and return the slot to put it in
+   (or -1 if it is not wanted). Random samples are kept in a reservoir
+   using Li's algorithm L: once the reservoir is full, the number of
+   points to skip before the next one goes in is drawn directly, so
+   random numbers are only needed for the points that are kept. */
+long get_sample_slot(Loop_Data * md, Sample_Set * set)
+{
+   long     slot;
+
+   set->n_seen++;
+
+   /* fill the set (or reservoir) */
+   if(md->sample_type == SAMPLE_ALL || set->n_samples < md->rand_samples){
+      if(set->n_samples >= set->n_alloc){
+         /* grow as needed, so small labels get small reservoirs */
+         set->n_alloc = (set->n_alloc > 0) ? 2 * set->n_alloc : 1024;
+         if(md->sample_type == SAMPLE_RND && set->n_alloc > md->rand_samples){
+            set->n_alloc = md->rand_samples;
+            }
+         set->voxel = (long *)realloc(set->voxel, sizeof(long) * set->n_alloc);
+         set->values = (double *)realloc(set->values,
+                                         sizeof(double) * set->n_alloc * md->n_values);
+         if(set->voxel == NULL || set->values == NULL){
+            fprintf(stderr, "ERROR - Couldn't allocate memory for %ld samples\n",
+                    set->n_alloc);
+            exit(EXIT_FAILURE);
             }
          }
-      else {
-         md->max_samples++;
+      slot = set->n_samples;
+      set->n_samples++;
+
+      if(md->sample_type == SAMPLE_RND && set->n_samples == md->rand_samples){
+         set->weight = exp(log(genrand_real3()) / md->rand_samples);
+         get_reservoir_next(md, set);
          }
+      return slot;
       }
+
+   /* replace a random point in the reservoir */
+   if(set->n_seen == set->next){
+      slot = (long)(genrand_res53() * md->rand_samples);
+      set->weight *= exp(log(genrand_real3()) / md->rand_samples);
+      get_reservoir_next(md, set);
+      return slot;
+      }
+
+   return -1;
+   }
+
+/* work out which point goes into a full reservoir next */
+void get_reservoir_next(Loop_Data * md, Sample_Set * set)
+{
+   double   skip;
+
+   (void)md;
+
+   skip = floor(log(genrand_real3()) / log(1.0 - set->weight));
+   if(skip < (double)(LONG_MAX / 2) - set->n_seen){
+      set->next = set->n_seen + (long)skip + 1;
+      }
+   else {
+      set->next = LONG_MAX;
+      }
+   }
+
+/* collect the samples of all sets in voxel order */
+void sort_samples(Loop_Data * md)
+{
+   int      iset;
+   long     isample, n;
+   Sample_Ptr *samples;
+   Sample_Set *set;
+
+   n = 0;
+   for(iset = 0; iset < md->n_sets; iset++){
+      n += md->sets[iset].n_samples;
+      }
+   samples = (Sample_Ptr *) malloc(sizeof(Sample_Ptr) * (n + 1));
+   if(samples == NULL){
+      fprintf(stderr, "ERROR - Couldn't allocate memory for %ld samples\n", n);
+      exit(EXIT_FAILURE);
+      }
+
+   n = 0;
+   for(iset = 0; iset < md->n_sets; iset++){
+      set = &md->sets[iset];
+      for(isample = 0; isample < set->n_samples; isample++){
+         samples[n].voxel = set->voxel[isample];
+         samples[n].values = &set->values[isample * md->n_values];
+         n++;
+         }
+      }
+
+   /* all points are already in order */
+   if(md->sample_type == SAMPLE_RND){
+      qsort(samples, n, sizeof(Sample_Ptr), compare_samples);
+      }
+
+   md->sorted = samples;
+   md->n_sorted = n;
+   }
+
+int compare_samples(const void *a, const void *b)
+{
+   long     va = ((const Sample_Ptr *) a)->voxel;
+   long     vb = ((const Sample_Ptr *) b)->voxel;
+
+   return (va < vb) ? -1 : (va > vb) ? 1 : 0;
+   }
+
+/* write out one sample, with its co-ordinates if wanted */
+void write_row(Loop_Data * md, long voxel, double values[])
+{
+   int      i;
+   double   world_coord[WORLD_NDIMS];
+
+   if(md->output_coords){
+      get_world_coord(voxel, world_coord);
+      }
+
+   switch (md->output_type){
+   case OUTPUT_ASCII:
+      if(md->output_coords){
+         fprintf(md->outFP, "%.20g\t%.20g\t%.20g\t", world_coord[0],
+                 world_coord[1], world_coord[2]);
+         }
+
+      for(i = 0; i < md->n_values; i++){
+         fprintf(md->outFP, "%.20g\t", values[i]);
+         }
+      fprintf(md->outFP, "\n");
+      break;
+
+   case OUTPUT_DOUBLE:
+      if(md->output_coords){
+         fwrite(world_coord, sizeof(double), WORLD_NDIMS, md->outFP);
+         }
+      fwrite(values, sizeof(double), md->n_values, md->outFP);
+      break;
+
+   default:
+      fprintf(stderr, "ERROR - Output type is undefined (%d)\n",
+              md->output_type);
+      exit(EXIT_FAILURE);
+      }
+   }
+
+/* Write out the samples as columns (x, y, z if wanted, then a column for
+   each file) after a header of an 8 character magic string and the
+   number of columns, the size of each value and the number of rows
+   (as ints in native byte order) */
+void write_columns(Loop_Data * md)
+{
+   int      icol, n_coords, value_size;
+   long     isample, ibuf, buf_len, n_samples;
+   int      header[3];
+   double   value, world_coord[WORLD_NDIMS];
+   char    *buffer;
+   Sample_Ptr *samples;
+
+   n_samples = md->n_sorted;
+   samples = md->sorted;
+   if(n_samples > INT_MAX){
+      fprintf(stderr, "ERROR - Too many samples for column output (%ld)\n",
+              n_samples);
+      exit(EXIT_FAILURE);
+      }
+   n_coords = (md->output_coords) ? WORLD_NDIMS : 0;
+   value_size = (md->output_type == OUTPUT_COLUMNS_FLOAT) ? sizeof(float) : sizeof(double);
+
+   /* header */
+   header[0] = n_coords + md->n_values;
+   header[1] = value_size;
+   header[2] = (int)n_samples;
+   fwrite(COLUMNS_MAGIC, 1, strlen(COLUMNS_MAGIC), md->outFP);
+   fwrite(header, sizeof(int), 3, md->outFP);
+
+   /* columns, converted a buffer at a time */
+   buf_len = OUTPUT_BUFFER_SIZE / value_size;
+   buffer = (char *)malloc(OUTPUT_BUFFER_SIZE);
+   if(buffer == NULL){
+      fprintf(stderr, "ERROR - Couldn't allocate the column buffer\n");
+      exit(EXIT_FAILURE);
+      }
+   for(icol = 0; icol < n_coords + md->n_values; icol++){
+      ibuf = 0;
+      for(isample = 0; isample < n_samples; isample++){
+         if(icol < n_coords){
+            get_world_coord(samples[isample].voxel, world_coord);
+            value = world_coord[icol];
+            }
+         else {
+            value = samples[isample].values[icol - n_coords];
+            }
+
+         if(value_size == sizeof(float)){
+            ((float *)buffer)[ibuf] = (float)value;
+            }
+         else {
+            ((double *)buffer)[ibuf] = value;
+            }
+         ibuf++;
+
+         if(ibuf == buf_len || isample == n_samples - 1){
+            fwrite(buffer, value_size, ibuf, md->outFP);
+            ibuf = 0;
+            }
+         }
+      }
+   free(buffer);
+   }
+
+/* get the voxel number (offset into the first file) of a voxel in the loop */
+long get_voxel_number(Loop_Info * loop_info, long ivox)
+{
+   int      idim;
+   long     index[MAX_VAR_DIMS], voxel;
+
+   get_info_voxel_index(loop_info, ivox, file_ndims, index);
+   voxel = 0;
+   for(idim = 0; idim < file_ndims; idim++){
+      voxel = voxel * file_sizes[idim] + index[idim];
+      }
+
+   return voxel;
+   }
+
+/* get the world co-ordinate of a voxel number */
+void get_world_coord(long voxel, double world_coord[])
+{
+   int      idim, dim_index;
+   long     index[MAX_VAR_DIMS];
+   double   voxel_coord[WORLD_NDIMS];
+
+   for(idim = file_ndims - 1; idim >= 0; idim--){
+      index[idim] = voxel % file_sizes[idim];
+      voxel /= file_sizes[idim];
+      }
+   for(idim = 0; idim < WORLD_NDIMS; idim++){
+      voxel_coord[idim] = 0.0;
+      dim_index = space_to_dim[idim];
+      if(dim_index >= 0){
+         voxel_coord[idim] = index[dim_index];
+         }
+      }
+   transform_coord(world_coord, voxel_to_world, voxel_coord);
    }
 
 inline void write_data(FILE * fp, double value, Output_enum ot)
@@ -604,3 +936,16 @@ int get_minc_ndims(int mincid)
 
    return ndims;
    }
+
+/* Get the sizes of the image dimensions of a minc file */
+void get_minc_sizes(int mincid, long sizes[])
+{
+   int      imgid, dim[MAX_VAR_DIMS];
+   int      idim, ndims;
+
+   imgid = ncvarid(mincid, MIimage);
+   (void)ncvarinq(mincid, imgid, NULL, NULL, &ndims, dim, NULL);
+   for(idim = 0; idim < ndims; idim++){
+      (void)ncdiminq(mincid, dim[idim], NULL, &sizes[idim]);
+      }
+   }
@@ -142,6 +142,10 @@
 #define WORLD_NDIMS 3
 #define DEFAULT_VIO_BOOL (-1)
 #define BINS_DEFAULT 2000
+#define QUANTILE_BINS 4096
+#define QUANTILE_MAX_VALUES 1048576
+#define MAX_LABELS 65536
+#define MAX_MASK_BUCKETS 1048576
 
 /* Double_Array structure */
 typedef struct {
@@ -149,6 +153,34 @@ typedef struct {
    double  *values;
 } Double_Array;
 
+/* Quantile histogram: voxel counts and the smallest and largest
+   value seen in each bin over an interval of data values */
+typedef struct {
+   double   range[2];
+   double   scale;
+   double  *counts;
+   double  *bin_min;
+   double  *bin_max;
+} Quantile_Hist;
+
+/* Search for one order statistic. The wanted value lies in the interval
+   hist.range, which is narrowed with a histogram on each pass through
+   the data until the values in it are few enough to be collected. */
+#define QUANTILE_DONE     0
+#define QUANTILE_REFINE   1
+#define QUANTILE_COLLECT  2
+
+typedef struct {
+   int      state;
+   double   rank;               /* rank of the wanted value (from 0) */
+   double   below;              /* number of values below the interval */
+   Quantile_Hist hist;
+   double  *values;
+   long     nvalues;
+   long     nalloc;
+   double   value;
+} Quantile_Info;
+
 /* Stats structure */
 typedef struct {
    double   vol_range[2];
@@ -178,12 +210,27 @@ typedef struct {
    double   biModalT;
    double   pct_T;
    double   entropy;
+   Quantile_Hist qhist;
+   Quantile_Info *quantiles;
+   int      quantiles_pending;
 } Stats_Info;
 
+/* Labels found in a mask file: present[i] is set if label first + i
+   occurs in the mask */
+typedef struct {
+   double   first;
+   long     nlabels;
+   char    *present;
+} Label_Search;
+
 /* Function prototypes */
 void     do_math(void *caller_data, long num_voxels, int input_num_buffers,
                  int input_vector_length, double *input_data[], int output_num_buffers,
                  int output_vector_length, double *output_data[], Loop_Info * loop_info);
+void     do_quantiles(void *caller_data, long num_voxels, int input_num_buffers,
+                      int input_vector_length, double *input_data[],
+                      int output_num_buffers, int output_vector_length,
+                      double *output_data[], Loop_Info * loop_info);
 void     do_stats(double value, long index[], Stats_Info * stats);
 void     print_result(char *title, double result);
 long     get_minc_nvoxels(int mincid);
@@ -204,6 +251,22 @@ void     verify_range_options(Double_Array * min, Double_Array * max,
                               Double_Array * range, Double_Array * binvalue);
 void     init_stats(Stats_Info * stats, int hist_bins);
 void     free_stats(Stats_Info * stats);
+void     get_mask_labels(char *filename, Double_Array * labels);
+void     find_labels(void *caller_data, long num_voxels, int input_num_buffers,
+                     int input_vector_length, double *input_data[],
+                     int output_num_buffers, int output_vector_length,
+                     double *output_data[], Loop_Info * loop_info);
+void     build_mask_lookup(void);
+int      find_masks(double value, int masks[]);
+void     print_label_header(void);
+void     print_label_row(Stats_Info * stats);
+void     init_quantile_hist(Quantile_Hist * hist, double lo, double hi);
+void     add_quantile_value(Quantile_Hist * hist, double value);
+void     locate_quantile(Quantile_Info * quant, Quantile_Hist * hist);
+int      start_quantiles(Stats_Info * stats);
+int      update_quantiles(Stats_Info * stats);
+double   select_value(double values[], long nvalues, long k);
+double   get_quantile(Stats_Info * stats, int iquant);
 
 /* Argument variables */
 int      max_buffer_size_in_kb = 4 * 1024;
@@ -229,6 +292,8 @@ static int Skewness = FALSE;
 static int Kurtosis = FALSE;
 static int CoM = FALSE;
 static int World_Only = FALSE;
+static Double_Array quantile_list = { 0, NULL };
+static int num_quantiles = 0;
 
 static int Hist = FALSE;
 static int Hist_Count = FALSE;
@@ -259,6 +324,15 @@ static Double_Array mask_max = { 0, NULL };
 static Double_Array mask_range = { 0, NULL };
 static Double_Array mask_binvalue = { 0, NULL };
 static int num_masks;
+static int Labels = FALSE;
+
+/* Lookup table from mask values to the mask ranges that may hold them.
+   Bucket i covers values from mask_lookup_range[0] + i up to the next
+   integer and lists the ranges that overlap it. */
+static double mask_lookup_range[2];
+static int *mask_lookup_start = NULL;
+static int *mask_lookup = NULL;
+static int *found_masks = NULL;
 
 char    *hist_file;
 static int hist_bins = BINS_DEFAULT;
@@ -310,6 +384,8 @@ static ArgvInfo argTable[] = {
     "Exclude voxels outside this range (list)"},
    {"-mask_binvalue", ARGV_FUNC, (char *)get_double_list, (char *)&mask_binvalue,
     "Include mask voxels within 0.5 of this value (list)"},
+   {"-labels", ARGV_CONSTANT, (char *)TRUE, (char *)&Labels,
+    "Print a table of stats for each integer label in the mask."},
    {"-ignore_nan", ARGV_CONSTANT, (char *)TRUE, (char *)&ignoreNaN,
     "Exclude NaN values from stats (default)."},
    {"-include_nan", ARGV_CONSTANT, (char *)FALSE, (char *)&ignoreNaN,
@@ -372,6 +448,8 @@ static ArgvInfo argTable[] = {
     "sample skewness (3rd moment)"},
    {"-kurtosis", ARGV_CONSTANT, (char *)TRUE, (char *)&Kurtosis,
     "sample kurtosis (4th moment)"},
+   {"-quantile", ARGV_FUNC, (char *)get_double_list, (char *)&quantile_list,
+    "exact quantiles, as fractions between 0 and 1 (list)"},
 
    {NULL, ARGV_HELP, (char *)NULL, (char *)NULL, "\nHistogram Dependant Statistics:"},
    {"-hist_count", ARGV_CONSTANT, (char *)TRUE, (char *)&Hist_Count,
@@ -734,7 +812,8 @@ int main(int argc, char *argv[])
    Loop_Options *loop_options;
    int      mincid, imgid;
    int      idim;
-   int      irange, imask;
+   int      irange, imask, iquant;
+   int      pending;
    double   real_range[2], valid_range[2];
    nc_type  datatype;
    int      is_signed;
@@ -772,12 +851,33 @@ int main(int argc, char *argv[])
    verify_range_options(&vol_min, &vol_max, &vol_range, &vol_binvalue);
    num_ranges = vol_min.numvalues;
 
+   /* Set up a mask range for each label in the mask file */
+   if(Labels) {
+      if(mask_file == NULL) {
+         (void)fprintf(stderr, "%s: -labels needs a mask file\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      if(mask_min.numvalues > 0 || mask_max.numvalues > 0 ||
+         mask_range.numvalues > 0 || mask_binvalue.numvalues > 0) {
+         (void)fprintf(stderr, "%s: Do not give a mask range with -labels\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      if(access(mask_file, 0) != 0) {
+         (void)fprintf(stderr, "%s: Couldn't find mask file: %s\n", argv[0], mask_file);
+         exit(EXIT_FAILURE);
+      }
+      get_mask_labels(mask_file, &mask_binvalue);
+   }
+
    /* Check mask range options: not over-specified and put values 
       in mask_min/mask_max */
    verify_range_options(&mask_min, &mask_max, &mask_range, &mask_binvalue);
    num_masks = mask_min.numvalues;
+   if(mask_file != NULL) {
+      build_mask_lookup();
+   }
 
-   if (mask_file != NULL && num_masks == 1 && 
+   if (mask_file != NULL && !Labels && num_masks == 1 && 
        *mask_min.values == -DBL_MAX && *mask_max.values == DBL_MAX) {
        fprintf(stderr, 
                "%s: Warning: Mask specified without a range. Mask will be ignored.\n",
@@ -798,13 +898,22 @@ int main(int argc, char *argv[])
       pctT /= 100;
    }
 
+   /* Check the quantiles */
+   num_quantiles = quantile_list.numvalues;
+   for(iquant = 0; iquant < num_quantiles; iquant++) {
+      if(quantile_list.values[iquant] < 0.0 || quantile_list.values[iquant] > 1.0) {
+         (void)fprintf(stderr, "%s: Quantiles must be between 0 and 1\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+   }
+
    /* if nothing selected, do everything */
    if(!Vol_Count && !Vol_Per && !Vol && !Min && !Max && !Sum && !Sum2 &&
       !Mean && !Variance && !Stddev && !Hist_Count && !Hist_Per &&
       !Median && !Majority && !BiModalT && !PctT && !Entropy && !CoM &&
-      !Skewness && !Kurtosis) {
+      !Skewness && !Kurtosis && num_quantiles == 0) {
       All = TRUE;
-      Hist = TRUE;
+      Hist = !Labels;
    }
 
    if((hist_file != NULL) || Hist_Count || Hist_Per ||
@@ -935,6 +1044,13 @@ int main(int argc, char *argv[])
          stats->vol_range[1] = vol_max.values[irange];
          stats->mask_range[0] = mask_min.values[imask];
          stats->mask_range[1] = mask_max.values[imask];
+         if(num_quantiles > 0) {
+            init_quantile_hist(&stats->qhist,
+                               (real_range[0] > stats->vol_range[0]) ?
+                               real_range[0] : stats->vol_range[0],
+                               (real_range[1] < stats->vol_range[1]) ?
+                               real_range[1] : stats->vol_range[1]);
+         }
       }
    }
 
@@ -946,6 +1062,33 @@ int main(int argc, char *argv[])
    voxel_loop(nfiles, infiles, 0, NULL, NULL, loop_options, do_math, NULL);
    free_loop_options(loop_options);
 
+   /* Find the exact quantiles. The first pass left a histogram of the
+      data; re-read the data, looking only at the bins that hold the
+      wanted values, until every value has been found. */
+   if(num_quantiles > 0) {
+      pending = 0;
+      for(irange = 0; irange < num_ranges; irange++) {
+         for(imask = 0; imask < num_masks; imask++) {
+            pending += start_quantiles(&stats_info[irange][imask]);
+         }
+      }
+      while(pending > 0) {
+         loop_options = create_loop_options();
+         set_loop_verbose(loop_options, verbose);
+         set_loop_buffer_size(loop_options, (long)1024 * max_buffer_size_in_kb);
+         voxel_loop(nfiles, infiles, 0, NULL, NULL, loop_options,
+                    do_quantiles, NULL);
+         free_loop_options(loop_options);
+
+         pending = 0;
+         for(irange = 0; irange < num_ranges; irange++) {
+            for(imask = 0; imask < num_masks; imask++) {
+               pending += update_quantiles(&stats_info[irange][imask]);
+            }
+         }
+      }
+   }
+
    /* Open the histogram file if it will be needed */
    if(hist_file == NULL) {
       FP = NULL;
@@ -958,8 +1101,17 @@ int main(int argc, char *argv[])
       }
    }
 
+   if(Labels && !quiet) {
+      print_label_header();
+   }
+
    /* Loop over ranges and masks, calculating results */
    for(irange = 0; irange < num_ranges; irange++) {
+      if(Labels && num_ranges > 1 && !quiet) {
+         (void)fprintf(stdout, "Included Range:    %g   %g\n",
+                       stats_info[irange][0].vol_range[0],
+                       stats_info[irange][0].vol_range[1]);
+      }
       for(imask = 0; imask < num_masks; imask++) {
 
          stats = &stats_info[irange][imask];
@@ -1130,6 +1282,14 @@ int main(int argc, char *argv[])
 
          }                             /* end histogram calculations */
 
+         /* Print one line of the label table for labels that are used */
+         if(Labels) {
+            if(stats->vvoxels > 0) {
+               print_label_row(stats);
+            }
+            continue;
+         }
+
          /* Print range of data allowed */
          if(verbose || (num_ranges > 1 && !quiet)) {
             (void)fprintf(stdout, "Included Range:    %g   %g\n", stats->vol_range[0],
@@ -1222,6 +1382,14 @@ int main(int argc, char *argv[])
                           stats->M4 / (stats->vvoxels * QUAD(sd)));
            }
          }
+         for(iquant = 0; iquant < num_quantiles; iquant++) {
+            char     title[100];
+            char     str[100];
+
+            (void)sprintf(title, "Quantile [%g]:", quantile_list.values[iquant]);
+            (void)sprintf(str, "%-19s", title);
+            print_result(str, get_quantile(stats, iquant));
+         }
 
          if(Hist) {
             if(All && !quiet) {
@@ -1276,6 +1444,12 @@ int main(int argc, char *argv[])
       free(stats_info[irange]);
    }
    free(stats_info);
+   if(found_masks != NULL)
+      free(found_masks);
+   if(mask_lookup_start != NULL) {
+      free(mask_lookup_start);
+      free(mask_lookup);
+   }
 
    return EXIT_SUCCESS;
 }
@@ -1287,53 +1461,94 @@ void do_math(void *caller_data, long num_voxels,
              double *output_data[], Loop_Info * loop_info)
 /* ARGSUSED */
 {
-   long     ivox;
+   long     ivox, nvox;
    long     index[MAX_VAR_DIMS];
-   int      imask, irange;
-   double   mask_min, mask_max;
-   Stats_Info *stats;
-
-   /* Loop through the voxels - a bit of optimization in case we 
-      have a brain-dead compiler */
-   if(mask_file != NULL) {
+   long    *voxel_index;
+   int      irange, ifound, nfound;
+   int      no_mask = 0;
+   int     *masks;
+
+   /* Each voxel is read once and added to the stats of every range
+      and mask that include it */
+   nvox = num_voxels * input_vector_length;
+   voxel_index = (CoM || All) ? index : NULL;
+   masks = &no_mask;
+   nfound = 1;
+   for(ivox = 0; ivox < nvox; ivox++) {
+      if(mask_file != NULL) {
+         masks = found_masks;
+         nfound = find_masks(input_data[1][ivox], masks);
+         if(nfound == 0)
+            continue;
+      }
+      if(voxel_index != NULL) {
+         get_info_voxel_index(loop_info, ivox, file_ndims, voxel_index);
+      }
       for(irange = 0; irange < num_ranges; irange++) {
-         for(imask = 0; imask < num_masks; imask++) {
-            stats = &stats_info[irange][imask];
-            mask_min = stats->mask_range[0];
-            mask_max = stats->mask_range[1];
-            if(CoM || All) {
-               for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++) {
-                  if((input_data[1][ivox] >= mask_min) &&
-                     (input_data[1][ivox] <= mask_max)) {
-                     get_info_voxel_index(loop_info, ivox, file_ndims, index);
-                     do_stats(input_data[0][ivox], index, stats);
-                  }
-               }
-            }
-            else {
-               for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++) {
-                  if((input_data[1][ivox] >= mask_min) &&
-                     (input_data[1][ivox] <= mask_max)) {
-                     do_stats(input_data[0][ivox], NULL, stats);
-                  }
-               }
-            }
+         for(ifound = 0; ifound < nfound; ifound++) {
+            do_stats(input_data[0][ivox], voxel_index,
+                     &stats_info[irange][masks[ifound]]);
          }
       }
    }
 
-   else {
+   return;
+}
+
+/* Voxel loop for the passes that look for the exact quantiles. Voxels
+   are selected as in do_math and do_stats. */
+void do_quantiles(void *caller_data, long num_voxels,
+                  int input_num_buffers, int input_vector_length,
+                  double *input_data[],
+                  int output_num_buffers, int output_vector_length,
+                  double *output_data[], Loop_Info * loop_info)
+/* ARGSUSED */
+{
+   long     ivox, nvox;
+   int      irange, ifound, nfound, iquant;
+   int      no_mask = 0;
+   int     *masks;
+   double   value;
+   Stats_Info *stats;
+   Quantile_Info *quant;
+
+   nvox = num_voxels * input_vector_length;
+   masks = &no_mask;
+   nfound = 1;
+   for(ivox = 0; ivox < nvox; ivox++) {
+      if(mask_file != NULL) {
+         masks = found_masks;
+         nfound = find_masks(input_data[1][ivox], masks);
+         if(nfound == 0)
+            continue;
+      }
+
+      value = input_data[0][ivox];
+      if(value == -DBL_MAX) {
+         if(ignoreNaN)
+            value = fillvalue;
+         else
+            continue;
+      }
+
       for(irange = 0; irange < num_ranges; irange++) {
-         stats = &stats_info[irange][0];
-         if(CoM || All) {
-            for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++) {
-               get_info_voxel_index(loop_info, ivox, file_ndims, index);
-               do_stats(input_data[0][ivox], index, stats);
-            }
-         }
-         else {
-            for(ivox = 0; ivox < num_voxels * input_vector_length; ivox++) {
-               do_stats(input_data[0][ivox], NULL, stats);
+         for(ifound = 0; ifound < nfound; ifound++) {
+            stats = &stats_info[irange][masks[ifound]];
+            if(stats->quantiles_pending <= 0 ||
+               !((value >= stats->vol_range[0]) && (value <= stats->vol_range[1])))
+               continue;
+
+            for(iquant = 0; iquant < 2 * num_quantiles; iquant++) {
+               quant = &stats->quantiles[iquant];
+               if(quant->state == QUANTILE_DONE ||
+                  !((value >= quant->hist.range[0]) && (value <= quant->hist.range[1])))
+                  continue;
+               if(quant->state == QUANTILE_REFINE) {
+                  add_quantile_value(&quant->hist, value);
+               }
+               else if(quant->nvalues < quant->nalloc) {
+                  quant->values[quant->nvalues++] = value;
+               }
             }
          }
       }
@@ -1408,6 +1623,10 @@ void do_stats(double value, long index[], Stats_Info * stats)
          }
       }
 
+      if(num_quantiles > 0) {
+         add_quantile_value(&stats->qhist, value);
+      }
+
       if(Hist && (value >= hist_range[0]) && (value <= hist_range[1]) && 
            (hist_sep > 0.0) ) {
          /*lower limit <= value < upper limit */
@@ -1933,11 +2152,592 @@ void init_stats(Stats_Info * stats, int hist_bins)
    stats->biModalT = 0.0;
    stats->pct_T = 0.0;
    stats->entropy = 0.0;
+   stats->qhist.counts = NULL;
+   stats->qhist.bin_min = NULL;
+   stats->qhist.bin_max = NULL;
+   stats->quantiles = NULL;
+   stats->quantiles_pending = 0;
 }
 
 /* Free things from a Stats_Info structure */
 void free_stats(Stats_Info * stats)
 {
+   int      iquant;
+
    if(stats->histogram != NULL)
       free(stats->histogram);
+   if(stats->qhist.counts != NULL) {
+      free(stats->qhist.counts);
+      free(stats->qhist.bin_min);
+      free(stats->qhist.bin_max);
+   }
+   if(stats->quantiles != NULL) {
+      for(iquant = 0; iquant < 2 * num_quantiles; iquant++) {
+         if(stats->quantiles[iquant].hist.counts != NULL) {
+            free(stats->quantiles[iquant].hist.counts);
+            free(stats->quantiles[iquant].hist.bin_min);
+            free(stats->quantiles[iquant].hist.bin_max);
+         }
+         if(stats->quantiles[iquant].values != NULL)
+            free(stats->quantiles[iquant].values);
+      }
+      free(stats->quantiles);
+   }
+}
+
+/* Set up a quantile histogram over the interval [lo, hi]. Values outside
+   the interval are counted in the end bins. */
+void init_quantile_hist(Quantile_Hist * hist, double lo, double hi)
+{
+   int      ibin;
+   double   width;
+
+   if(hist->counts == NULL) {
+      hist->counts = malloc(QUANTILE_BINS * sizeof(double));
+      hist->bin_min = malloc(QUANTILE_BINS * sizeof(double));
+      hist->bin_max = malloc(QUANTILE_BINS * sizeof(double));
+      if(hist->counts == NULL || hist->bin_min == NULL || hist->bin_max == NULL) {
+         (void)fprintf(stderr, "Memory allocation error\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   if(hi < lo)
+      hi = lo;
+   hist->range[0] = lo;
+   hist->range[1] = hi;
+
+   /* Halve things so that the width cannot overflow */
+   width = hi / 2.0 - lo / 2.0;
+   hist->scale = (width > 0.0) ? (QUANTILE_BINS / 2.0) / width : 0.0;
+
+   for(ibin = 0; ibin < QUANTILE_BINS; ibin++) {
+      hist->counts[ibin] = 0.0;
+      hist->bin_min[ibin] = DBL_MAX;
+      hist->bin_max[ibin] = -DBL_MAX;
+   }
+}
+
+/* Add a value to a quantile histogram. The bin index never decreases as
+   the value increases, so the values in a bin are exactly those between
+   its smallest and largest value. */
+void add_quantile_value(Quantile_Hist * hist, double value)
+{
+   double   position;
+   int      ibin;
+
+   position = (value - hist->range[0]) * hist->scale;
+   if(position >= QUANTILE_BINS)
+      ibin = QUANTILE_BINS - 1;
+   else if(position > 0.0)
+      ibin = (int)position;
+   else
+      ibin = 0;
+
+   hist->counts[ibin]++;
+   if(value < hist->bin_min[ibin])
+      hist->bin_min[ibin] = value;
+   if(value > hist->bin_max[ibin])
+      hist->bin_max[ibin] = value;
+}
+
+/* Find the bin of a quantile histogram that holds the wanted value and
+   decide what to do on the next pass through the data */
+void locate_quantile(Quantile_Info * quant, Quantile_Hist * hist)
+{
+   int      ibin;
+   double   cumulative, count, offset;
+   double   lo, hi;
+
+   cumulative = quant->below;
+   for(ibin = 0; ibin < QUANTILE_BINS - 1; ibin++) {
+      if(cumulative + hist->counts[ibin] > quant->rank)
+         break;
+      cumulative += hist->counts[ibin];
+   }
+   count = hist->counts[ibin];
+   offset = quant->rank - cumulative;
+   lo = hist->bin_min[ibin];
+   hi = hist->bin_max[ibin];
+
+   /* Check whether the value is already known */
+   quant->state = QUANTILE_DONE;
+   if(count <= 0.0) {
+      quant->value = hist->range[1];
+      return;
+   }
+   if(offset <= 0.0 || lo == hi) {
+      quant->value = lo;
+      return;
+   }
+   if(offset >= count - 1.0) {
+      quant->value = hi;
+      return;
+   }
+
+   /* Narrow the interval down to the bin. Collect the values if there
+      are few enough of them or if the histogram did not split the
+      interval at all. */
+   quant->below = cumulative;
+   if(count <= QUANTILE_MAX_VALUES ||
+      (lo == hist->range[0] && hi == hist->range[1])) {
+      quant->state = QUANTILE_COLLECT;
+      quant->hist.range[0] = lo;
+      quant->hist.range[1] = hi;
+      quant->nalloc = (long)count;
+      quant->nvalues = 0;
+      quant->values = malloc(quant->nalloc * sizeof(double));
+      if(quant->values == NULL) {
+         (void)fprintf(stderr, "Memory allocation error\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   else {
+      quant->state = QUANTILE_REFINE;
+      init_quantile_hist(&quant->hist, lo, hi);
+   }
+}
+
+/* Set up the search for the quantiles of a Stats_Info structure from the
+   histogram of the first pass. Each quantile needs the two values whose
+   ranks bracket it. Returns the number of values still to be found. */
+int start_quantiles(Stats_Info * stats)
+{
+   int      iquant;
+   double   position;
+   Quantile_Info *quant;
+
+   stats->quantiles = calloc(2 * num_quantiles, sizeof(*stats->quantiles));
+   if(stats->quantiles == NULL) {
+      (void)fprintf(stderr, "Memory allocation error\n");
+      exit(EXIT_FAILURE);
+   }
+
+   stats->quantiles_pending = 0;
+   for(iquant = 0; iquant < 2 * num_quantiles; iquant++) {
+      quant = &stats->quantiles[iquant];
+      quant->state = QUANTILE_DONE;
+      quant->value = 0.0;
+      if(stats->vvoxels <= 0.0)
+         continue;
+
+      position = (stats->vvoxels - 1) * quantile_list.values[iquant / 2];
+      quant->rank = ((iquant % 2) == 0) ? floor(position) : ceil(position);
+      if(quant->rank > stats->vvoxels - 1)
+         quant->rank = stats->vvoxels - 1;
+      if((iquant % 2) != 0 && quant->rank == stats->quantiles[iquant - 1].rank)
+         continue;
+
+      quant->below = 0.0;
+      locate_quantile(quant, &stats->qhist);
+      if(quant->state != QUANTILE_DONE)
+         stats->quantiles_pending++;
+   }
+
+   return stats->quantiles_pending;
+}
+
+/* Update the quantile search after a pass through the data. Returns the
+   number of values still to be found. */
+int update_quantiles(Stats_Info * stats)
+{
+   int      iquant;
+   long     k;
+   Quantile_Info *quant;
+
+   if(stats->quantiles_pending <= 0)
+      return 0;
+
+   stats->quantiles_pending = 0;
+   for(iquant = 0; iquant < 2 * num_quantiles; iquant++) {
+      quant = &stats->quantiles[iquant];
+      if(quant->state == QUANTILE_REFINE) {
+         locate_quantile(quant, &quant->hist);
+      }
+      else if(quant->state == QUANTILE_COLLECT) {
+         k = (long)(quant->rank - quant->below);
+         if(k >= quant->nvalues)
+            k = quant->nvalues - 1;
+         if(k < 0)
+            quant->value = quant->hist.range[0];
+         else
+            quant->value = select_value(quant->values, quant->nvalues, k);
+         free(quant->values);
+         quant->values = NULL;
+         quant->state = QUANTILE_DONE;
+      }
+      if(quant->state != QUANTILE_DONE)
+         stats->quantiles_pending++;
+   }
+
+   return stats->quantiles_pending;
+}
+
+/* Get a quantile of a Stats_Info structure, interpolating linearly
+   between the values whose ranks bracket it */
+double get_quantile(Stats_Info * stats, int iquant)
+{
+   double   position, frac, value;
+
+   position = (stats->vvoxels - 1) * quantile_list.values[iquant];
+   if(position < 0.0)
+      position = 0.0;
+   frac = position - floor(position);
+   value = stats->quantiles[2 * iquant].value;
+   if(frac > 0.0) {
+      value += frac * (stats->quantiles[2 * iquant + 1].value - value);
+   }
+
+   return value;
+}
+
+/* Return the k'th smallest (from 0) of an array of values, which is
+   partially reordered */
+double select_value(double values[], long nvalues, long k)
+{
+   long     left, right, i, j;
+   double   pivot, temp;
+
+   left = 0;
+   right = nvalues - 1;
+   while(left < right) {
+      pivot = values[left + (right - left) / 2];
+      i = left;
+      j = right;
+      do {
+         while(values[i] < pivot)
+            i++;
+         while(pivot < values[j])
+            j--;
+         if(i <= j) {
+            temp = values[i];
+            values[i] = values[j];
+            values[j] = temp;
+            i++;
+            j--;
+         }
+      } while(i <= j);
+
+      if(k <= j)
+         right = j;
+      else if(k >= i)
+         left = i;
+      else
+         break;
+   }
+
+   return values[k];
+}
+
+/* Get a list of the integer labels that occur in a mask file. The mask
+   is read once up front so that stats (and their histograms) are only
+   set up for labels that are actually used, not for every integer in
+   the mask's range. */
+void get_mask_labels(char *filename, Double_Array * labels)
+{
+   int      mincid;
+   double   real_range[2];
+   double   last;
+   long     ilabel, nfound;
+   Label_Search search;
+   Loop_Options *loop_options;
+
+   mincid = miopen(filename, NC_NOWRITE);
+   (void)miget_image_range(mincid, real_range);
+
+   search.first = floor(real_range[0] + 0.5);
+   last = floor(real_range[1] + 0.5);
+   if(last - search.first + 1.0 > MAX_LABELS) {
+      (void)fprintf(stderr, "Too many labels in mask (%g)\n",
+                    last - search.first + 1.0);
+      exit(EXIT_FAILURE);
+   }
+   search.nlabels = (last >= search.first) ? (long)(last - search.first) + 1 : 0;
+   search.present = calloc(search.nlabels > 0 ? search.nlabels : 1, sizeof(char));
+   if(search.present == NULL) {
+      (void)fprintf(stderr, "Memory allocation error\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Find the labels that occur */
+   if(search.nlabels > 0) {
+      loop_options = create_loop_options();
+      set_loop_first_input_mincid(loop_options, mincid);
+      set_loop_verbose(loop_options, verbose);
+      set_loop_buffer_size(loop_options, (long)1024 * max_buffer_size_in_kb);
+      voxel_loop(1, &filename, 0, NULL, NULL, loop_options, find_labels, &search);
+      free_loop_options(loop_options);
+   }
+   else {
+      (void)miclose(mincid);
+   }
+
+   nfound = 0;
+   for(ilabel = 0; ilabel < search.nlabels; ilabel++) {
+      if(search.present[ilabel])
+         nfound++;
+   }
+
+   labels->numvalues = nfound;
+   labels->values = malloc((nfound > 0 ? nfound : 1) * sizeof(double));
+   if(labels->values == NULL) {
+      (void)fprintf(stderr, "Memory allocation error\n");
+      exit(EXIT_FAILURE);
+   }
+   nfound = 0;
+   for(ilabel = 0; ilabel < search.nlabels; ilabel++) {
+      if(search.present[ilabel])
+         labels->values[nfound++] = search.first + ilabel;
+   }
+
+   free(search.present);
+}
+
+/* Voxel loop for get_mask_labels: mark the labels whose mask range
+   (label - 0.5 to label + 0.5) includes each voxel. A value half way
+   between two labels belongs to both, as in find_masks. */
+void find_labels(void *caller_data, long num_voxels,
+                 int input_num_buffers, int input_vector_length,
+                 double *input_data[],
+                 int output_num_buffers, int output_vector_length,
+                 double *output_data[], Loop_Info * loop_info)
+/* ARGSUSED */
+{
+   Label_Search *search;
+   long     ivox, nvox;
+   double   value, label;
+
+   search = (Label_Search *) caller_data;
+   nvox = num_voxels * input_vector_length;
+   for(ivox = 0; ivox < nvox; ivox++) {
+      value = input_data[0][ivox];
+      if(value == -DBL_MAX)
+         continue;
+      for(label = ceil(value - 0.5); label <= value + 0.5; label += 1.0) {
+         if(label >= search->first && label < search->first + search->nlabels)
+            search->present[(long)(label - search->first)] = TRUE;
+      }
+   }
+
+   return;
+}
+
+/* Build the lookup table from mask values to mask ranges. This is only
+   done when there are several ranges and all of them are finite, so
+   that a voxel is checked against the few ranges that overlap its unit
+   bucket instead of against every range. */
+void build_mask_lookup(void)
+{
+   int      imask;
+   long     ibucket, nbuckets, first, last, total;
+   int     *next;
+   double   lo, hi;
+
+   found_masks = malloc(num_masks * sizeof(*found_masks));
+   if(found_masks == NULL) {
+      (void)fprintf(stderr, "Memory allocation error\n");
+      exit(EXIT_FAILURE);
+   }
+   if(num_masks < 2)
+      return;
+
+   /* Get the span of the ranges and the size of the table */
+   lo = DBL_MAX;
+   hi = -DBL_MAX;
+   total = 0;
+   for(imask = 0; imask < num_masks; imask++) {
+      if(mask_min.values[imask] == -DBL_MAX || mask_max.values[imask] == DBL_MAX)
+         return;
+      if(mask_min.values[imask] > mask_max.values[imask])
+         continue;
+      if(mask_min.values[imask] < lo)
+         lo = mask_min.values[imask];
+      if(mask_max.values[imask] > hi)
+         hi = mask_max.values[imask];
+      if(floor(mask_max.values[imask]) - floor(mask_min.values[imask]) >=
+         MAX_MASK_BUCKETS)
+         return;
+      total += (long)(floor(mask_max.values[imask]) -
+                      floor(mask_min.values[imask])) + 1;
+   }
+   if(lo > hi)
+      return;
+   lo = floor(lo);
+   hi = floor(hi) + 1.0;
+   if(hi - lo > MAX_MASK_BUCKETS || total > MAX_MASK_BUCKETS)
+      return;
+   nbuckets = (long)(hi - lo);
+
+   mask_lookup_range[0] = lo;
+   mask_lookup_range[1] = hi;
+   mask_lookup_start = calloc(nbuckets + 1, sizeof(*mask_lookup_start));
+   mask_lookup = malloc(total * sizeof(*mask_lookup));
+   next = malloc(nbuckets * sizeof(*next));
+   if(mask_lookup_start == NULL || mask_lookup == NULL || next == NULL) {
+      (void)fprintf(stderr, "Memory allocation error\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Count the ranges that overlap each bucket, then list them */
+   for(imask = 0; imask < num_masks; imask++) {
+      if(mask_min.values[imask] > mask_max.values[imask])
+         continue;
+      first = (long)(floor(mask_min.values[imask]) - lo);
+      last = (long)(floor(mask_max.values[imask]) - lo);
+      for(ibucket = first; ibucket <= last; ibucket++)
+         mask_lookup_start[ibucket + 1]++;
+   }
+   for(ibucket = 0; ibucket < nbuckets; ibucket++) {
+      mask_lookup_start[ibucket + 1] += mask_lookup_start[ibucket];
+      next[ibucket] = mask_lookup_start[ibucket];
+   }
+   for(imask = 0; imask < num_masks; imask++) {
+      if(mask_min.values[imask] > mask_max.values[imask])
+         continue;
+      first = (long)(floor(mask_min.values[imask]) - lo);
+      last = (long)(floor(mask_max.values[imask]) - lo);
+      for(ibucket = first; ibucket <= last; ibucket++)
+         mask_lookup[next[ibucket]++] = imask;
+   }
+
+   free(next);
+}
+
+/* Find the mask ranges that include a mask value. Their indices are put
+   in masks and the number found is returned. */
+int find_masks(double value, int masks[])
+{
+   int      imask, ilookup, nfound;
+   long     ibucket;
+
+   nfound = 0;
+   if(mask_lookup_start != NULL) {
+      if(!((value >= mask_lookup_range[0]) && (value < mask_lookup_range[1])))
+         return 0;
+      ibucket = (long)(floor(value) - mask_lookup_range[0]);
+      for(ilookup = mask_lookup_start[ibucket];
+          ilookup < mask_lookup_start[ibucket + 1]; ilookup++) {
+         imask = mask_lookup[ilookup];
+         if((value >= mask_min.values[imask]) && (value <= mask_max.values[imask]))
+            masks[nfound++] = imask;
+      }
+   }
+   else {
+      for(imask = 0; imask < num_masks; imask++) {
+         if((value >= mask_min.values[imask]) && (value <= mask_max.values[imask]))
+            masks[nfound++] = imask;
+      }
+   }
+
+   return nfound;
+}
+
+/* Print the column titles of the label table. The columns follow the
+   order of the normal output. */
+void print_label_header(void)
+{
+   int      iquant;
+
+   (void)fprintf(stdout, "label");
+   if(All || Vol_Count)
+      (void)fprintf(stdout, " count");
+   if(All || Vol_Per)
+      (void)fprintf(stdout, " percent");
+   if(All || Vol)
+      (void)fprintf(stdout, " volume");
+   if(All || Min)
+      (void)fprintf(stdout, " min");
+   if(All || Max)
+      (void)fprintf(stdout, " max");
+   if(All || Sum)
+      (void)fprintf(stdout, " sum");
+   if(All || Sum2)
+      (void)fprintf(stdout, " sum2");
+   if(All || Mean)
+      (void)fprintf(stdout, " mean");
+   if(All || Variance)
+      (void)fprintf(stdout, " variance");
+   if(All || Stddev)
+      (void)fprintf(stdout, " stddev");
+   if(All || CoM)
+      (void)fprintf(stdout, " com_x com_y com_z");
+   if(Skewness)
+      (void)fprintf(stdout, " skewness");
+   if(Kurtosis)
+      (void)fprintf(stdout, " kurtosis");
+   for(iquant = 0; iquant < num_quantiles; iquant++)
+      (void)fprintf(stdout, " q%g", quantile_list.values[iquant]);
+   if(Hist) {
+      if(All || Hist_Count)
+         (void)fprintf(stdout, " hist_count");
+      if(All || Hist_Per)
+         (void)fprintf(stdout, " hist_percent");
+      if(All || Median)
+         (void)fprintf(stdout, " median");
+      if(All || Majority)
+         (void)fprintf(stdout, " majority");
+      if(All || BiModalT)
+         (void)fprintf(stdout, " biModalT");
+      if(All || PctT)
+         (void)fprintf(stdout, " pctT");
+      if(All || Entropy)
+         (void)fprintf(stdout, " entropy");
+   }
+   (void)fprintf(stdout, "\n");
+}
+
+/* Print one line of the label table */
+void print_label_row(Stats_Info * stats)
+{
+   int      iquant;
+   double   sd;
+
+   (void)fprintf(stdout, "%g", (stats->mask_range[0] + stats->mask_range[1]) / 2.0);
+   if(All || Vol_Count)
+      (void)fprintf(stdout, " %.10g", stats->vvoxels);
+   if(All || Vol_Per)
+      (void)fprintf(stdout, " %.10g", stats->vol_per);
+   if(All || Vol)
+      (void)fprintf(stdout, " %.10g", stats->volume);
+   if(All || Min)
+      (void)fprintf(stdout, " %.10g", stats->min);
+   if(All || Max)
+      (void)fprintf(stdout, " %.10g", stats->max);
+   if(All || Sum)
+      (void)fprintf(stdout, " %.10g", stats->sum);
+   if(All || Sum2)
+      (void)fprintf(stdout, " %.10g", stats->sum2);
+   if(All || Mean)
+      (void)fprintf(stdout, " %.10g", stats->mean);
+   if(All || Variance)
+      (void)fprintf(stdout, " %.10g", stats->variance);
+   if(All || Stddev)
+      (void)fprintf(stdout, " %.10g", stats->stddev);
+   if(All || CoM)
+      (void)fprintf(stdout, " %.10g %.10g %.10g", stats->world_com[0],
+                    stats->world_com[1], stats->world_com[2]);
+   sd = sqrt(stats->M2 / stats->vvoxels);
+   if(Skewness)
+      (void)fprintf(stdout, " %.10g", stats->M3 / (stats->vvoxels * CUBE(sd)));
+   if(Kurtosis)
+      (void)fprintf(stdout, " %.10g", stats->M4 / (stats->vvoxels * QUAD(sd)));
+   for(iquant = 0; iquant < num_quantiles; iquant++)
+      (void)fprintf(stdout, " %.10g", get_quantile(stats, iquant));
+   if(Hist) {
+      if(All || Hist_Count)
+         (void)fprintf(stdout, " %.10g", stats->hvoxels);
+      if(All || Hist_Per)
+         (void)fprintf(stdout, " %.10g", stats->hist_per);
+      if(All || Median)
+         (void)fprintf(stdout, " %.10g", stats->median);
+      if(All || Majority)
+         (void)fprintf(stdout, " %.10g", stats->majority);
+      if(All || BiModalT)
+         (void)fprintf(stdout, " %.10g", stats->biModalT);
+      if(All || PctT)
+         (void)fprintf(stdout, " %.10g", stats->pct_T);
+      if(All || Entropy)
+         (void)fprintf(stdout, " %.10g", stats->entropy);
+   }
+   (void)fprintf(stdout, "\n");
 }
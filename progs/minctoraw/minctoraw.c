@@ -8,7 +8,7 @@
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 11, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
  * $Log: minctoraw.c,v $
  * Revision 6.12  2008-01-17 02:33:06  rotor
  *  * removed all rcsids
@@ -108,6 +108,7 @@
 #include <float.h>
 #include <ParseArgv.h>
 #include <minc_endian.h>
+#include <minc_rawcopy.h>
 
 /* Constants */
 #ifndef TRUE
@@ -115,6 +116,7 @@
 #  define FALSE 0
 #endif
 #define VIO_BOOL_DEFAULT -1
+#define DEF_READ_AHEAD 2
 
 /* Variables used for argument parsing */
 static int output_datatype = INT_MAX;
@@ -122,6 +124,7 @@ static int output_signed = INT_MAX;
 static int output_endian = MINC_NATIVE_ENDIAN;
 static double valid_range[2] = {DBL_MAX, DBL_MAX};
 static int normalize_output = VIO_BOOL_DEFAULT;
+static int read_ahead = DEF_READ_AHEAD;
 
 /* Argument table */
 static ArgvInfo argTable[] = {
@@ -151,6 +154,8 @@ static ArgvInfo argTable[] = {
        "Force big-endian output." },
    {"-little-endian", ARGV_CONSTANT, (char *) MINC_LITTLE_ENDIAN, (char *) &output_endian,
        "Force little-endian output." },
+   {"-read_ahead", ARGV_INT, (char *) 1, (char *) &read_ahead,
+       "Number of slabs to read ahead while writing unconverted data."},
    {NULL, ARGV_END, NULL, NULL, NULL}
 };
 
@@ -186,6 +191,20 @@ int main(int argc, char *argv[])
       exit(EXIT_FAILURE);
    }
 
+   /* Check the number of slabs to read ahead */
+   if (read_ahead < 0) {
+      (void) fprintf(stderr, 
+                     "Number of slabs to read ahead must not be negative.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if (read_ahead != DEF_READ_AHEAD && read_ahead > 0) {
+      (void) fprintf(stderr, 
+                     "Warning: no thread support, ignoring -read_ahead.\n");
+   }
+   read_ahead = 0;
+#endif
+
    /* Open the file */
    mincid = miopen(filename, NC_NOWRITE);
 
@@ -223,6 +242,30 @@ int main(int argc, char *argv[])
       valid_range[1] = temp;
    }
 
+   /* Get the size of the file */
+   for (idim=0; idim < ndims; idim++) {
+      (void) ncdiminq(mincid, dims[idim], NULL, &end[idim]);
+   }
+   (void) miset_coords(ndims, (long) 0, start);
+
+   /* Figure out if we have to swap bytes.
+    */
+   swap_fn = minc_get_swap_function(output_endian, nctypelen(output_datatype));
+
+   /* If the stored values would come out unchanged, copy them straight
+      to the output without an icv, in as few reads as possible */
+   if (!normalize_output &&
+       minc_raw_copy_possible(mincid, imgid, output_datatype, output_signed,
+                              valid_range)) {
+      if (minc_raw_copy(mincid, imgid, start, end, swap_fn, stdout, 
+                        read_ahead) != 0) {
+         (void) fprintf(stderr, "Error writing data.\n");
+         exit(EXIT_FAILURE);
+      }
+      (void) miclose(mincid);
+      exit(EXIT_SUCCESS);
+   }
+
    /* Set up image conversion */
    icvid = miicv_create();
    (void) miicv_setint(icvid, MI_ICV_TYPE, output_datatype);
@@ -239,12 +282,8 @@ int main(int argc, char *argv[])
    }
    (void) miicv_attach(icvid, mincid, imgid);
 
-   /* Set input file start, count and end vectors for reading a slice
+   /* Set input file start and count vectors for reading a slice
       at a time */
-   for (idim=0; idim < ndims; idim++) {
-      (void) ncdiminq(mincid, dims[idim], NULL, &end[idim]);
-   }
-   (void) miset_coords(ndims, (long) 0, start);
    (void) miset_coords(ndims, (long) 1, count);
    size = nctypelen(output_datatype);
    for (idim=ndims-2; idim < ndims; idim++) {
@@ -255,10 +294,6 @@ int main(int argc, char *argv[])
    /* Allocate space */
    data = malloc(size);
 
-   /* Figure out if we have to swap bytes.
-    */
-   swap_fn = minc_get_swap_function(output_endian, nctypelen(output_datatype));
-
    /* Loop over input slices */
 
    while (start[0] < end[0]) {
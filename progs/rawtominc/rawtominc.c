@@ -9,7 +9,7 @@
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : September 25, 1992 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
  * $Log: rawtominc.c,v $
  * Revision 6.29  2008-08-13 06:26:29  rotor
  *  * added Claudes (many) 64 bit fixes to dicom code and updates
@@ -186,6 +186,9 @@
 #include <minc.h>
 #include <float.h>
 #include <math.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif /* HAVE_PTHREAD */
 #if HAVE_UNISTD_H
 #define __USE_XOPEN
 #include <unistd.h>
@@ -222,6 +225,7 @@
 #define DEF_DIRCOS DBL_MAX
 #define DEF_ORIGIN DBL_MAX
 #define ARG_SEPARATOR ','
+#define DEF_READ_AHEAD 2
 
 /* LB. needed for volume_def */
 #define VOL_NDIMS    3   /* Number of volume dimensions */
@@ -278,6 +282,32 @@ typedef struct {
    char spacetype[WORLD_NDIMS][MI_MAX_ATTSTR_LEN];
 } Volume_Definition;
 
+/* Images are read (and byte-swapped and scanned for their range) into a
+   ring of buffers by a separate thread while the main thread writes them
+   out, so that at most nbuffers images are ever held in memory. */
+typedef struct {
+   FILE *instream;
+   nc_type datatype;
+   int is_signed;
+   int swap_bytes;
+   int do_minmax;
+   long image_pix;
+   long nimages;             /* Number of images to read */
+   int nbuffers;             /* Number of images in flight */
+   void **buffers;
+   double *minimum;          /* Range of each buffered image */
+   double *maximum;
+   int *status;              /* TRUE if the image was read completely */
+   long nread;               /* Number of images read so far */
+   long nused;               /* Number of images written so far */
+#ifdef HAVE_PTHREAD
+   int threaded;
+   pthread_t thread;
+   pthread_mutex_t mutex;
+   pthread_cond_t cond;
+#endif /* HAVE_PTHREAD */
+} Image_Reader;
+
 /* Function declarations */
 static void parse_args(int argc, char *argv[]);
 static void usage_error(char *pname);
@@ -291,6 +321,21 @@ static void get_file_info(char *filename, int initialized_volume_def,
                           File_Info *file_info);
 static int get_model_file(char *dst, char *key, char *nextArg);
 
+static void start_image_reader(Image_Reader *reader, FILE *instream,
+                               long image_pix, long nimages, int nahead);
+static void *get_next_image(Image_Reader *reader, 
+                            double *imgmin, double *imgmax);
+static void release_image(Image_Reader *reader);
+static void stop_image_reader(Image_Reader *reader);
+static int read_image(Image_Reader *reader, void *image,
+                      double *imgmin, double *imgmax);
+static void scan_image(void *image, long image_pix, nc_type datatype,
+                       int is_signed, int do_swap, int do_minmax,
+                       double *imgmin, double *imgmax);
+#ifdef HAVE_PTHREAD
+static void *image_reader_thread(void *arg);
+#endif /* HAVE_PTHREAD */
+
 /* Array containing information about signs. It is subscripted by
    [signtype][type]. Note that the first row should never be used, since
    default_signs should be used instead. */
@@ -368,6 +413,7 @@ int do_minmax = FALSE;
 double real_range[2] = {DEF_RANGE, DEF_RANGE};
 long skip_length;
 int swap_bytes = FALSE;
+int read_ahead = DEF_READ_AHEAD;
 char *axis_order[MAX_DIMS+1] = { MItime, MIzspace, MIyspace, MIxspace };
 /* LB. */
 static Volume_Definition volume_def;
@@ -479,6 +525,8 @@ ArgvInfo argTable[] = {
        "Option for specifying input raw data file."},
    {"-input", ARGV_STRING, (char *) 1, (char *) &inputfile,
        "Name of input file (default=stdin)."},
+   {"-read_ahead", ARGV_INT, (char *) 1, (char *) &read_ahead,
+       "Number of images to read ahead while writing (0 = none)."},
    {NULL, ARGV_HELP, NULL, NULL,
        "Options for specifying spatial dimension coordinates."},
    {"-xstep", ARGV_FLOAT, (char *) 1, (char *) &dimstep[X],
@@ -554,9 +602,9 @@ int main(int argc, char *argv[])
    long end[MAX_VAR_DIMS];
    int dim[MAX_VAR_DIMS];
    void *image;
-   double imgmax, imgmin, value;
-   long image_size, image_pix, nread, fastdim;
-   int pix_size;
+   double imgmax, imgmin;
+   long image_pix, nimages, nread, fastdim;
+   Image_Reader reader;
    int image_dims;
    int i, j;
    int index;
@@ -564,8 +612,6 @@ int main(int argc, char *argv[])
    char *tm_stamp;
    int iatt;
    long time_start, time_count;
-   int is_signed;
-   void *ptr;
    int floating_type;
    int do_real_range;
    int status;
@@ -860,13 +906,13 @@ int main(int argc, char *argv[])
    /* Attach the icv */
    (void) miicv_attach(icv, cdfid, imgid);
 
-   /* Get a buffer for reading images */
+   /* Count the images */
    image_pix = 1;
    for (i=1; i<=image_dims; i++)
       image_pix *= end[ndims-i];
-   pix_size=nctypelen(datatype);
-   image_size=image_pix*pix_size;
-   image=malloc(image_size);
+   nimages = 1;
+   for (i=0; i<ndims-image_dims; i++)
+      nimages *= end[i];
 
    /* Loop through the images */
    fastdim=ndims-image_dims-1;
@@ -901,142 +947,27 @@ int main(int argc, char *argv[])
       }
    }
 
+   /* Bytes can't be swapped */
+   if (swap_bytes && datatype == NC_BYTE) {
+      (void) fprintf(stderr, 
+         "Warning: you specified -swap_bytes, but I can't swap this type of input\n");
+   }
+
+   /* Start reading images */
+   start_image_reader(&reader, instream, image_pix, nimages, read_ahead);
+
    while (start[0] < end[0]) {
 
-      /* Read in image */
-      nread=fread(image, pix_size, image_pix, instream);
-      if (nread!=image_pix) {
+      /* Get the next image, byte-swapped and with its max and min if
+         needed */
+      image = get_next_image(&reader, &imgmin, &imgmax);
+      if (image == NULL) {
          (void) fprintf(stderr, "%s: Premature end of file.\n", pname);
          exit(ERROR_STATUS);
       }
 
-      /* If the user wants to swap bytes, do it here before any further
-       * processing of the image.
-       */
-      if (swap_bytes) {
-          switch (datatype) {
-          case NC_SHORT:
-              /* Easy case - call swab() */
-              if ((image_size & 1) != 0) {
-                  fprintf(stderr,
-                          "%s: image size must be even for -swap_bytes\n",
-                          pname);
-                  exit(ERROR_STATUS);
-              }
-              else {
-                  swab(image, image, image_size);
-              }
-              break;
-
-          case NC_INT:
-          case NC_FLOAT:
-              /* Harder case - have to do a more complex 4-byte swap. */
-              if ((image_size & 3) != 0) {
-                  fprintf(stderr, 
-                          "%s: image size must be divisible by 4 for -swap_bytes!\n",
-                          pname);
-                  exit(ERROR_STATUS);
-              }
-              else {
-                  unsigned char *img_ptr = image;
-                  unsigned char *img_end = (unsigned char*)image + image_size;
-
-                  for ( ; img_ptr < img_end; img_ptr += 4) {
-                      unsigned char tmp;
-
-                      /* Swap the inner 2 bytes 
-                       */
-                      tmp = img_ptr[1];
-                      img_ptr[1] = img_ptr[2];
-                      img_ptr[2] = tmp;
-
-                      /* Swap the outer 2 bytes 
-                       */
-                      tmp = img_ptr[0];
-                      img_ptr[0] = img_ptr[3];
-                      img_ptr[3] = tmp;
-                  }
-              }
-              break;
-
-          case NC_DOUBLE : 
-              /* Harder case - have to do a more complex 8-byte swap. */
-              if ((image_size & 7) != 0) {
-                  fprintf(stderr, 
-                          "%s: image size must be divisible by 8 for -swap_bytes!\n",
-                          pname);
-                  exit(ERROR_STATUS);
-              } else {
-                  unsigned char *img_ptr = image;
-                  unsigned char *img_end = (unsigned char*)image + image_size;
-
-                  for ( ; img_ptr < img_end; img_ptr += 8) {
-                      unsigned char tmp;
-
-                      /* Swap bytes [0,1,2,3,4,5,6,7] to [7,6,5,4,3,2,1,0] */
-
-                      tmp = img_ptr[3];
-                      img_ptr[3] = img_ptr[4];
-                      img_ptr[4] = tmp;
-
-                      tmp = img_ptr[2];
-                      img_ptr[2] = img_ptr[5];
-                      img_ptr[5] = tmp;
-
-                      tmp = img_ptr[1];
-                      img_ptr[1] = img_ptr[6];
-                      img_ptr[6] = tmp;
-
-                      tmp = img_ptr[0];
-                      img_ptr[0] = img_ptr[7];
-                      img_ptr[7] = tmp;
-                  }
-              }
-              break;
-
-          default:
-              fprintf(stderr, 
-                      "Warning: you specified -swap_bytes, but I can't swap this type of input\n");
-              break;
-          }
-      }
-
-      /* Search for max and min for float and double */
+      /* Keep track of the overall range for float output */
       if (do_minmax) {
-         imgmax=(-DBL_MAX);
-         imgmin=DBL_MAX;
-         is_signed = (signtype == SIGNED);
-         for (j=0; j<image_pix; j++) {
-            ptr = (char *) image + j * nctypelen(datatype);
-            switch (datatype) { 
-            case NC_BYTE : 
-               if (is_signed)
-                  value = (double) *((signed char *) ptr);
-               else
-                  value = (double) *((unsigned char *) ptr);
-               break; 
-            case NC_SHORT : 
-               if (is_signed)
-                  value = (double) *((signed short *) ptr);
-               else
-                  value = (double) *((unsigned short *) ptr);
-               break; 
-            case NC_INT : 
-               if (is_signed)
-                  value = (double) *((signed int *) ptr); 
-               else
-                  value = (double) *((unsigned int *) ptr); 
-               break; 
-            case NC_FLOAT : 
-               value = (double) *((float *) ptr); 
-               break; 
-            case NC_DOUBLE : 
-               value = (double) *((double *) ptr); 
-               break; 
-            } 
-            if (value<imgmin) imgmin=value;
-            if (value>imgmax) imgmax=value;
-         }
          if (do_vrange) {
             if (imgmin<ovalid_range[0]) ovalid_range[0]=imgmin;
             if (imgmax>ovalid_range[1]) ovalid_range[1]=imgmax;
@@ -1066,8 +997,9 @@ int main(int argc, char *argv[])
 	 }
       }
       
-      /* Write the image */
+      /* Write the image and hand its buffer back to the reader */
       (void) miicv_put(icv, start, count, image);
+      release_image(&reader);
 
      /* Increment the counters */
       start[fastdim] += count[fastdim];
@@ -1079,8 +1011,8 @@ int main(int argc, char *argv[])
       }
    }
 
-   /* Free the memory */
-   free(image);
+   /* Stop the reader and free the memory */
+   stop_image_reader(&reader);
 
    /* Write the valid max and min */
    if (do_vrange) {
@@ -1101,6 +1033,361 @@ int main(int argc, char *argv[])
    exit(NORMAL_STATUS);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_image_reader
+@INPUT      : instream - stream from which raw images are read
+              image_pix - number of values in an image
+              nimages - number of images to read
+              nahead - number of images to read ahead of the writer
+@OUTPUT     : reader - the image reader
+@RETURNS    : (nothing)
+@DESCRIPTION: Sets up the buffers for reading images and, if nahead > 0,
+              starts a thread that reads, byte-swaps and scans images
+              into them while the caller writes out earlier images.
+@METHOD     : 
+@GLOBALS    : datatype, signtype, swap_bytes, do_minmax
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_image_reader(Image_Reader *reader, FILE *instream,
+                               long image_pix, long nimages, int nahead)
+{
+   size_t image_size;
+   int ibuf;
+
+   reader->instream = instream;
+   reader->datatype = datatype;
+   reader->is_signed = (signtype == SIGNED);
+   reader->swap_bytes = swap_bytes && (datatype != NC_BYTE);
+   reader->do_minmax = do_minmax;
+   reader->image_pix = image_pix;
+   reader->nimages = nimages;
+   reader->nread = 0;
+   reader->nused = 0;
+
+   /* Never keep more buffers than there are images */
+   reader->nbuffers = nahead + 1;
+   if (reader->nbuffers > nimages) reader->nbuffers = nimages;
+   if (reader->nbuffers < 1) reader->nbuffers = 1;
+
+   /* Get the buffers */
+   image_size = (size_t) image_pix * nctypelen(datatype);
+   reader->buffers = malloc(reader->nbuffers * sizeof(*reader->buffers));
+   reader->minimum = malloc(reader->nbuffers * sizeof(*reader->minimum));
+   reader->maximum = malloc(reader->nbuffers * sizeof(*reader->maximum));
+   reader->status = malloc(reader->nbuffers * sizeof(*reader->status));
+   for (ibuf=0; ibuf < reader->nbuffers; ibuf++) {
+      reader->buffers[ibuf] = malloc(image_size);
+      if (reader->buffers[ibuf] == NULL) {
+         (void) fprintf(stderr, "%s: Unable to allocate image buffer.\n",
+                        pname);
+         exit(ERROR_STATUS);
+      }
+   }
+
+#ifdef HAVE_PTHREAD
+   /* Start the reader thread */
+   reader->threaded = (reader->nbuffers > 1);
+   if (reader->threaded) {
+      (void) pthread_mutex_init(&reader->mutex, NULL);
+      (void) pthread_cond_init(&reader->cond, NULL);
+      if (pthread_create(&reader->thread, NULL, 
+                         image_reader_thread, reader) != 0) {
+         (void) fprintf(stderr, "%s: Unable to create reader thread.\n",
+                        pname);
+         exit(ERROR_STATUS);
+      }
+   }
+#endif /* HAVE_PTHREAD */
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_next_image
+@INPUT      : reader - the image reader
+@OUTPUT     : imgmin - minimum of the image (if the range is scanned)
+              imgmax - maximum of the image (if the range is scanned)
+@RETURNS    : Pointer to the image, or NULL if the input ended early.
+@DESCRIPTION: Gets the next image from the input, waiting for the reader
+              thread if necessary. The image buffer belongs to the
+              caller until release_image is called.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *get_next_image(Image_Reader *reader, 
+                            double *imgmin, double *imgmax)
+{
+   int ibuf, status;
+
+   ibuf = reader->nused % reader->nbuffers;
+
+#ifdef HAVE_PTHREAD
+   if (reader->threaded) {
+      (void) pthread_mutex_lock(&reader->mutex);
+      while (reader->nread <= reader->nused)
+         (void) pthread_cond_wait(&reader->cond, &reader->mutex);
+      status = reader->status[ibuf];
+      (void) pthread_mutex_unlock(&reader->mutex);
+   }
+   else
+#endif /* HAVE_PTHREAD */
+   {
+      status = read_image(reader, reader->buffers[ibuf], 
+                          &reader->minimum[ibuf], &reader->maximum[ibuf]);
+   }
+
+   if (!status) return NULL;
+
+   *imgmin = reader->minimum[ibuf];
+   *imgmax = reader->maximum[ibuf];
+   return reader->buffers[ibuf];
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : release_image
+@INPUT      : reader - the image reader
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Hands the buffer of the last image from get_next_image
+              back to the reader so that it can be refilled.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void release_image(Image_Reader *reader)
+{
+#ifdef HAVE_PTHREAD
+   if (reader->threaded) {
+      (void) pthread_mutex_lock(&reader->mutex);
+      reader->nused++;
+      (void) pthread_cond_broadcast(&reader->cond);
+      (void) pthread_mutex_unlock(&reader->mutex);
+      return;
+   }
+#endif /* HAVE_PTHREAD */
+
+   reader->nused++;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stop_image_reader
+@INPUT      : reader - the image reader
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Waits for the reader thread to finish and frees the image
+              buffers.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void stop_image_reader(Image_Reader *reader)
+{
+   int ibuf;
+
+#ifdef HAVE_PTHREAD
+   if (reader->threaded) {
+      (void) pthread_join(reader->thread, NULL);
+      (void) pthread_cond_destroy(&reader->cond);
+      (void) pthread_mutex_destroy(&reader->mutex);
+   }
+#endif /* HAVE_PTHREAD */
+
+   for (ibuf=0; ibuf < reader->nbuffers; ibuf++)
+      free(reader->buffers[ibuf]);
+   free(reader->buffers);
+   free(reader->minimum);
+   free(reader->maximum);
+   free(reader->status);
+}
+
+#ifdef HAVE_PTHREAD
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : image_reader_thread
+@INPUT      : arg - pointer to the image reader
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Thread that reads all of the images into the ring of
+              buffers, waiting whenever all of the buffers are in use.
+              It stops after the first incomplete image.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *image_reader_thread(void *arg)
+{
+   Image_Reader *reader = arg;
+   long iimage;
+   int ibuf, status;
+
+   for (iimage=0; iimage < reader->nimages; iimage++) {
+
+      /* Wait for a free buffer */
+      (void) pthread_mutex_lock(&reader->mutex);
+      while (iimage - reader->nused >= reader->nbuffers)
+         (void) pthread_cond_wait(&reader->cond, &reader->mutex);
+      (void) pthread_mutex_unlock(&reader->mutex);
+
+      /* Fill it */
+      ibuf = iimage % reader->nbuffers;
+      status = read_image(reader, reader->buffers[ibuf], 
+                          &reader->minimum[ibuf], &reader->maximum[ibuf]);
+
+      /* Pass it on */
+      (void) pthread_mutex_lock(&reader->mutex);
+      reader->status[ibuf] = status;
+      reader->nread = iimage + 1;
+      (void) pthread_cond_broadcast(&reader->cond);
+      (void) pthread_mutex_unlock(&reader->mutex);
+
+      if (!status) break;
+   }
+
+   return NULL;
+}
+#endif /* HAVE_PTHREAD */
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_image
+@INPUT      : reader - the image reader
+@OUTPUT     : image - the image that was read
+              imgmin - minimum of the image (if the range is scanned)
+              imgmax - maximum of the image (if the range is scanned)
+@RETURNS    : TRUE if a whole image was read, FALSE otherwise.
+@DESCRIPTION: Reads one raw image, swapping its bytes and finding its
+              range if needed.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int read_image(Image_Reader *reader, void *image,
+                      double *imgmin, double *imgmax)
+{
+   long nread;
+
+   nread = fread(image, nctypelen(reader->datatype), reader->image_pix, 
+                 reader->instream);
+   if (nread != reader->image_pix) return FALSE;
+
+   scan_image(image, reader->image_pix, reader->datatype, reader->is_signed,
+              reader->swap_bytes, reader->do_minmax, imgmin, imgmax);
+
+   return TRUE;
+}
+
+/* Macros for swapping the bytes of a value in place */
+#define SWAP_BYTE_PAIR(p, i, j) \
+   { unsigned char tmp_ = (p)[i]; (p)[i] = (p)[j]; (p)[j] = tmp_; }
+#define SWAP_2(p) SWAP_BYTE_PAIR(p, 0, 1)
+#define SWAP_4(p) { SWAP_BYTE_PAIR(p, 0, 3); SWAP_BYTE_PAIR(p, 1, 2); }
+#define SWAP_8(p) { SWAP_BYTE_PAIR(p, 0, 7); SWAP_BYTE_PAIR(p, 1, 6); \
+                    SWAP_BYTE_PAIR(p, 2, 5); SWAP_BYTE_PAIR(p, 3, 4); }
+#define SWAP_NONE(p) 
+
+/* Macro to swap and/or scan an image of a given type, with a separate
+   loop for each case so that nothing is decided per pixel */
+#define SCAN_VALUES(ctype, swap_value) \
+   { \
+      ctype *values = (ctype *) image; \
+      if (do_swap && do_minmax) { \
+         for (ipix=0; ipix < image_pix; ipix++) { \
+            swap_value((unsigned char *) &values[ipix]); \
+            value = (double) values[ipix]; \
+            if (value < minimum) minimum = value; \
+            if (value > maximum) maximum = value; \
+         } \
+      } \
+      else if (do_minmax) { \
+         for (ipix=0; ipix < image_pix; ipix++) { \
+            value = (double) values[ipix]; \
+            if (value < minimum) minimum = value; \
+            if (value > maximum) maximum = value; \
+         } \
+      } \
+      else if (do_swap) { \
+         for (ipix=0; ipix < image_pix; ipix++) { \
+            swap_value((unsigned char *) &values[ipix]); \
+         } \
+      } \
+   }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : scan_image
+@INPUT      : image - the raw image
+              image_pix - number of values in the image
+              datatype - type of the values
+              is_signed - TRUE if integer values are signed
+              do_swap - TRUE if the bytes of each value should be swapped
+              do_minmax - TRUE if the range of the image should be found
+@OUTPUT     : image - the image with its bytes swapped
+              imgmin - minimum of the image (if do_minmax)
+              imgmax - maximum of the image (if do_minmax)
+@RETURNS    : (nothing)
+@DESCRIPTION: Swaps the bytes of an image and finds its range in a single
+              pass over the data.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 17, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void scan_image(void *image, long image_pix, nc_type datatype,
+                       int is_signed, int do_swap, int do_minmax,
+                       double *imgmin, double *imgmax)
+{
+   long ipix;
+   double value, minimum, maximum;
+
+   minimum = DBL_MAX;
+   maximum = -DBL_MAX;
+
+   switch (datatype) {
+   case NC_BYTE:
+      if (is_signed)
+         SCAN_VALUES(signed char, SWAP_NONE)
+      else
+         SCAN_VALUES(unsigned char, SWAP_NONE)
+      break;
+   case NC_SHORT:
+      if (is_signed)
+         SCAN_VALUES(signed short, SWAP_2)
+      else
+         SCAN_VALUES(unsigned short, SWAP_2)
+      break;
+   case NC_INT:
+      if (is_signed)
+         SCAN_VALUES(signed int, SWAP_4)
+      else
+         SCAN_VALUES(unsigned int, SWAP_4)
+      break;
+   case NC_FLOAT:
+      SCAN_VALUES(float, SWAP_4)
+      break;
+   case NC_DOUBLE:
+      SCAN_VALUES(double, SWAP_8)
+      break;
+   default:
+      break;
+   }
+
+   if (do_minmax) {
+      *imgmin = minimum;
+      *imgmax = maximum;
+   }
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : parse_args
 @INPUT      : argc        - number of command line arguments
@@ -1226,6 +1513,19 @@ static void parse_args(int argc, char *argv[])
       ovrange_set=TRUE;
    }
 
+   /* Check the number of images to read ahead */
+   if (read_ahead < 0) {
+      (void) fprintf(stderr, "Number of images to read ahead must not be negative.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if (read_ahead != DEF_READ_AHEAD && read_ahead > 0) {
+      (void) fprintf(stderr, 
+                     "Warning: no thread support, ignoring -read_ahead.\n");
+   }
+   read_ahead = 0;
+#endif /* HAVE_PTHREAD */
+
    /* Check that time variables correspond to given dimension size */
    if (strcmp(dimname[0], MItime) == 0) {
       time_size = dimlength[0];
@@ -0,0 +1,452 @@
+/*
+ * grid_resample.c
+ *
+ * Resamples a transform, which may be a concatenation of linear, grid and
+ * inverted grid transforms, onto a single displacement grid so that it
+ * can be applied with one grid lookup per point.
+ *
+ * Inverted grids are not inverted with volume_io's per point search but
+ * by the fixed point iteration y = x - d(y), started from the solution at
+ * the previous point along the row. Neighbouring points have nearly the
+ * same displacement, so this usually converges in a few steps.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <volume_io.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include "grid_resample.h"
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+#define WORLD_NDIMS 3
+#define INVERSE_TOLERANCE 0.001     /* world units */
+#define INVERSE_MAX_ITERATIONS 50
+
+static char *grid_dimorder[] = { MIxspace, MIyspace, MIzspace, MIvector_dimension };
+
+/* one transform of the flattened chain */
+typedef struct {
+   VIO_General_transform *transform;
+   int      invert;                  /* apply the inverse of transform */
+   int      fixed_point;             /* inverted grid, see invert_grid_point */
+   } Chain_Link;
+
+/* warm start for an inverted grid */
+typedef struct {
+   int      have_prev;
+   double   prev_in[WORLD_NDIMS];
+   double   prev_out[WORLD_NDIMS];
+   } Link_State;
+
+/* shared state for filling the grid, one x slice at a time */
+typedef struct {
+   int      nelem[WORLD_NDIMS + 1];
+   double   origin[WORLD_NDIMS];                 /* world coord of voxel 0 */
+   double   vstep[WORLD_NDIMS][WORLD_NDIMS];     /* world step per voxel */
+   double  *values;                              /* grid in storage order */
+   int      next_x;
+   int      ndone;
+   long     nfallback;                           /* points not converged */
+   int      verbose;
+   VIO_progress_struct progress;
+#ifdef HAVE_PTHREAD
+   pthread_mutex_t mutex;
+#endif
+   } Grid_Resample;
+
+/* state for one worker. Grid and user transforms cannot be evaluated by
+   several threads at once, so with more than one worker each flattens
+   and evaluates its own copy of the transform. */
+typedef struct {
+   Grid_Resample *resample;
+   VIO_General_transform transform;              /* copy, if threaded */
+   int      nlinks;
+   Chain_Link *links;
+   } Resample_Worker;
+
+static void add_links(Resample_Worker *worker, VIO_General_transform *transform,
+                      int invert);
+static void *fill_grid_slices(void *arg);
+static void transform_grid_point(Resample_Worker *worker, Link_State *states,
+                                 double in[], double out[], long *nfallback);
+static void apply_link(Chain_Link *link, double in[], double out[]);
+static int invert_grid_point(Chain_Link *link, Link_State *state,
+                             double in[], double out[]);
+
+VIO_Status resample_transform_to_grid(VIO_General_transform *transform,
+                                      char *like_file, int nthreads,
+                                      int verbose,
+                                      VIO_General_transform *grid_transform)
+{
+   VIO_Volume like, grid;
+   Grid_Resample resample;
+   Resample_Worker *workers;
+   int      nworkers;
+   int      sizes[VIO_MAX_DIMENSIONS];
+   double   steps[VIO_MAX_DIMENSIONS], starts[VIO_MAX_DIMENSIONS];
+   double   dircos[WORLD_NDIMS];
+   double   vcoord[WORLD_NDIMS + 1], wcoord[WORLD_NDIMS];
+   double   min, max;
+   long     n, nvalues;
+   int      i, j, t;
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+#endif
+
+   /* get the lattice from the like file */
+   if(input_volume_header_only(like_file, WORLD_NDIMS, XYZ_dimension_names,
+                               &like, NULL) != VIO_OK){
+      return VIO_ERROR;
+      }
+   get_volume_sizes(like, sizes);
+   get_volume_separations(like, steps);
+   get_volume_starts(like, starts);
+   sizes[WORLD_NDIMS] = WORLD_NDIMS;
+   steps[WORLD_NDIMS] = 1.0;
+   starts[WORLD_NDIMS] = 0.0;
+
+   /* create the displacement volume on it */
+   grid = create_volume(WORLD_NDIMS + 1, grid_dimorder, NC_FLOAT, FALSE, 0.0, 0.0);
+   set_volume_sizes(grid, sizes);
+   set_volume_separations(grid, steps);
+   set_volume_starts(grid, starts);
+   for(i = 0; i < WORLD_NDIMS; i++){
+      get_volume_direction_cosine(like, i, dircos);
+      set_volume_direction_cosine(grid, i, dircos);
+      }
+   alloc_volume_data(grid);
+   delete_volume(like);
+
+   /* the voxel to world mapping is linear, so get the world coordinate
+      of the first voxel and the world step along each voxel axis */
+   for(i = 0; i < WORLD_NDIMS + 1; i++){
+      vcoord[i] = 0.0;
+      }
+   convert_voxel_to_world(grid, vcoord, &resample.origin[0],
+                          &resample.origin[1], &resample.origin[2]);
+   for(i = 0; i < WORLD_NDIMS; i++){
+      vcoord[i] = 1.0;
+      convert_voxel_to_world(grid, vcoord, &wcoord[0], &wcoord[1], &wcoord[2]);
+      for(j = 0; j < WORLD_NDIMS; j++){
+         resample.vstep[i][j] = wcoord[j] - resample.origin[j];
+         }
+      vcoord[i] = 0.0;
+      }
+
+   nvalues = 1;
+   for(i = 0; i < WORLD_NDIMS + 1; i++){
+      resample.nelem[i] = sizes[i];
+      nvalues *= sizes[i];
+      }
+   resample.values = malloc(nvalues * sizeof(*resample.values));
+   if(resample.values == NULL){
+      delete_volume(grid);
+      return VIO_ERROR;
+      }
+
+   /* set up the workers, copying the transform for each one here before
+      any threads start, and flatten each transform into a chain */
+#ifdef HAVE_PTHREAD
+   nworkers = (nthreads > 1) ? nthreads : 1;
+#else
+   nworkers = 1;
+#endif
+   workers = malloc(nworkers * sizeof(*workers));
+   if(workers == NULL){
+      delete_volume(grid);
+      free(resample.values);
+      return VIO_ERROR;
+      }
+   for(t = 0; t < nworkers; t++){
+      workers[t].resample = &resample;
+      workers[t].nlinks = 0;
+      workers[t].links = NULL;
+      if(nworkers > 1){
+         copy_general_transform(transform, &workers[t].transform);
+         add_links(&workers[t], &workers[t].transform, FALSE);
+         }
+      else {
+         add_links(&workers[t], transform, FALSE);
+         }
+      }
+
+   /* sample it */
+   resample.next_x = 0;
+   resample.ndone = 0;
+   resample.nfallback = 0;
+   resample.verbose = verbose;
+
+   if(verbose){
+      initialize_progress_report(&resample.progress, FALSE, sizes[0],
+                                 "Resampling transform");
+      }
+#ifdef HAVE_PTHREAD
+   pthread_mutex_init(&resample.mutex, NULL);
+   if(nworkers > 1){
+      threads = malloc(nworkers * sizeof(*threads));
+      for(t = 0; t < nworkers; t++){
+         if(pthread_create(&threads[t], NULL, fill_grid_slices, &workers[t]) != 0){
+            fprintf(stderr, "Unable to create worker thread.\n");
+            exit(EXIT_FAILURE);
+            }
+         }
+      for(t = 0; t < nworkers; t++){
+         pthread_join(threads[t], NULL);
+         }
+      free(threads);
+      }
+   else {
+      fill_grid_slices(&workers[0]);
+      }
+   pthread_mutex_destroy(&resample.mutex);
+#else
+   fill_grid_slices(&workers[0]);
+#endif
+
+   /* free the chains and the copies of the transform */
+   for(t = 0; t < nworkers; t++){
+      free(workers[t].links);
+      if(nworkers > 1){
+         delete_general_transform(&workers[t].transform);
+         }
+      }
+   free(workers);
+   if(verbose){
+      terminate_progress_report(&resample.progress);
+      if(resample.nfallback > 0){
+         fprintf(stdout, " + %ld points inverted by search\n",
+                 resample.nfallback);
+         }
+      }
+
+   /* store the displacements */
+   min = DBL_MAX;
+   max = -DBL_MAX;
+   for(n = 0; n < nvalues; n++){
+      if(resample.values[n] < min){
+         min = resample.values[n];
+         }
+      if(resample.values[n] > max){
+         max = resample.values[n];
+         }
+      }
+   set_volume_real_range(grid, min, max);
+   set_volume_value_hyperslab_4d(grid, 0, 0, 0, 0,
+                                 sizes[0], sizes[1], sizes[2], sizes[3],
+                                 resample.values);
+   free(resample.values);
+
+   create_grid_transform_no_copy(grid_transform, grid, NULL);
+
+   return VIO_OK;
+   }
+
+/* append a transform to the chain, expanding concatenations */
+static void add_links(Resample_Worker *worker, VIO_General_transform *transform,
+                      int invert)
+{
+   Chain_Link *link;
+   int      n, i;
+
+   if(get_transform_type(transform) == CONCATENATED_TRANSFORM){
+
+      /* an inverted concatenation applies the inverses in reverse order */
+      n = get_n_concated_transforms(transform);
+      if(invert != transform->inverse_flag){
+         for(i = n - 1; i >= 0; i--){
+            add_links(worker, get_nth_general_transform(transform, i), TRUE);
+            }
+         }
+      else {
+         for(i = 0; i < n; i++){
+            add_links(worker, get_nth_general_transform(transform, i), FALSE);
+            }
+         }
+      return;
+      }
+
+   worker->links = realloc(worker->links,
+                           (worker->nlinks + 1) * sizeof(*worker->links));
+   link = &worker->links[worker->nlinks++];
+   link->transform = transform;
+   link->invert = invert;
+   link->fixed_point = (get_transform_type(transform) == GRID_TRANSFORM) &&
+      (invert != transform->inverse_flag);
+   }
+
+/* fill x slices of the grid with dx, dy and dz until there are none left */
+static void *fill_grid_slices(void *arg)
+{
+   Resample_Worker *worker = arg;
+   Grid_Resample *resample = worker->resample;
+   Link_State *states;
+   double   wcoord[WORLD_NDIMS], wcoord_t[WORLD_NDIMS];
+   double  *value;
+   long     nfallback;
+   int      x, y, z, v, l;
+
+   states = malloc(worker->nlinks * sizeof(*states));
+   nfallback = 0;
+
+   for(;;){
+
+      /* get the next slice */
+#ifdef HAVE_PTHREAD
+      pthread_mutex_lock(&resample->mutex);
+#endif
+      x = resample->next_x++;
+#ifdef HAVE_PTHREAD
+      pthread_mutex_unlock(&resample->mutex);
+#endif
+      if(x >= resample->nelem[0]){
+         break;
+         }
+
+      value = resample->values +
+         (long)x * resample->nelem[1] * resample->nelem[2] * resample->nelem[3];
+      for(y = 0; y < resample->nelem[1]; y++){
+
+         /* start each row afresh */
+         for(l = 0; l < worker->nlinks; l++){
+            states[l].have_prev = FALSE;
+            }
+
+         for(z = 0; z < resample->nelem[2]; z++){
+            for(v = 0; v < WORLD_NDIMS; v++){
+               wcoord[v] = resample->origin[v] + x * resample->vstep[0][v] +
+                  y * resample->vstep[1][v] + z * resample->vstep[2][v];
+               }
+            transform_grid_point(worker, states, wcoord, wcoord_t, &nfallback);
+            for(v = 0; v < resample->nelem[3]; v++){
+               *value++ = wcoord_t[v] - wcoord[v];
+               }
+            }
+         }
+
+      /* report progress */
+#ifdef HAVE_PTHREAD
+      pthread_mutex_lock(&resample->mutex);
+#endif
+      resample->ndone++;
+      if(resample->verbose){
+         update_progress_report(&resample->progress, resample->ndone);
+         }
+#ifdef HAVE_PTHREAD
+      pthread_mutex_unlock(&resample->mutex);
+#endif
+      }
+
+#ifdef HAVE_PTHREAD
+   pthread_mutex_lock(&resample->mutex);
+#endif
+   resample->nfallback += nfallback;
+#ifdef HAVE_PTHREAD
+   pthread_mutex_unlock(&resample->mutex);
+#endif
+
+   free(states);
+   return NULL;
+   }
+
+/* run a point through the whole chain */
+static void transform_grid_point(Resample_Worker *worker, Link_State *states,
+                                 double in[], double out[], long *nfallback)
+{
+   double   point[WORLD_NDIMS];
+   int      l, v;
+
+   for(v = 0; v < WORLD_NDIMS; v++){
+      point[v] = in[v];
+      }
+   for(l = 0; l < worker->nlinks; l++){
+      if(!worker->links[l].fixed_point){
+         apply_link(&worker->links[l], point, out);
+         }
+      else if(!invert_grid_point(&worker->links[l], &states[l], point, out)){
+         apply_link(&worker->links[l], point, out);
+         (*nfallback)++;
+         }
+      for(v = 0; v < WORLD_NDIMS; v++){
+         point[v] = out[v];
+         }
+      }
+   }
+
+/* apply one transform of the chain with volume_io */
+static void apply_link(Chain_Link *link, double in[], double out[])
+{
+   if(link->invert){
+      general_inverse_transform_point(link->transform, in[0], in[1], in[2],
+                                      &out[0], &out[1], &out[2]);
+      }
+   else {
+      general_transform_point(link->transform, in[0], in[1], in[2],
+                              &out[0], &out[1], &out[2]);
+      }
+   }
+
+/* invert a grid at a point by iterating y = x - d(y), where y + d(y) is
+   the forward grid. Returns FALSE if the iteration does not converge. */
+static int invert_grid_point(Chain_Link *link, Link_State *state,
+                             double in[], double out[])
+{
+   double   fwd[WORLD_NDIMS], err[WORLD_NDIMS];
+   double   max_err;
+   int      iter, v;
+
+   /* start from the previous solution, moved by the step between points */
+   for(v = 0; v < WORLD_NDIMS; v++){
+      out[v] = in[v];
+      if(state->have_prev){
+         out[v] += state->prev_out[v] - state->prev_in[v];
+         }
+      }
+
+   for(iter = 0; iter < INVERSE_MAX_ITERATIONS; iter++){
+
+      /* the forward grid is the stored transform undone by its flag */
+      if(link->transform->inverse_flag){
+         general_inverse_transform_point(link->transform, out[0], out[1], out[2],
+                                         &fwd[0], &fwd[1], &fwd[2]);
+         }
+      else {
+         general_transform_point(link->transform, out[0], out[1], out[2],
+                                 &fwd[0], &fwd[1], &fwd[2]);
+         }
+
+      max_err = 0.0;
+      for(v = 0; v < WORLD_NDIMS; v++){
+         err[v] = in[v] - fwd[v];
+         if(!(fabs(err[v]) <= max_err)){       /* also catches NaN */
+            max_err = fabs(err[v]);
+            }
+         }
+      if(max_err < INVERSE_TOLERANCE){
+         for(v = 0; v < WORLD_NDIMS; v++){
+            state->prev_in[v] = in[v];
+            state->prev_out[v] = out[v];
+            }
+         state->have_prev = TRUE;
+         return TRUE;
+         }
+
+      for(v = 0; v < WORLD_NDIMS; v++){
+         out[v] += err[v];
+         }
+      }
+
+   state->have_prev = FALSE;
+   return FALSE;
+   }
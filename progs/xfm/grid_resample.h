@@ -0,0 +1,20 @@
+/*
+ * grid_resample.h
+ *
+ * Resampling of a (possibly concatenated) transform onto a single
+ * displacement grid
+ */
+
+#ifndef GRID_RESAMPLE_H
+#define GRID_RESAMPLE_H
+
+#include <volume_io.h>
+
+/* Sample a transform on the lattice of a MINC file and return the
+   displacements as a single grid transform. Returns VIO_OK on success. */
+VIO_Status resample_transform_to_grid(VIO_General_transform *transform,
+                                      char *like_file, int nthreads,
+                                      int verbose,
+                                      VIO_General_transform *grid_transform);
+
+#endif /* GRID_RESAMPLE_H */
@@ -11,6 +11,10 @@
  * any purpose. It is provided "as is" without express or implied warranty.
  */
 
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <math.h>
 #include <float.h>
 #include <unistd.h>
@@ -18,17 +22,44 @@
 #include <volume_io.h>
 #include <ParseArgv.h>
 #include <time_stamp.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #define WORLD_NDIMS 3
 #define DEF_BOOL -1
 
 static char *std_dimorder_v[] = { MIxspace, MIyspace, MIzspace, MIvector_dimension };
 
+/* shared state for filling the grid, one x slice at a time */
+typedef struct {
+   int      nelem[WORLD_NDIMS + 1];
+   double   origin[WORLD_NDIMS];                 /* world coord of voxel 0 */
+   double   vstep[WORLD_NDIMS][WORLD_NDIMS];     /* world step per voxel */
+   double  *values;                              /* grid in storage order */
+   int      next_x;
+   int      ndone;
+   progress_struct *progress;
+#ifdef HAVE_PTHREAD
+   pthread_mutex_t mutex;
+#endif
+   } Grid_Info;
+
+/* state for one worker, which evaluates its own copy of the transform
+   since grid and user transforms cannot be shared between threads */
+typedef struct {
+   Grid_Info *grid;
+   VIO_General_transform *xfm;
+   } Grid_Worker;
+
+static void *fill_grid_slices(void *arg);
+
 /* argument variables and table */
 static int verbose = FALSE;
 static int clobber = FALSE;
 static nc_type dtype = NC_SHORT;
 static int is_signed = FALSE;
+static int nthreads = 1;
 static int nelem[WORLD_NDIMS + 1] = { 100, 100, 100, 3 };
 static double start[WORLD_NDIMS] = { -50.0, -50.0, -50.0 };
 static double step[WORLD_NDIMS] = { 1.0, 1.0, 1.0 };
@@ -43,6 +74,8 @@ static ArgvInfo argTable[] = {
     "Print out extra information."},
    {"-clobber", ARGV_CONSTANT, (char *)TRUE, (char *)&clobber,
     "Overwrite existing files."},
+   {"-threads", ARGV_INT, (char *)1, (char *)&nthreads,
+    "Number of threads to use when evaluating the transform."},
 
    {NULL, ARGV_HELP, NULL, NULL, "\nOuput grid Options"},
    {"-byte", ARGV_CONSTANT, (char *)NC_BYTE, (char *)&dtype,
@@ -96,11 +129,17 @@ int main(int argc, char *argv[])
    progress_struct progress;
    Volume   def_grid;
    VIO_General_transform xfm;
-   int      x, y, z, v;
-   double   vcoord[4], wcoord[3], wcoord_t[3];
+   Grid_Info grid;
+   Grid_Worker worker;
+   double   vcoord[4], wcoord[3];
    double   min, max;
-   double   value;
-   int i;
+   long     n, nvalues;
+   int i, j, t;
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+   Grid_Worker *workers;
+   VIO_General_transform *xfm_copies;
+#endif
 
    /* get the history string */
    history = time_stamp(argc, argv);
@@ -114,6 +153,18 @@ int main(int argc, char *argv[])
    xfm_fn = argv[1];
    out_fn = argv[2];
 
+   /* check the number of threads */
+   if(nthreads < 1){
+      fprintf(stderr, "Number of threads must be at least 1.\n");
+      exit(EXIT_FAILURE);
+      }
+#ifndef HAVE_PTHREAD
+   if(nthreads > 1){
+      fprintf(stderr, "Warning: no thread support, ignoring -threads.\n");
+      nthreads = 1;
+      }
+#endif
+
    /* check for infile and outfile */
    if(access(xfm_fn, F_OK) != 0){
       fprintf(stderr, "%s: Couldn't find input xfm %s.\n\n", argv[0], xfm_fn);
@@ -139,50 +190,101 @@ int main(int argc, char *argv[])
       }
    alloc_volume_data(def_grid);
 
-   /* generate the grid itself */
-   min = DBL_MAX;
-   max = -DBL_MAX;
-   vcoord[3] = 0;
+   /* the voxel to world mapping is linear, so get the world coordinate
+      of the first voxel and the world step along each voxel axis */
+   vcoord[0] = vcoord[1] = vcoord[2] = vcoord[3] = 0;
+   convert_voxel_to_world(def_grid, vcoord,
+                          &grid.origin[0], &grid.origin[1], &grid.origin[2]);
+   for(i = 0; i < WORLD_NDIMS; i++){
+      vcoord[i] = 1;
+      convert_voxel_to_world(def_grid, vcoord,
+                             &wcoord[0], &wcoord[1], &wcoord[2]);
+      for(j = 0; j < WORLD_NDIMS; j++){
+         grid.vstep[i][j] = wcoord[j] - grid.origin[j];
+         }
+      vcoord[i] = 0;
+      }
+
+   /* generate the grid itself in storage (x, y, z, vector) order */
+   nvalues = 1;
+   for(i = 0; i < WORLD_NDIMS + 1; i++){
+      grid.nelem[i] = nelem[i];
+      nvalues *= nelem[i];
+      }
+   grid.values = malloc(nvalues * sizeof(*grid.values));
+   if(grid.values == NULL){
+      fprintf(stderr, "%s: Couldn't allocate the grid.\n\n", argv[0]);
+      exit(EXIT_FAILURE);
+      }
+   grid.next_x = 0;
+   grid.ndone = 0;
+   grid.progress = &progress;
+
    initialize_progress_report(&progress, FALSE, nelem[0], "Creating grid");
-   for(x = nelem[0]; x--;){
-      for(y = nelem[1]; y--;){
-         for(z = nelem[2]; z--;){
+#ifdef HAVE_PTHREAD
+   pthread_mutex_init(&grid.mutex, NULL);
+   if(nthreads > 1){
+      threads = malloc(nthreads * sizeof(*threads));
+      workers = malloc(nthreads * sizeof(*workers));
+      xfm_copies = malloc(nthreads * sizeof(*xfm_copies));
+      if(threads == NULL || workers == NULL || xfm_copies == NULL){
+         fprintf(stderr, "%s: Couldn't allocate the worker threads.\n\n", argv[0]);
+         exit(EXIT_FAILURE);
+         }
 
-            /* figure out where we are in world space */
-            vcoord[0] = x;
-            vcoord[1] = y;
-            vcoord[2] = z;
-            convert_voxel_to_world(def_grid,
-                                   vcoord,
-                                   &wcoord[0], &wcoord[1], &wcoord[2]);
-            
-            /* transform that */
-            general_transform_point(&xfm,
-                                    wcoord[0], wcoord[1], wcoord[2],
-                                    &wcoord_t[0], &wcoord_t[1], &wcoord_t[2]);
-            
-            /* write out dx, dy and dz */
-            for(v = nelem[3]; v--;){
-               value = wcoord_t[v] - wcoord[v];
-               if(value < min){
-                  min = value;
-                  }
-               if(value > max){
-                  max = value;
-                  }
-               set_volume_real_value(def_grid, x, y, z, v, 0, value);
-               }
+      /* copy the transform for each worker before any of them start */
+      for(t = 0; t < nthreads; t++){
+         copy_general_transform(&xfm, &xfm_copies[t]);
+         workers[t].grid = &grid;
+         workers[t].xfm = &xfm_copies[t];
+         }
+      for(t = 0; t < nthreads; t++){
+         if(pthread_create(&threads[t], NULL, fill_grid_slices, &workers[t]) != 0){
+            fprintf(stderr, "Unable to create worker thread.\n");
+            exit(EXIT_FAILURE);
             }
          }
-      update_progress_report(&progress, x + 1);
+      for(t = 0; t < nthreads; t++){
+         pthread_join(threads[t], NULL);
+         delete_general_transform(&xfm_copies[t]);
+         }
+      free(xfm_copies);
+      free(workers);
+      free(threads);
+      }
+   else {
+      worker.grid = &grid;
+      worker.xfm = &xfm;
+      fill_grid_slices(&worker);
       }
+   pthread_mutex_destroy(&grid.mutex);
+#else
+   worker.grid = &grid;
+   worker.xfm = &xfm;
+   fill_grid_slices(&worker);
+#endif
    terminate_progress_report(&progress);
 
-   /* set the range */
+   /* get the range and set it before storing any values so that they
+      are scaled properly */
+   min = DBL_MAX;
+   max = -DBL_MAX;
+   for(n = 0; n < nvalues; n++){
+      if(grid.values[n] < min){
+         min = grid.values[n];
+         }
+      if(grid.values[n] > max){
+         max = grid.values[n];
+         }
+      }
    if(verbose){
       fprintf(stdout, " + data range: [%g:%g]\n", min, max);
       }
    set_volume_real_range(def_grid, min, max);
+   set_volume_value_hyperslab_4d(def_grid, 0, 0, 0, 0,
+                                 nelem[0], nelem[1], nelem[2], nelem[3],
+                                 grid.values);
+   free(grid.values);
 
    /* output the result */
    if(verbose){
@@ -199,3 +301,63 @@ int main(int argc, char *argv[])
    
    return (EXIT_SUCCESS);
    }
+
+/* fill x slices of the grid with dx, dy and dz until there are none left */
+static void *fill_grid_slices(void *arg)
+{
+   Grid_Worker *worker = arg;
+   Grid_Info *grid = worker->grid;
+   double   wcoord[3], wcoord_t[3];
+   double  *value;
+   int      x, y, z, v;
+
+   for(;;){
+
+      /* get the next slice */
+#ifdef HAVE_PTHREAD
+      pthread_mutex_lock(&grid->mutex);
+#endif
+      x = grid->next_x++;
+#ifdef HAVE_PTHREAD
+      pthread_mutex_unlock(&grid->mutex);
+#endif
+      if(x >= grid->nelem[0]){
+         break;
+         }
+
+      value = grid->values +
+         (long)x * grid->nelem[1] * grid->nelem[2] * grid->nelem[3];
+      for(y = 0; y < grid->nelem[1]; y++){
+         for(z = 0; z < grid->nelem[2]; z++){
+
+            /* figure out where we are in world space */
+            for(v = 0; v < WORLD_NDIMS; v++){
+               wcoord[v] = grid->origin[v] + x * grid->vstep[0][v] +
+                  y * grid->vstep[1][v] + z * grid->vstep[2][v];
+               }
+
+            /* transform that */
+            general_transform_point(worker->xfm,
+                                    wcoord[0], wcoord[1], wcoord[2],
+                                    &wcoord_t[0], &wcoord_t[1], &wcoord_t[2]);
+
+            /* store dx, dy and dz */
+            for(v = 0; v < grid->nelem[3]; v++){
+               *value++ = wcoord_t[v] - wcoord[v];
+               }
+            }
+         }
+
+      /* report progress */
+#ifdef HAVE_PTHREAD
+      pthread_mutex_lock(&grid->mutex);
+#endif
+      grid->ndone++;
+      update_progress_report(grid->progress, grid->ndone);
+#ifdef HAVE_PTHREAD
+      pthread_mutex_unlock(&grid->mutex);
+#endif
+      }
+
+   return NULL;
+   }
@@ -8,7 +8,7 @@
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : August 13, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
  * $Log: xfmconcat.c,v $
  * Revision 6.7  2008-09-04 03:20:16  rotor
  *  * added -clobber option to xfmconcat and readied for 2.0.16 release
@@ -85,6 +85,7 @@
 #include <volume_io.h>
 #include <ParseArgv.h>
  #include <time_stamp.h>
+#include "grid_resample.h"
 
 /* Constants */
 #ifndef TRUE
@@ -95,6 +96,8 @@
 /* Argument variables */
 int clobber = FALSE;
 int verbose = FALSE;
+char *resample_like = NULL;
+int nthreads = 1;
 
 /* Argument table */
 ArgvInfo argTable[] = {
@@ -104,6 +107,10 @@ ArgvInfo argTable[] = {
        "Don't overwrite existing file (default)."},
    {"-verbose", ARGV_CONSTANT, (char *) TRUE, (char *) &verbose,
        "Print out extra information."},
+   {"-resample_to", ARGV_STRING, (char *) 1, (char *) &resample_like,
+       "Resample the result onto one grid with the sampling of this file."},
+   {"-threads", ARGV_INT, (char *) 1, (char *) &nthreads,
+       "Number of threads to use with -resample_to."},
    
    {NULL, ARGV_HELP, NULL, NULL, ""},
    {NULL, ARGV_END, NULL, NULL, NULL}
@@ -111,7 +118,7 @@ ArgvInfo argTable[] = {
 
 /* Main program */
 int main(int argc, char *argv[]){
-   VIO_General_transform trans1, trans2, trans3;
+   VIO_General_transform trans1, trans2, trans3, grid;
    VIO_General_transform *new_result, *old_result, *input, *temp_result;
    int iarg, first_arg, last_arg;
    char *outfile;
@@ -145,6 +152,18 @@ int main(int argc, char *argv[]){
       fprintf(stderr, "%s: %s exists! (use -clobber to overwrite)\n\n", pname, outfile);
       exit(EXIT_FAILURE);
    }
+
+   /* check the number of threads */
+   if(nthreads < 1){
+      fprintf(stderr, "Number of threads must be at least 1.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if(nthreads > 1){
+      fprintf(stderr, "Warning: no thread support, ignoring -threads.\n");
+      nthreads = 1;
+   }
+#endif
    
    /* Loop through arguments */
    for (iarg=first_arg; iarg <= last_arg; iarg++) {
@@ -171,6 +190,18 @@ int main(int argc, char *argv[]){
 
    }     /* End of loop through arguments */
 
+   /* Resample the result onto a single grid if requested */
+   if (resample_like != NULL) {
+      if (resample_transform_to_grid(new_result, resample_like, nthreads, verbose,
+                                     &grid) != VIO_OK) {
+         (void) fprintf(stderr, "%s: Error resampling onto %s\n",
+                        pname, resample_like);
+         exit(EXIT_FAILURE);
+      }
+      delete_general_transform(new_result);
+      *new_result = grid;
+   }
+
    /* Write out the transform */
    if (output_transform_file(outfile, arg_string, new_result) != VIO_OK) {
       (void) fprintf(stderr, "%s: Error writing transform file %s\n",
@@ -8,7 +8,7 @@
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : August 13, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 17, 2026
  * $Log: xfminvert.c,v $
  * Revision 6.6  2008-01-17 02:33:06  rotor
  *  * removed all rcsids
@@ -82,6 +82,7 @@
 #include <volume_io.h>
 #include <ParseArgv.h>
 #include <time_stamp.h>
+#include "grid_resample.h"
 
 /* Constants */
 #ifndef TRUE
@@ -92,6 +93,8 @@
 /* Argument variables */
 int clobber = FALSE;
 int verbose = FALSE;
+char *resample_like = NULL;
+int nthreads = 1;
 
 
 /* Argument table */
@@ -102,6 +105,10 @@ ArgvInfo argTable[] = {
        "Don't overwrite existing file (default)."},
    {"-verbose", ARGV_CONSTANT, (char *) TRUE, (char *) &verbose,
        "Print out extra information."},
+   {"-resample_to", ARGV_STRING, (char *) 1, (char *) &resample_like,
+       "Resample the result onto one grid with the sampling of this file."},
+   {"-threads", ARGV_INT, (char *) 1, (char *) &nthreads,
+       "Number of threads to use with -resample_to."},
    
    {NULL, ARGV_HELP, NULL, NULL, ""},
    {NULL, ARGV_END, NULL, NULL, NULL}
@@ -109,7 +116,7 @@ ArgvInfo argTable[] = {
 
 /* Main program */
 int main(int argc, char *argv[]){
-   VIO_General_transform transform, inverse;
+   VIO_General_transform transform, inverse, grid;
    char *arg_string;
    char *pname;
    char    *infile;
@@ -141,6 +148,18 @@ int main(int argc, char *argv[]){
       fprintf(stderr, "%s: %s exists! (use -clobber to overwrite)\n\n", pname, outfile);
       exit(EXIT_FAILURE);
    }
+
+   /* check the number of threads */
+   if(nthreads < 1){
+      fprintf(stderr, "Number of threads must be at least 1.\n");
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   if(nthreads > 1){
+      fprintf(stderr, "Warning: no thread support, ignoring -threads.\n");
+      nthreads = 1;
+   }
+#endif
    
    /* Read in file to invert */
    if (input_transform_file(infile, &transform) != VIO_OK) {
@@ -155,6 +174,18 @@ int main(int argc, char *argv[]){
       (void) fprintf(stdout, "[%s]: Inverted %s\n", pname, infile);
    }
    
+   /* Resample the result onto a single grid if requested */
+   if (resample_like != NULL) {
+      if (resample_transform_to_grid(&inverse, resample_like, nthreads, verbose,
+                                     &grid) != VIO_OK) {
+         (void) fprintf(stderr, "%s: Error resampling onto %s\n",
+                        pname, resample_like);
+         exit(EXIT_FAILURE);
+      }
+      delete_general_transform(&inverse);
+      inverse = grid;
+   }
+
    /* Write out the transform */
    if (output_transform_file(outfile, arg_string, &inverse) != VIO_OK) {
       (void) fprintf(stderr, "%s: Error writing transform file %s\n",